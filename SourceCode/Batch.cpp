@@ -0,0 +1,229 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Batch.cpp
+ *
+ * @brief Implementation of batch manifests and the batch scheduler.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "Batch.hpp"
+#include "PLYWriter.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+
+/***
+ * @brief Parse a comma-separated list of floats.
+ * @return bool True if every item is a float and there is at least one
+*/
+static bool parseFloats(const std::string& text, std::vector<float>& values) {
+    values.clear();
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        char* end = nullptr;
+        float value = strtof(item.c_str(), &end);
+        if (item.empty() || *end != '\0') return false;
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+
+bool parseBatchJob(const std::string& line, BatchJob& job, std::string& error) {
+    job = BatchJob();
+    bool hasBox = false;
+    bool hasStep = false;
+    std::istringstream words(line);
+    std::string word;
+    while (words >> word) {
+        size_t equals = word.find('=');
+        if (equals == std::string::npos) {
+            error = "expected key=value, found '" + word + "'";
+            return false;
+        }
+        std::string key = word.substr(0, equals);
+        std::string value = word.substr(equals + 1);
+        std::vector<float> values;
+
+        if (key == "field") job.fieldId = value;
+        else if (key == "out") job.output = value;
+        else if (key == "engine") {
+            if (!parseExtractionEngine(value, job.engine)) {
+                error = "unknown engine '" + value + "'";
+                return false;
+            }
+        }
+        else if (key == "iso") {
+            if (!parseFloats(value, job.isovalues)) {
+                error = "expected iso=value[,value...]";
+                return false;
+            }
+        }
+        else if (key == "step") {
+            if (!parseFloats(value, values) || values.size() != 1 || !(values[0] > 0.0f)) {
+                error = "expected a positive step=value";
+                return false;
+            }
+            job.grid.stepsize = values[0];
+            hasStep = true;
+        }
+        else if (key == "box") {
+            if (!parseFloats(value, values) || (values.size() != 2 && values.size() != 6)) {
+                error = "expected box=min,max or box=minx,maxx,miny,maxy,minz,maxz";
+                return false;
+            }
+            if (values.size() == 2) values = {values[0], values[1], values[0], values[1], values[0], values[1]};
+            job.grid.minx = values[0];
+            job.grid.maxx = values[1];
+            job.grid.miny = values[2];
+            job.grid.maxy = values[3];
+            job.grid.minz = values[4];
+            job.grid.maxz = values[5];
+            hasBox = true;
+        }
+        else {
+            error = "unknown key '" + key + "'";
+            return false;
+        }
+    }
+
+    if (findField(job.fieldId) == nullptr) error = "unknown or missing field '" + job.fieldId + "'";
+    else if (!hasBox) error = "missing box=";
+    else if (!hasStep) error = "missing step=";
+    else if (job.isovalues.empty()) error = "missing iso=";
+    else return true;
+    return false;
+}
+
+
+bool readBatchManifest(const std::string& path, std::vector<BatchJob>& jobs) {
+    std::ifstream manifest(path);
+    if (!manifest.is_open()) {
+        fprintf(stderr, "Failed to open batch manifest %s\n", path.c_str());
+        return false;
+    }
+
+    jobs.clear();
+    bool valid = true;
+    std::string line;
+    for (size_t number = 1; std::getline(manifest, line); ++number) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        BatchJob job;
+        std::string error;
+        if (!parseBatchJob(line, job, error)) {
+            fprintf(stderr, "%s:%zu: %s\n", path.c_str(), number, error.c_str());
+            valid = false;
+            continue;
+        }
+        job.line = number;
+        jobs.push_back(job);
+    }
+    return valid;
+}
+
+
+std::string batchOutputPath(const BatchJob& job, size_t index) {
+    if (job.output.empty() || job.isovalues.size() < 2) return job.output;
+    size_t slash = job.output.find_last_of('/');
+    size_t dot = job.output.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = job.output.size();
+    return job.output.substr(0, dot) + "_" + std::to_string(index) + job.output.substr(dot);
+}
+
+
+/***
+ * @brief Cells of a grid, the estimated cost of extracting it.
+*/
+static double gridCells(const Grid& grid) {
+    auto cells = [&](float min, float max) { return std::max(1.0, std::floor((max - min) / grid.stepsize) + 1.0); };
+    return cells(grid.minx, grid.maxx) * cells(grid.miny, grid.maxy) * cells(grid.minz, grid.maxz);
+}
+
+
+std::vector<BatchRecord> runBatch(const std::vector<BatchJob>& jobs, const BatchOptions& options) {
+    TRACE_SCOPE("batch");
+    std::vector<BatchRecord> records;
+    std::vector<double> costs;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        for (size_t n = 0; n < jobs[j].isovalues.size(); ++n) {
+            BatchRecord record;
+            record.job = j;
+            record.isovalue = jobs[j].isovalues[n];
+            record.output = batchOutputPath(jobs[j], n);
+            records.push_back(record);
+            costs.push_back(gridCells(jobs[j].grid));
+        }
+    }
+
+    // Largest first, so the last tasks to start are small and the ones still running get the idle workers
+    std::vector<size_t> order(records.size());
+    for (size_t t = 0; t < order.size(); ++t) order[t] = t;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+
+    auto start = std::chrono::steady_clock::now();
+    auto since = [&](std::chrono::steady_clock::time_point from) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - from).count();
+    };
+
+    ThreadPool::shared().parallelFor(order.size(), [&](size_t t) {
+        BatchRecord& record = records[order[t]];
+        const BatchJob& job = jobs[record.job];
+        TRACE_SCOPE("batch_task");
+        record.startSeconds = since(start);
+
+        scalar_field_3d f = findField(job.fieldId);
+        if (f == nullptr) {
+            fprintf(stderr, "Batch job on line %zu: unknown field %s\n", job.line, job.fieldId.c_str());
+            return;
+        }
+
+        auto extractStart = std::chrono::steady_clock::now();
+        ExtractionOptions extraction = options.extraction;
+        extraction.engine = job.engine;
+        Mesh mesh = IsoSurfaceExtractor(f, job.fieldId, job.grid, extraction).extract(record.isovalue);
+        record.extractSeconds = since(extractStart);
+        record.triangles = mesh.triangleCount();
+        record.area = mesh.stats.area;
+        record.volume = mesh.stats.volume;
+
+        auto writeStart = std::chrono::steady_clock::now();
+        record.ok = record.output.empty() || writePLY(mesh.vertices, mesh.normals, record.output, PLY_DEFAULT_PRECISION, &mesh.stats);
+        record.writeSeconds = since(writeStart);
+    }, options.concurrentTasks);
+
+    return records;
+}
+
+
+bool writeBatchReport(const std::vector<BatchRecord>& records, const std::string& path) {
+    FILE* report = fopen(path.c_str(), "w");
+    if (report == NULL) {
+        fprintf(stderr, "Failed to open batch report %s\n", path.c_str());
+        return false;
+    }
+    fprintf(report, "job,isovalue,output,ok,triangles,area,volume,start_s,extract_s,write_s\n");
+    for (const BatchRecord& record : records) {
+        fprintf(report, "%zu,%.9g,%s,%d,%zu,%.9g,%.9g,%.6f,%.6f,%.6f\n", record.job, record.isovalue, record.output.c_str(),
+                record.ok ? 1 : 0, record.triangles, record.area, record.volume, record.startSeconds, record.extractSeconds, record.writeSeconds);
+    }
+    return fclose(report) == 0;
+}
@@ -0,0 +1,121 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Batch.hpp
+ *
+ * @brief Many extractions from one manifest, scheduled together.
+ * A manifest lists one job per line: a field, a box, a step size, one or
+ * more isovalues and the PLY file to write. Every isovalue of every job is
+ * a task; the tasks run several at once on the shared thread pool, largest
+ * first, and each task's extraction is itself split over the pool. A worker
+ * that runs out of tasks joins the slabs of the extractions still running,
+ * so the small jobs fill the gaps around the big ones and the tail of the
+ * batch keeps every core busy.
+ *
+ * Manifest line (key=value words in any order; blank lines and lines
+ * starting with # are skipped):
+ *
+ * field=f4 box=-5,5 step=0.05 iso=0,0.5 out=torus.ply [engine=surface-nets]
+ *
+ * box takes min,max (a cube, like the command line) or
+ * minx,maxx,miny,maxy,minz,maxz. A job with several isovalues writes one
+ * file per isovalue, numbered before the extension (torus_0.ply,
+ * torus_1.ply); a job without out= is extracted but not written.
+ */
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "IsoSurfaceExtractor.hpp"
+#include "MarchingCubes.hpp"
+
+/***
+ * BatchJob: one line of a manifest
+*/
+struct BatchJob {
+    std::string fieldId;                                       // A built-in field name, see findField
+    Grid grid;
+    std::vector<float> isovalues;
+    std::string output;                                        // PLY file, empty to skip writing
+    ExtractionEngine engine = ExtractionEngine::MarchingCubes;
+    size_t line = 0;                                           // Line of the manifest, for messages
+};
+
+/***
+ * BatchRecord: the outcome and timing of one isovalue of one job
+*/
+struct BatchRecord {
+    size_t job;                 // Index of the job in the manifest
+    float isovalue;
+    std::string output;         // File written, empty if none
+    bool ok = false;
+    size_t triangles = 0;
+    double area = 0;            // Surface area and enclosed volume, see MeshStats
+    double volume = 0;
+    double startSeconds = 0;    // When the task started, from the start of the batch
+    double extractSeconds = 0;
+    double writeSeconds = 0;
+};
+
+/***
+ * BatchOptions: how a batch is run
+*/
+struct BatchOptions {
+    unsigned concurrentTasks = 0;   // Extractions running at once, 0 for one per thread of the shared pool
+    ExtractionOptions extraction;   // Options of every extraction; its engine is taken from each job
+};
+
+/***
+ * @brief Parse one manifest line.
+ * @param line The line
+ * @param[out] job Receives the job
+ * @param[out] error Receives the reason if the line is invalid
+ * @return bool True if the line is a valid job
+*/
+bool parseBatchJob(const std::string& line, BatchJob& job, std::string& error);
+
+/***
+ * @brief Read a manifest, reporting every invalid line on stderr.
+ * @param path The manifest file
+ * @param[out] jobs Receives the jobs in manifest order
+ * @return bool True if the file was read and every line is valid
+*/
+bool readBatchManifest(const std::string& path, std::vector<BatchJob>& jobs);
+
+/***
+ * @brief Output file of one isovalue of a job.
+ * @param job The job
+ * @param index Index of the isovalue
+ * @return std::string job.output, numbered when the job has several isovalues
+*/
+std::string batchOutputPath(const BatchJob& job, size_t index);
+
+/***
+ * @brief Run every job of a batch.
+ * @param jobs The jobs
+ * @param options Concurrency and extraction options
+ * @return std::vector<BatchRecord> One record per isovalue, in manifest order
+*/
+std::vector<BatchRecord> runBatch(const std::vector<BatchJob>& jobs, const BatchOptions& options = BatchOptions());
+
+/***
+ * @brief Write the records of a batch as CSV, one line per record after a header.
+ * @param records The records
+ * @param path The CSV file
+ * @return bool True if the file was written
+*/
+bool writeBatchReport(const std::vector<BatchRecord>& records, const std::string& path);
+
+#endif // BATCH_HPP
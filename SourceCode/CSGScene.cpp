@@ -0,0 +1,498 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file CSGScene.cpp
+ *
+ * @brief Implementation of the CSG scenes and their bounding volume hierarchies.
+ */
+
+#include <float.h>
+#include <stdio.h>
+#include <cmath>
+
+#include "CSGScene.hpp"
+#include "SampleGrid.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+
+float CSGBox::distance(const float* p) const {
+    float d2 = 0.0f;
+    for (int a = 0; a < 3; ++a) {
+        float d = std::max(std::max(min[a] - p[a], p[a] - max[a]), 0.0f);
+        d2 += d * d;
+    }
+    return std::sqrt(d2);
+}
+
+
+/***
+ * @brief The box holding a batch of points.
+*/
+static CSGBox boxOf(const float* points, size_t count) {
+    CSGBox box = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+    for (size_t i = 0; i < count; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            box.min[a] = std::min(box.min[a], points[3 * i + a]);
+            box.max[a] = std::max(box.max[a], points[3 * i + a]);
+        }
+    }
+    return box;
+}
+
+
+/***
+ * @brief Polynomial smooth minimum, min(a, b) lowered by up to radius / 4 where a and b are within radius.
+*/
+static float smoothMin(float a, float b, float radius) {
+    float h = std::max(radius - std::fabs(a - b), 0.0f) / radius;
+    return std::min(a, b) - h * h * radius * 0.25f;
+}
+
+
+/***
+ * @brief Keep the two smallest child values of a union or blend.
+*/
+static void keepSmallest(float child, float& first, float& second) {
+    if (child < first) {
+        second = first;
+        first = child;
+    } else if (child < second) {
+        second = child;
+    }
+}
+
+
+/***
+ * @brief The value of a union or blend from its two smallest child values.
+ * A blend only smooths between its two nearest children, so the children
+ * farther than its radius from the nearest never change its value.
+*/
+static float combine(const CSGNode& node, float first, float second) {
+    return node.op == CSGOperation::Blend ? smoothMin(first, second, node.radius) : first;
+}
+
+
+/***
+ * @brief The signed distance of a shape, or the value of a field primitive.
+*/
+static float shapeValue(const CSGNode& node, const float* p) {
+    const float dx = p[0] - node.center[0], dy = p[1] - node.center[1], dz = p[2] - node.center[2];
+    switch (node.shape) {
+        case CSGShape::Sphere:
+            return std::sqrt(dx * dx + dy * dy + dz * dz) - node.size[0];
+        case CSGShape::Box: {
+            const float qx = std::fabs(dx) - node.size[0], qy = std::fabs(dy) - node.size[1], qz = std::fabs(dz) - node.size[2];
+            const float ox = std::max(qx, 0.0f), oy = std::max(qy, 0.0f), oz = std::max(qz, 0.0f);
+            return std::sqrt(ox * ox + oy * oy + oz * oz) + std::min(std::max(qx, std::max(qy, qz)), 0.0f);
+        }
+        case CSGShape::Torus: {
+            const float q = std::sqrt(dx * dx + dy * dy) - node.size[0];
+            return std::sqrt(q * q + dz * dz) - node.size[1];
+        }
+        case CSGShape::Field:
+            return node.field(dx, dy, dz);
+    }
+    return FLT_MAX;
+}
+
+
+/***
+ * @brief Build the hierarchy over bvhChildren[begin, end) of a node, splitting at the median centroid.
+ * @return uint32_t Index of the hierarchy node built for the range
+*/
+static uint32_t buildRange(CSGNode& node, uint32_t begin, uint32_t end) {
+    const uint32_t index = node.bvh.size();
+    node.bvh.emplace_back();
+
+    CSGBox box = node.childBoxes[node.bvhChildren[begin]];
+    CSGBox centroids = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+    for (uint32_t n = begin; n < end; ++n) {
+        const CSGBox& child = node.childBoxes[node.bvhChildren[n]];
+        box.merge(child);
+        for (int a = 0; a < 3; ++a) {
+            const float c = 0.5f * (child.min[a] + child.max[a]);
+            centroids.min[a] = std::min(centroids.min[a], c);
+            centroids.max[a] = std::max(centroids.max[a], c);
+        }
+    }
+
+    if (end - begin <= CSG_BVH_LEAF) {
+        node.bvh[index] = {box, begin, end - begin, 0};
+        return index;
+    }
+
+    int axis = 0;
+    for (int a = 1; a < 3; ++a) {
+        if (centroids.max[a] - centroids.min[a] > centroids.max[axis] - centroids.min[axis]) axis = a;
+    }
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(node.bvhChildren.begin() + begin, node.bvhChildren.begin() + mid, node.bvhChildren.begin() + end,
+                     [&](uint32_t a, uint32_t b) {
+        const CSGBox& ba = node.childBoxes[a];
+        const CSGBox& bb = node.childBoxes[b];
+        return ba.min[axis] + ba.max[axis] < bb.min[axis] + bb.max[axis];
+    });
+
+    buildRange(node, begin, mid);
+    const uint32_t second = buildRange(node, mid, end);
+    node.bvh[index] = {box, 0, 0, second};
+    return index;
+}
+
+
+CSGScene::CSGScene(float margin) : margin(std::max(margin, FLT_MIN)) {}
+
+
+void CSGScene::fitShape(CSGNode& node) {
+    // Half extents of the shape
+    float h[3] = {node.size[0], node.size[1], node.size[2]};
+    if (node.shape == CSGShape::Sphere) h[1] = h[2] = node.size[0];
+    if (node.shape == CSGShape::Torus) {
+        h[0] = h[1] = node.size[0] + node.size[1];
+        h[2] = node.size[1];
+    }
+    for (int a = 0; a < 3; ++a) {
+        node.bounds.min[a] = node.center[a] - h[a];
+        node.bounds.max[a] = node.center[a] + h[a];
+    }
+
+    // A distance is below the reach only within the reach of the shape's box; a field's box is the caller's
+    if (node.shape != CSGShape::Field) node.bounds.grow(node.reach);
+}
+
+
+void CSGScene::fitOperator(CSGNode& node) {
+    // An operator without children is empty, its box inside out
+    node.bounds = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+    node.childBoxes.clear();
+    node.bvh.clear();
+    node.bvhChildren.clear();
+    if (node.children.empty()) return;
+
+    node.bounds = nodes[node.children[0]].bounds;
+    if (node.op == CSGOperation::Difference) return;
+    for (size_t child : node.children) {
+        const CSGBox& b = nodes[child].bounds;
+        if (node.op == CSGOperation::Intersection) {
+            for (int a = 0; a < 3; ++a) {
+                node.bounds.min[a] = std::max(node.bounds.min[a], b.min[a]);
+                node.bounds.max[a] = std::min(node.bounds.max[a], b.max[a]);
+            }
+        } else {
+            node.childBoxes.push_back(b);
+            node.bounds.merge(b);
+        }
+    }
+    if (node.op == CSGOperation::Intersection) return;
+
+    node.bvhChildren.resize(node.children.size());
+    for (size_t n = 0; n < node.children.size(); ++n) node.bvhChildren[n] = n;
+    buildRange(node, 0, node.children.size());
+}
+
+
+void CSGScene::widen(size_t id, float reach) {
+    CSGNode& node = nodes[id];
+    if (node.reach >= reach) return;
+    node.reach = reach;
+    if (node.op == CSGOperation::Shape) {
+        fitShape(node);
+        return;
+    }
+
+    // Other parents of the children keep their smaller boxes, which still hold the children below their reach
+    const float childReach = node.op == CSGOperation::Blend ? reach + CSG_BLEND_REACH * node.radius : reach;
+    for (size_t child : node.children) widen(child, childReach);
+    fitOperator(node);
+}
+
+
+size_t CSGScene::addShape(CSGShape shape, float x, float y, float z, float sx, float sy, float sz, const ScalarField& f) {
+    CSGNode node;
+    node.op = CSGOperation::Shape;
+    node.shape = shape;
+    node.center[0] = x;
+    node.center[1] = y;
+    node.center[2] = z;
+    node.size[0] = sx;
+    node.size[1] = sy;
+    node.size[2] = sz;
+    node.field = f;
+    node.reach = margin;
+    fitShape(node);
+
+    nodes.push_back(std::move(node));
+    ++primitives;
+    return nodes.size() - 1;
+}
+
+
+size_t CSGScene::addOperator(CSGOperation op, const std::vector<size_t>& children, float radius) {
+    CSGNode node;
+    node.op = op;
+    node.radius = radius;
+    node.reach = margin;
+    for (size_t child : children) {
+        if (child < nodes.size()) node.children.push_back(child);
+        else fprintf(stderr, "CSG node %zu does not exist and is left out\n", child);
+    }
+
+    // A blend reads its second nearest child up to beyond its own reach
+    if (op == CSGOperation::Blend) {
+        for (size_t child : node.children) widen(child, margin + CSG_BLEND_REACH * radius);
+    }
+    fitOperator(node);
+
+    nodes.push_back(std::move(node));
+    return nodes.size() - 1;
+}
+
+
+size_t CSGScene::sphere(float x, float y, float z, float radius) {
+    return addShape(CSGShape::Sphere, x, y, z, radius, 0.0f, 0.0f);
+}
+
+
+size_t CSGScene::box(float x, float y, float z, float hx, float hy, float hz) {
+    return addShape(CSGShape::Box, x, y, z, hx, hy, hz);
+}
+
+
+size_t CSGScene::torus(float x, float y, float z, float ringRadius, float tubeRadius) {
+    return addShape(CSGShape::Torus, x, y, z, ringRadius, tubeRadius, 0.0f);
+}
+
+
+size_t CSGScene::field(const ScalarField& f, float x, float y, float z, float hx, float hy, float hz) {
+    return addShape(CSGShape::Field, x, y, z, hx, hy, hz, f);
+}
+
+
+size_t CSGScene::unite(const std::vector<size_t>& children) {
+    return addOperator(CSGOperation::Union, children);
+}
+
+
+size_t CSGScene::intersect(const std::vector<size_t>& children) {
+    return addOperator(CSGOperation::Intersection, children);
+}
+
+
+size_t CSGScene::subtract(size_t a, size_t b) {
+    return addOperator(CSGOperation::Difference, {a, b});
+}
+
+
+size_t CSGScene::blend(const std::vector<size_t>& children, float radius) {
+    return addOperator(CSGOperation::Blend, children, std::max(radius, FLT_MIN));
+}
+
+
+float CSGScene::evaluate(size_t id, const float* p) const {
+    const CSGNode& node = nodes[id];
+    if (!node.bounds.contains(p)) return std::max(node.reach, node.bounds.distance(p));
+
+    switch (node.op) {
+        case CSGOperation::Shape:
+            return shapeValue(node, p);
+        case CSGOperation::Intersection: {
+            float value = -FLT_MAX;
+            for (size_t child : node.children) value = std::max(value, evaluate(child, p));
+            return value;
+        }
+        case CSGOperation::Difference: {
+            float value = evaluate(node.children[0], p);
+            for (size_t n = 1; n < node.children.size(); ++n) value = std::max(value, -evaluate(node.children[n], p));
+            return value;
+        }
+        default:
+            break;
+    }
+
+    // Union and blend: the children whose box holds the point; every other child is at least its reach there
+    float first = FLT_MAX, second = FLT_MAX;
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const uint32_t index = stack[--top];
+        const CSGBVHNode& b = node.bvh[index];
+        if (!b.box.contains(p)) continue;
+        if (b.count == 0) {
+            stack[top++] = b.second;
+            stack[top++] = index + 1;
+            continue;
+        }
+        for (uint32_t n = b.first; n < b.first + b.count; ++n) {
+            const uint32_t position = node.bvhChildren[n];
+            if (!node.childBoxes[position].contains(p)) continue;
+            keepSmallest(evaluate(node.children[position], p), first, second);
+        }
+    }
+    return std::min(combine(node, first, second), node.reach);
+}
+
+
+void CSGScene::evaluate(size_t id, const float* points, size_t count, float* values) const {
+    const CSGNode& node = nodes[id];
+    const CSGBox box = boxOf(points, count);
+
+    if (!node.bounds.overlaps(box)) {
+        for (size_t i = 0; i < count; ++i) values[i] = std::max(node.reach, node.bounds.distance(&points[3 * i]));
+        return;
+    }
+
+    if (node.op == CSGOperation::Shape) {
+        for (size_t i = 0; i < count; ++i) values[i] = shapeValue(node, &points[3 * i]);
+    } else if (node.op == CSGOperation::Intersection || node.op == CSGOperation::Difference) {
+        std::vector<float> part(count);
+        evaluate(node.children[0], points, count, values);
+        for (size_t n = 1; n < node.children.size(); ++n) {
+            evaluate(node.children[n], points, count, part.data());
+            if (node.op == CSGOperation::Intersection) {
+                for (size_t i = 0; i < count; ++i) values[i] = std::max(values[i], part[i]);
+            } else {
+                for (size_t i = 0; i < count; ++i) values[i] = std::max(values[i], -part[i]);
+            }
+        }
+    } else {
+        // Walk the hierarchy once for the whole batch, evaluating each child for the points in its box
+        std::vector<float> first(count, FLT_MAX), second(count, FLT_MAX);
+        std::vector<uint32_t> which;
+        std::vector<float> inside, part;
+
+        uint32_t stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const uint32_t index = stack[--top];
+            const CSGBVHNode& b = node.bvh[index];
+            if (!b.box.overlaps(box)) continue;
+            if (b.count == 0) {
+                stack[top++] = b.second;
+                stack[top++] = index + 1;
+                continue;
+            }
+            for (uint32_t n = b.first; n < b.first + b.count; ++n) {
+                const uint32_t position = node.bvhChildren[n];
+                const CSGBox& childBox = node.childBoxes[position];
+                if (!childBox.overlaps(box)) continue;
+
+                which.clear();
+                inside.clear();
+                for (size_t i = 0; i < count; ++i) {
+                    if (!childBox.contains(&points[3 * i])) continue;
+                    which.push_back(i);
+                    inside.insert(inside.end(), &points[3 * i], &points[3 * i + 3]);
+                }
+                if (which.empty()) continue;
+
+                part.resize(which.size());
+                evaluate(node.children[position], inside.data(), which.size(), part.data());
+                for (size_t w = 0; w < which.size(); ++w) keepSmallest(part[w], first[which[w]], second[which[w]]);
+            }
+        }
+        for (size_t i = 0; i < count; ++i) values[i] = std::min(combine(node, first[i], second[i]), node.reach);
+    }
+
+    // The points outside the node's box, as evaluate(id, p) leaves them
+    for (size_t i = 0; i < count; ++i) {
+        const float* p = &points[3 * i];
+        if (!node.bounds.contains(p)) values[i] = std::max(node.reach, node.bounds.distance(p));
+    }
+}
+
+
+float CSGScene::evaluateAll(size_t id, const float* p) const {
+    const CSGNode& node = nodes[id];
+    if (node.op == CSGOperation::Shape) return shapeValue(node, p);
+    if (node.children.empty()) return FLT_MAX;
+
+    if (node.op == CSGOperation::Union || node.op == CSGOperation::Blend) {
+        float first = FLT_MAX, second = FLT_MAX;
+        for (size_t child : node.children) keepSmallest(evaluateAll(child, p), first, second);
+        return combine(node, first, second);
+    }
+
+    float value = evaluateAll(node.children[0], p);
+    for (size_t n = 1; n < node.children.size(); ++n) {
+        const float child = evaluateAll(node.children[n], p);
+        value = node.op == CSGOperation::Intersection ? std::max(value, child) : std::max(value, -child);
+    }
+    return value;
+}
+
+
+float CSGScene::operator()(float x, float y, float z) const {
+    if (nodes.empty()) return FLT_MAX;
+    const float p[3] = {x, y, z};
+    return evaluate(nodes.size() - 1, p);
+}
+
+
+void CSGScene::evaluate(const float* points, size_t count, float* values) const {
+    if (count == 0) return;
+    if (nodes.empty()) {
+        for (size_t i = 0; i < count; ++i) values[i] = FLT_MAX;
+        return;
+    }
+    evaluate(nodes.size() - 1, points, count, values);
+}
+
+
+float CSGScene::evaluateAll(float x, float y, float z) const {
+    if (nodes.empty()) return FLT_MAX;
+    const float p[3] = {x, y, z};
+    return evaluateAll(nodes.size() - 1, p);
+}
+
+
+void CSGScene::sample(SampleGrid& samples, const GridAxes& axes, unsigned threads) const {
+    TRACE_SCOPE("csg_sample");
+    const size_t sx = axes.xs.size(), sy = axes.ys.size(), sz = axes.zs.size();
+    const size_t bricks = (sx + SAMPLE_BRICK - 1) / SAMPLE_BRICK;
+
+    // One x row of bricks per task, one batch per brick
+    ThreadPool::shared().parallelFor(bricks, [&](size_t bi) {
+        std::vector<float> points, values;
+        const size_t i0 = bi * SAMPLE_BRICK, i1 = std::min(sx, i0 + SAMPLE_BRICK);
+        for (size_t j0 = 0; j0 < sy; j0 += SAMPLE_BRICK) {
+            for (size_t k0 = 0; k0 < sz; k0 += SAMPLE_BRICK) {
+                const size_t j1 = std::min(sy, j0 + SAMPLE_BRICK), k1 = std::min(sz, k0 + SAMPLE_BRICK);
+                points.clear();
+                for (size_t i = i0; i < i1; ++i) {
+                    for (size_t j = j0; j < j1; ++j) {
+                        for (size_t k = k0; k < k1; ++k) {
+                            points.push_back(axes.xs[i]);
+                            points.push_back(axes.ys[j]);
+                            points.push_back(axes.zs[k]);
+                        }
+                    }
+                }
+
+                values.resize(points.size() / 3);
+                evaluate(points.data(), values.size(), values.data());
+                const float* value = values.data();
+                for (size_t i = i0; i < i1; ++i) {
+                    for (size_t j = j0; j < j1; ++j) {
+                        for (size_t k = k0; k < k1; ++k) samples(i, j, k) = *value++;
+                    }
+                }
+            }
+        }
+    }, threads);
+}
+
+
+ScalarField CSGScene::asField() const {
+    return [this](float x, float y, float z) { return (*this)(x, y, z); };
+}
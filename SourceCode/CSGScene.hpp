@@ -0,0 +1,266 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file CSGScene.hpp
+ *
+ * @brief Scalar fields built from many primitives by constructive solid geometry.
+ * A CSGScene is a tree of primitives (spheres, boxes, tori and bounded
+ * fields such as f4) combined by union, intersection, difference and
+ * smooth blending, with the inside of every node below 0. Written as one
+ * function, every sample would evaluate every primitive; instead every node
+ * has a reach, the margin of the scene, and an influence box holding every
+ * point where its value is below its reach (for a shape, its box grown by
+ * the reach), and every union or blend keeps a bounding volume hierarchy
+ * (BVH) over the boxes of its children. A sample evaluates only the
+ * children whose box contains it, found in time logarithmic in their
+ * number, and a node whose box does not contain the sample returns a value
+ * of at least its reach at once.
+ *
+ * Below its reach, the value of a node is the exact value of its subtree
+ * (see evaluateAll), so within the margin of 0 the scene is exactly the
+ * tree and so is its surface at isovalue 0; farther away the value is only
+ * known to have the right sign, and for distance primitives to be at most
+ * the distance to the surface. A blend is the polynomial smooth minimum of
+ * its two nearest children, which it needs exact up to 1.25 times its
+ * radius beyond its own reach; creating a blend widens the reach and the
+ * boxes of its subtree accordingly.
+ *
+ * The value of a shape primitive is its signed distance. A field primitive
+ * is a ScalarField evaluated relative to its center, bounded by a box the
+ * caller gives, which must hold every point where the field is below its
+ * reach: the margin, or more under a blend.
+ *
+ * Nodes are created bottom-up, children first; the root of the scene is
+ * the node created last. The scene is immutable once built and every
+ * evaluation is const, so it can be sampled from many threads at once.
+ *
+ * Example:
+ *
+ * CSGScene scene;
+ * size_t body = scene.box(0, 0, 0, 2, 2, 2);
+ * size_t hole = scene.sphere(0, 0, 0, 2.5f);
+ * scene.subtract(body, hole);
+ * marching_cubes_two_pass(scene.asField(), Grid::cube(-5, 5, 0.05f), 0.0f, mesh);
+ */
+
+#ifndef CSGSCENE_HPP
+#define CSGSCENE_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+#include "Fields.hpp"
+#include "MarchingCubes.hpp"
+
+class SampleGrid;
+
+// Default distance beyond the bounds of a shape within which its value is exact
+const float CSG_DEFAULT_MARGIN = 0.25f;
+
+// Reach a blend needs of its children beyond its own, in blend radii
+const float CSG_BLEND_REACH = 1.25f;
+
+// Children per leaf of the hierarchy of a union or blend
+const size_t CSG_BVH_LEAF = 4;
+
+/***
+ * CSGOperation: what a node of the tree does
+*/
+enum class CSGOperation {
+    Shape,         // A primitive
+    Union,         // min over the children
+    Intersection,  // max over the children
+    Difference,    // The first child minus the second, max(a, -b)
+    Blend          // Union smoothed between the two nearest children over some radius
+};
+
+/***
+ * CSGShape: the primitives of a tree
+*/
+enum class CSGShape {
+    Sphere,  // size[0]: radius
+    Box,     // size: half extents
+    Torus,   // Around the z axis like f4, size[0]: ring radius, size[1]: tube radius
+    Field    // A ScalarField relative to the center, size: half extents of its bounds
+};
+
+/***
+ * CSGBox: an axis-aligned box
+*/
+struct CSGBox {
+    float min[3];
+    float max[3];
+
+    bool contains(const float* p) const {
+        return p[0] >= min[0] && p[0] <= max[0] && p[1] >= min[1] && p[1] <= max[1] && p[2] >= min[2] && p[2] <= max[2];
+    }
+
+    bool overlaps(const CSGBox& other) const {
+        for (int a = 0; a < 3; ++a) {
+            if (other.max[a] < min[a] || other.min[a] > max[a]) return false;
+        }
+        return true;
+    }
+
+    /***
+     * @brief Euclidean distance from a point to the box, 0 inside it.
+    */
+    float distance(const float* p) const;
+
+    void grow(float d) {
+        for (int a = 0; a < 3; ++a) {
+            min[a] -= d;
+            max[a] += d;
+        }
+    }
+
+    void merge(const CSGBox& other) {
+        for (int a = 0; a < 3; ++a) {
+            min[a] = std::min(min[a], other.min[a]);
+            max[a] = std::max(max[a], other.max[a]);
+        }
+    }
+};
+
+/***
+ * CSGBVHNode: a node of the hierarchy over the children of a union or blend.
+ * A leaf holds children[first, first + count) of the node's bvhChildren; an
+ * inner node (count 0) has its first child right after it and its second at second.
+*/
+struct CSGBVHNode {
+    CSGBox box;
+    uint32_t first;
+    uint32_t count;
+    uint32_t second;
+};
+
+/***
+ * CSGNode: a primitive or an operator of the tree
+*/
+struct CSGNode {
+    CSGOperation op;
+    CSGShape shape = CSGShape::Sphere;  // Shape nodes
+    float center[3] = {0, 0, 0};        // Shape nodes
+    float size[3] = {0, 0, 0};          // Shape nodes, see CSGShape
+    ScalarField field;                  // Field shapes
+    std::vector<size_t> children;       // Operators, in the order given
+    float radius = 0.0f;                // Blend radius
+    float reach = 0.0f;                 // Value below which the node is exact
+    CSGBox bounds;                      // Influence box, outside of which the value is at least the reach
+    std::vector<CSGBox> childBoxes;     // Union and blend: the box each child is evaluated in
+    std::vector<CSGBVHNode> bvh;        // Union and blend: hierarchy over childBoxes
+    std::vector<uint32_t> bvhChildren;  // Union and blend: positions in children, in leaf order
+};
+
+/***
+ * CSGScene: a CSG tree of primitives, evaluated as a scalar field
+*/
+class CSGScene {
+
+private:
+
+    float margin;
+    std::vector<CSGNode> nodes;
+    size_t primitives = 0;
+
+    size_t addShape(CSGShape shape, float x, float y, float z, float sx, float sy, float sz, const ScalarField& f = nullptr);
+    size_t addOperator(CSGOperation op, const std::vector<size_t>& children, float radius = 0.0f);
+    void fitShape(CSGNode& node);
+    void fitOperator(CSGNode& node);
+    void widen(size_t id, float reach);
+    float evaluate(size_t id, const float* p) const;
+    void evaluate(size_t id, const float* points, size_t count, float* values) const;
+    float evaluateAll(size_t id, const float* p) const;
+
+public:
+
+    /***
+     * @param margin The reach of the nodes, the value below which they are exact
+    */
+    explicit CSGScene(float margin = CSG_DEFAULT_MARGIN);
+
+    /***
+     * @brief Add a primitive. Every primitive returns its id, for the operators.
+    */
+    size_t sphere(float x, float y, float z, float radius);
+    size_t box(float x, float y, float z, float hx, float hy, float hz);
+    size_t torus(float x, float y, float z, float ringRadius, float tubeRadius);
+
+    /***
+     * @brief Add a field as a primitive, f(x - cx, y - cy, z - cz).
+     * @param f The field, called concurrently from several threads
+     * @param hx, hy, hz Half extents of a box around the center holding
+     * every point where the field is below its reach
+    */
+    size_t field(const ScalarField& f, float x, float y, float z, float hx, float hy, float hz);
+
+    /***
+     * @brief Add an operator over nodes added before. Every operator returns its id.
+    */
+    size_t unite(const std::vector<size_t>& children);
+    size_t intersect(const std::vector<size_t>& children);
+    size_t subtract(size_t a, size_t b);
+
+    /***
+     * @brief The union of nodes, smoothly blended where the two nearest are within a radius of each other.
+    */
+    size_t blend(const std::vector<size_t>& children, float radius);
+
+    /***
+     * @brief The value of the scene at a point, through the hierarchies.
+    */
+    float operator()(float x, float y, float z) const;
+
+    /***
+     * @brief The value of the scene at a batch of points.
+     * The hierarchies are walked once for the box of the batch, and every
+     * child is evaluated for the points inside its box only; the values are
+     * those of operator(). Best for batches of nearby points, such as the
+     * samples of a brick.
+     * @param points count (x, y, z) points
+     * @param count Number of points
+     * @param[out] values count values
+    */
+    void evaluate(const float* points, size_t count, float* values) const;
+
+    /***
+     * @brief The value of the whole tree, every primitive evaluated without the boxes.
+     * For checking and for comparing against operator(); its cost grows linearly with the scene.
+    */
+    float evaluateAll(float x, float y, float z) const;
+
+    /***
+     * @brief Sample the scene at every corner of a grid, one batch per 8 x 8 x 8 brick of samples.
+     * @param[out] samples Samples of the grid, allocated for axes
+     * @param axes Corner coordinates of the grid
+     * @param threads Maximum number of threads, 0 for the whole shared pool
+    */
+    void sample(SampleGrid& samples, const GridAxes& axes, unsigned threads = 0) const;
+
+    /***
+     * @brief The scene as a ScalarField for the extraction kernels.
+     * The field refers to the scene, which must outlive it.
+    */
+    ScalarField asField() const;
+
+    /***
+     * @brief Influence box of the whole scene, which must have a node.
+    */
+    const CSGBox& bounds() const { return nodes.back().bounds; }
+
+    size_t nodeCount() const { return nodes.size(); }
+    size_t primitiveCount() const { return primitives; }
+    float influenceMargin() const { return margin; }
+};
+
+#endif // CSGSCENE_HPP
@@ -0,0 +1,228 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file ChunkedMesh.cpp
+ *
+ * @brief Implementation of the mesh chunks and their frustum culling.
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+
+#include "ChunkedMesh.hpp"
+#include "MarchingCubes.hpp"
+#include "MeshOptimizer.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+/***
+ * BrickLayout: maps points to the bricks of a grid
+*/
+struct BrickLayout {
+    float min[3];
+    float stepsize;
+    size_t cells[3];
+    size_t bricks[3];
+    size_t brickCells;
+
+    BrickLayout(const Grid& grid, size_t brickCells) : brickCells(std::max<size_t>(1, brickCells)) {
+        GridAxes axes = gridAxes(grid);
+        min[0] = grid.minx;
+        min[1] = grid.miny;
+        min[2] = grid.minz;
+        stepsize = grid.stepsize;
+        cells[0] = axes.nx();
+        cells[1] = axes.ny();
+        cells[2] = axes.nz();
+        for (int d = 0; d < 3; ++d) bricks[d] = std::max<size_t>(1, (cells[d] + this->brickCells - 1) / this->brickCells);
+    }
+
+    size_t count() const { return bricks[0] * bricks[1] * bricks[2]; }
+
+    /***
+     * @brief The brick holding the centroid of a triangle.
+    */
+    size_t brickOf(const float* a, const float* b, const float* c) const {
+        size_t brick[3];
+        for (int d = 0; d < 3; ++d) {
+            float cell = ((a[d] + b[d] + c[d]) / 3.0f - min[d]) / stepsize;
+            size_t i = cell > 0.0f ? std::min<size_t>((size_t) cell, cells[d] - 1) : 0;
+            brick[d] = i / brickCells;
+        }
+        return (brick[0] * bricks[1] + brick[1]) * bricks[2] + brick[2];
+    }
+};
+
+
+/***
+ * @brief Counting sort of triangles by brick, stable within a brick.
+ * @param brickOf Brick of every triangle
+ * @param brickCount Number of bricks
+ * @param[out] starts First sorted triangle of every brick, plus the total
+ * @return std::vector<size_t> The triangles in sorted order
+*/
+static std::vector<size_t> sortByBrick(const std::vector<uint32_t>& brickOf, size_t brickCount, std::vector<size_t>& starts) {
+    starts.assign(brickCount + 1, 0);
+    for (uint32_t b : brickOf) starts[b + 1]++;
+    for (size_t b = 0; b < brickCount; ++b) starts[b + 1] += starts[b];
+
+    std::vector<size_t> next(starts.begin(), starts.end() - 1);
+    std::vector<size_t> order(brickOf.size());
+    for (size_t t = 0; t < brickOf.size(); ++t) order[next[brickOf[t]]++] = t;
+    return order;
+}
+
+
+/***
+ * @brief Grow a bounding box by a point.
+*/
+static void growBox(MeshChunk& chunk, const float* p) {
+    for (int d = 0; d < 3; ++d) {
+        chunk.min[d] = std::min(chunk.min[d], p[d]);
+        chunk.max[d] = std::max(chunk.max[d], p[d]);
+    }
+}
+
+
+static MeshChunk emptyChunk(size_t first, size_t count) {
+    MeshChunk chunk = {first, count, {INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+    return chunk;
+}
+
+
+std::vector<MeshChunk> chunkMesh(Mesh& mesh, const Grid& grid, size_t brickCells) {
+    TRACE_SCOPE("chunk_mesh");
+    BrickLayout layout(grid, brickCells);
+    const size_t triangleCount = mesh.triangleCount();
+
+    std::vector<uint32_t> brickOf(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const float* v = &mesh.vertices[9 * t];
+        brickOf[t] = layout.brickOf(v, v + 3, v + 6);
+    }
+    std::vector<size_t> starts;
+    std::vector<size_t> order = sortByBrick(brickOf, layout.count(), starts);
+
+    Mesh sorted;
+    sorted.vertices.resize(mesh.vertices.size());
+    sorted.normals.resize(mesh.normals.size());
+    for (size_t t = 0; t < triangleCount; ++t) {
+        memcpy(&sorted.vertices[9 * t], &mesh.vertices[9 * order[t]], 9 * sizeof(float));
+        memcpy(&sorted.normals[9 * t], &mesh.normals[9 * order[t]], 9 * sizeof(float));
+    }
+    mesh.vertices.swap(sorted.vertices);
+    mesh.normals.swap(sorted.normals);
+
+    std::vector<MeshChunk> chunks;
+    for (size_t b = 0; b < layout.count(); ++b) {
+        if (starts[b] == starts[b + 1]) continue;
+        MeshChunk chunk = emptyChunk(3 * starts[b], 3 * (starts[b + 1] - starts[b]));
+        for (size_t v = chunk.first; v < chunk.first + chunk.count; ++v) growBox(chunk, &mesh.vertices[3 * v]);
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+
+std::vector<MeshChunk> chunkMesh(IndexedMesh& mesh, const Grid& grid, size_t brickCells, bool optimize, unsigned threads) {
+    TRACE_SCOPE("chunk_mesh");
+    BrickLayout layout(grid, brickCells);
+    const size_t triangleCount = mesh.triangleCount();
+
+    std::vector<uint32_t> brickOf(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const uint32_t* tri = &mesh.indices[3 * t];
+        brickOf[t] = layout.brickOf(&mesh.positions[3 * tri[0]], &mesh.positions[3 * tri[1]], &mesh.positions[3 * tri[2]]);
+    }
+    std::vector<size_t> starts;
+    std::vector<size_t> order = sortByBrick(brickOf, layout.count(), starts);
+
+    std::vector<uint32_t> sorted(mesh.indices.size());
+    for (size_t t = 0; t < triangleCount; ++t) memcpy(&sorted[3 * t], &mesh.indices[3 * order[t]], 3 * sizeof(uint32_t));
+    mesh.indices.swap(sorted);
+
+    std::vector<MeshChunk> chunks;
+    for (size_t b = 0; b < layout.count(); ++b) {
+        if (starts[b] != starts[b + 1]) chunks.push_back(emptyChunk(3 * starts[b], 3 * (starts[b + 1] - starts[b])));
+    }
+
+    if (optimize) {
+        ThreadPool::shared().parallelFor(chunks.size(), [&](size_t c) {
+            optimizeVertexCacheRange(&mesh.indices[chunks[c].first], chunks[c].count / 3);
+        }, threads);
+        optimizeVertexFetch(mesh);
+    }
+
+    for (MeshChunk& chunk : chunks) {
+        for (size_t i = chunk.first; i < chunk.first + chunk.count; ++i) growBox(chunk, &mesh.positions[3 * mesh.indices[i]]);
+    }
+    return chunks;
+}
+
+
+Frustum frustumFromMatrix(const float* mvp) {
+    // Row r of the column-major matrix is (m[r], m[4 + r], m[8 + r], m[12 + r])
+    auto row = [&](int r, int c) { return mvp[4 * c + r]; };
+
+    // Gribb and Hartmann: -w <= x, y, z <= w in clip space gives w + x >= 0, w - x >= 0, ...
+    Frustum frustum;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            float* plane = frustum.planes[2 * axis + side];
+            float sign = side == 0 ? 1.0f : -1.0f;
+            for (int c = 0; c < 4; ++c) plane[c] = row(3, c) + sign * row(axis, c);
+
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f) {
+                for (int c = 0; c < 4; ++c) plane[c] /= length;
+            }
+        }
+    }
+    return frustum;
+}
+
+
+bool frustumIntersectsBox(const Frustum& frustum, const float* min, const float* max) {
+    for (const float* plane : frustum.planes) {
+        // The corner furthest along the plane normal; if it is outside, the whole box is
+        float x = plane[0] >= 0.0f ? max[0] : min[0];
+        float y = plane[1] >= 0.0f ? max[1] : min[1];
+        float z = plane[2] >= 0.0f ? max[2] : min[2];
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f) return false;
+    }
+    return true;
+}
+
+
+std::vector<DrawRange> cullChunks(const std::vector<MeshChunk>& chunks, const Frustum& frustum, CullStats* stats) {
+    CullStats counted;
+    std::vector<DrawRange> ranges;
+    for (const MeshChunk& chunk : chunks) {
+        counted.chunks++;
+        counted.triangles += chunk.count / 3;
+        if (!frustumIntersectsBox(frustum, chunk.min, chunk.max)) continue;
+
+        counted.visibleChunks++;
+        counted.visibleTriangles += chunk.count / 3;
+        if (!ranges.empty() && ranges.back().first + ranges.back().count == chunk.first) {
+            ranges.back().count += chunk.count;
+        } else {
+            ranges.push_back({chunk.first, chunk.count});
+        }
+    }
+    counted.draws = ranges.size();
+
+    TRACE_COUNT("chunks_culled", counted.culledChunks());
+    TRACE_COUNT("triangles_culled", counted.culledTriangles());
+    if (stats != nullptr) *stats = counted;
+    return ranges;
+}
@@ -0,0 +1,121 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file ChunkedMesh.hpp
+ *
+ * @brief Spatial chunks of a mesh and frustum culling of them.
+ * chunkMesh sorts the triangles of a mesh by the brick of grid cells their
+ * centroid falls in, bricks of the same size as the extraction bricks, so
+ * every chunk is one contiguous range of the vertex or index buffer, with
+ * the bounding box of its triangles. Every frame, cullChunks tests the boxes
+ * against the view frustum and returns the ranges to draw, with adjacent
+ * visible chunks merged into a single draw.
+ *
+ * Nothing here touches OpenGL: the frustum comes from the model-view-projection
+ * matrix as 16 floats, so the culling can be checked on the CPU.
+ */
+
+#ifndef CHUNKEDMESH_HPP
+#define CHUNKEDMESH_HPP
+
+#include <stddef.h>
+#include <vector>
+
+#include "IndexedMesh.hpp"
+#include "Mesh.hpp"
+
+/***
+ * MeshChunk: one brick's triangles, as a range of the vertex or index buffer
+*/
+struct MeshChunk {
+    size_t first;   // First vertex (triangle soup) or index (indexed mesh) of the chunk
+    size_t count;   // Vertices or indices in the chunk, three per triangle
+    float min[3];   // Bounding box of the chunk's triangles
+    float max[3];
+};
+
+/***
+ * Frustum: six planes a*x + b*y + c*z + d >= 0 inside, normals pointing in
+*/
+struct Frustum {
+    float planes[6][4];
+};
+
+/***
+ * DrawRange: a range of the vertex or index buffer drawn with one call
+*/
+struct DrawRange {
+    size_t first;
+    size_t count;
+};
+
+/***
+ * CullStats: what one frame's culling kept
+*/
+struct CullStats {
+    size_t chunks = 0;
+    size_t visibleChunks = 0;
+    size_t triangles = 0;
+    size_t visibleTriangles = 0;
+    size_t draws = 0;
+
+    size_t culledChunks() const { return chunks - visibleChunks; }
+    size_t culledTriangles() const { return triangles - visibleTriangles; }
+};
+
+/***
+ * @brief Sort the triangles of a soup into chunks.
+ * Triangles keep their winding and, within a chunk, their order.
+ * @param[in,out] mesh The triangle soup, reordered in place
+ * @param grid The grid the mesh was extracted on
+ * @param brickCells Cells per side of the bricks
+ * @return std::vector<MeshChunk> The non-empty chunks, in buffer order
+*/
+std::vector<MeshChunk> chunkMesh(Mesh& mesh, const Grid& grid, size_t brickCells);
+
+/***
+ * @brief Sort the triangles of an indexed mesh into chunks.
+ * When optimize is set, the triangles of every chunk are then reordered for
+ * the vertex cache (see optimizeVertexCacheRange) and the vertices renumbered
+ * in the order the chunks use them (see optimizeVertexFetch), so culling
+ * keeps the gain of MeshOptimizer.
+ * @param[in,out] mesh The mesh, reordered in place
+ * @param grid The grid the mesh was extracted on
+ * @param brickCells Cells per side of the bricks
+ * @param optimize Reorder for the vertex cache and vertex fetch
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @return std::vector<MeshChunk> The non-empty chunks, in index buffer order
+*/
+std::vector<MeshChunk> chunkMesh(IndexedMesh& mesh, const Grid& grid, size_t brickCells, bool optimize = true, unsigned threads = 0);
+
+/***
+ * @brief Extract the frustum planes of a model-view-projection matrix.
+ * @param mvp The matrix, column-major as OpenGL and glm store it
+ * @return Frustum Its six planes, normalized
+*/
+Frustum frustumFromMatrix(const float* mvp);
+
+/***
+ * @brief Conservative test of a bounding box against a frustum.
+ * @return bool False only if the box is entirely outside one of the planes
+*/
+bool frustumIntersectsBox(const Frustum& frustum, const float* min, const float* max);
+
+/***
+ * @brief Select the chunks inside the frustum.
+ * @param chunks The chunks of a mesh
+ * @param frustum The view frustum
+ * @param[out] stats Optional, receives the chunks and triangles kept and culled
+ * @return std::vector<DrawRange> The buffer ranges to draw, adjacent chunks merged
+*/
+std::vector<DrawRange> cullChunks(const std::vector<MeshChunk>& chunks, const Frustum& frustum, CullStats* stats = nullptr);
+
+#endif // CHUNKEDMESH_HPP
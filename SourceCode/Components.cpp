@@ -0,0 +1,237 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Components.cpp
+ *
+ * @brief Implementation of the connected component labelling and culling.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "Components.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+
+/***
+ * @brief Find the root of a vertex, halving the path on the way.
+*/
+static uint32_t findRoot(std::atomic<uint32_t>* parent, uint32_t v) {
+    for (;;) {
+        uint32_t p = parent[v].load(std::memory_order_relaxed);
+        if (p == v) return v;
+        uint32_t grandparent = parent[p].load(std::memory_order_relaxed);
+        if (grandparent != p) parent[v].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+        v = grandparent;
+    }
+}
+
+
+/***
+ * @brief Join the sets of two vertices, linking the larger root below the smaller one.
+*/
+static void unite(std::atomic<uint32_t>* parent, uint32_t a, uint32_t b) {
+    for (;;) {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        uint32_t expected = a;
+        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+    }
+}
+
+
+ComponentLabels labelComponents(const IndexedMesh& mesh, unsigned threads) {
+    TRACE_SCOPE("label_components");
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t triangleCount = mesh.triangleCount();
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(4 * threads, triangleCount / 4096 + 1));
+    auto range = [](size_t count, size_t parts, size_t p, size_t& first, size_t& last) {
+        first = count * p / parts;
+        last = count * (p + 1) / parts;
+    };
+
+    // Union-find over the vertices of every triangle
+    std::unique_ptr<std::atomic<uint32_t>[]> parent(new std::atomic<uint32_t>[vertexCount]);
+    pool.parallelFor(parts, [&](size_t p) {
+        size_t first, last;
+        range(vertexCount, parts, p, first, last);
+        for (size_t v = first; v < last; ++v) parent[v].store(v, std::memory_order_relaxed);
+    }, threads);
+
+    pool.parallelFor(parts, [&](size_t p) {
+        size_t first, last;
+        range(triangleCount, parts, p, first, last);
+        for (size_t t = first; t < last; ++t) {
+            const uint32_t* tri = &mesh.indices[3 * t];
+            unite(parent.get(), tri[0], tri[1]);
+            unite(parent.get(), tri[0], tri[2]);
+        }
+    }, threads);
+
+    // Number the roots in vertex order; every root is its set's smallest vertex
+    std::vector<uint32_t> rootLabel(vertexCount);
+    std::vector<size_t> rootsBefore(parts + 1, 0);
+    pool.parallelFor(parts, [&](size_t p) {
+        size_t first, last;
+        range(vertexCount, parts, p, first, last);
+        for (size_t v = first; v < last; ++v) rootsBefore[p + 1] += parent[v].load(std::memory_order_relaxed) == v;
+    }, threads);
+    for (size_t p = 0; p < parts; ++p) rootsBefore[p + 1] += rootsBefore[p];
+
+    pool.parallelFor(parts, [&](size_t p) {
+        size_t first, last;
+        range(vertexCount, parts, p, first, last);
+        uint32_t next = rootsBefore[p];
+        for (size_t v = first; v < last; ++v) {
+            if (parent[v].load(std::memory_order_relaxed) == v) rootLabel[v] = next++;
+        }
+    }, threads);
+
+    // Label the triangles and count them per component, one counter array per thread
+    ComponentLabels labels;
+    const size_t componentCount = rootsBefore[parts];
+    const size_t sortParts = std::max<size_t>(1, std::min<size_t>(threads, triangleCount / 4096 + 1));
+    labels.triangleComponent.resize(triangleCount);
+    std::vector<std::vector<uint32_t>> partCounts(sortParts);
+    pool.parallelFor(sortParts, [&](size_t p) {
+        size_t first, last;
+        range(triangleCount, sortParts, p, first, last);
+        partCounts[p].assign(componentCount, 0);
+        for (size_t t = first; t < last; ++t) {
+            uint32_t c = rootLabel[findRoot(parent.get(), mesh.indices[3 * t])];
+            labels.triangleComponent[t] = c;
+            partCounts[p][c]++;
+        }
+    }, threads);
+
+    // Group the triangles by component with a counting sort, keeping their order within a component
+    std::vector<size_t> componentStart(componentCount + 1, 0);
+    for (size_t c = 0; c < componentCount; ++c) {
+        size_t count = 0;
+        for (size_t p = 0; p < sortParts; ++p) {
+            uint32_t n = partCounts[p][c];
+            partCounts[p][c] = componentStart[c] + count;
+            count += n;
+        }
+        componentStart[c + 1] = componentStart[c] + count;
+    }
+
+    std::vector<uint32_t> byComponent(triangleCount);
+    pool.parallelFor(sortParts, [&](size_t p) {
+        size_t first, last;
+        range(triangleCount, sortParts, p, first, last);
+        for (size_t t = first; t < last; ++t) byComponent[partCounts[p][labels.triangleComponent[t]]++] = t;
+    }, threads);
+    partCounts.clear();
+
+    // Triangle count, area and bounding box of every component
+    labels.components.resize(componentCount);
+    const size_t statParts = std::max<size_t>(1, std::min<size_t>(4 * threads, componentCount));
+    pool.parallelFor(statParts, [&](size_t p) {
+        size_t first, last;
+        range(componentCount, statParts, p, first, last);
+        for (size_t c = first; c < last; ++c) {
+            ComponentStats& stats = labels.components[c];
+            stats = {componentStart[c + 1] - componentStart[c], 0.0, INFINITY, -INFINITY, INFINITY, -INFINITY, INFINITY, -INFINITY};
+            for (size_t s = componentStart[c]; s < componentStart[c + 1]; ++s) {
+                const uint32_t* tri = &mesh.indices[3 * byComponent[s]];
+                const float* a = &mesh.positions[3 * tri[0]];
+                const float* b = &mesh.positions[3 * tri[1]];
+                const float* d = &mesh.positions[3 * tri[2]];
+
+                double ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+                double vx = d[0] - a[0], vy = d[1] - a[1], vz = d[2] - a[2];
+                double cx = uy * vz - uz * vy, cy = uz * vx - ux * vz, cz = ux * vy - uy * vx;
+                stats.area += 0.5 * sqrt(cx * cx + cy * cy + cz * cz);
+
+                for (const float* v : {a, b, d}) {
+                    stats.minx = std::min(stats.minx, v[0]);
+                    stats.maxx = std::max(stats.maxx, v[0]);
+                    stats.miny = std::min(stats.miny, v[1]);
+                    stats.maxy = std::max(stats.maxy, v[1]);
+                    stats.minz = std::min(stats.minz, v[2]);
+                    stats.maxz = std::max(stats.maxz, v[2]);
+                }
+            }
+        }
+    }, threads);
+
+    TRACE_COUNT("components", componentCount);
+    return labels;
+}
+
+
+Mesh cullComponents(const Mesh& mesh, const ComponentLabels& labels, size_t minTriangles, double minArea, unsigned threads) {
+    TRACE_SCOPE("cull_components");
+    const size_t triangleCount = mesh.triangleCount();
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(4 * threads, triangleCount / 4096 + 1));
+
+    std::vector<unsigned char> keep(labels.components.size());
+    for (size_t c = 0; c < keep.size(); ++c) {
+        keep[c] = labels.components[c].triangles >= minTriangles && labels.components[c].area >= minArea;
+    }
+
+    // Count the kept triangles of every part, then copy them to their offsets
+    std::vector<size_t> offsets(parts + 1, 0);
+    pool.parallelFor(parts, [&](size_t p) {
+        for (size_t t = triangleCount * p / parts; t < triangleCount * (p + 1) / parts; ++t) {
+            offsets[p + 1] += keep[labels.triangleComponent[t]];
+        }
+    }, threads);
+    for (size_t p = 0; p < parts; ++p) offsets[p + 1] += offsets[p];
+
+    Mesh culled;
+    culled.vertices.resize(9 * offsets[parts]);
+    culled.normals.resize(9 * offsets[parts]);
+    std::vector<MeshStats> partStats(parts);
+    pool.parallelFor(parts, [&](size_t p) {
+        size_t out = 9 * offsets[p];
+        for (size_t t = triangleCount * p / parts; t < triangleCount * (p + 1) / parts; ++t) {
+            if (!keep[labels.triangleComponent[t]]) continue;
+            std::copy(mesh.vertices.begin() + 9 * t, mesh.vertices.begin() + 9 * t + 9, culled.vertices.begin() + out);
+            std::copy(mesh.normals.begin() + 9 * t, mesh.normals.begin() + 9 * t + 9, culled.normals.begin() + out);
+            partStats[p].addTriangle(&mesh.vertices[9 * t]);
+            out += 9;
+        }
+    }, threads);
+    for (const MeshStats& stats : partStats) culled.stats.merge(stats);
+
+    TRACE_COUNT("culled_triangles", triangleCount - offsets[parts]);
+    return culled;
+}
+
+
+void printComponentSummary(const ComponentLabels& labels, size_t rows) {
+    std::vector<size_t> order(labels.components.size());
+    for (size_t c = 0; c < order.size(); ++c) order[c] = c;
+    rows = std::min(rows, order.size());
+    std::partial_sort(order.begin(), order.begin() + rows, order.end(), [&](size_t a, size_t b) {
+        return labels.components[a].triangles > labels.components[b].triangles;
+    });
+
+    printf("\n%zu connected components\n", labels.components.size());
+    printf("%10s %12s %12s   %s\n", "component", "triangles", "area", "bounding box");
+    for (size_t r = 0; r < rows; ++r) {
+        const ComponentStats& stats = labels.components[order[r]];
+        printf("%10zu %12zu %12.4f   (%.3f, %.3f, %.3f) - (%.3f, %.3f, %.3f)\n", order[r], stats.triangles, stats.area,
+               stats.minx, stats.miny, stats.minz, stats.maxx, stats.maxy, stats.maxz);
+    }
+}
@@ -0,0 +1,85 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Components.hpp
+ *
+ * @brief Connected components of an extracted surface and culling of small ones.
+ * Components are labelled with a lock-free union-find over the welded
+ * vertices: every thread unites the vertices of its triangles with
+ * compare-and-swap, always linking the larger root below the smaller one,
+ * so the result does not depend on the order the threads run in.
+ * Components are numbered in the order of their smallest vertex. The
+ * triangles are then grouped by component with a counting sort, and each
+ * component's triangle count, area and bounding box are computed in
+ * parallel.
+ *
+ * Culling keeps the triangles of the components that reach a minimum
+ * triangle count and area, in their original order, so the result goes
+ * straight to the viewer or to writePLY.
+ */
+
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "IndexedMesh.hpp"
+#include "Mesh.hpp"
+
+/***
+ * ComponentStats: the size and extent of one connected component
+*/
+struct ComponentStats {
+    size_t triangles;
+    double area;
+    float minx, maxx;
+    float miny, maxy;
+    float minz, maxz;
+};
+
+/***
+ * ComponentLabels: the component of every triangle and the statistics of every component
+*/
+struct ComponentLabels {
+    std::vector<uint32_t> triangleComponent;
+    std::vector<ComponentStats> components;
+};
+
+/***
+ * @brief Label the connected components of a welded mesh.
+ * Two triangles are connected when they share a vertex.
+ * @param mesh The welded mesh
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @return ComponentLabels The labels and statistics
+*/
+ComponentLabels labelComponents(const IndexedMesh& mesh, unsigned threads = 0);
+
+/***
+ * @brief Drop the triangles of components below a triangle count or an area.
+ * @param mesh The triangle soup the labels were computed for
+ * @param labels The labels of its triangles
+ * @param minTriangles Components with fewer triangles are dropped
+ * @param minArea Components with a smaller area are dropped
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @return Mesh The kept triangles, in their original order
+*/
+Mesh cullComponents(const Mesh& mesh, const ComponentLabels& labels, size_t minTriangles, double minArea, unsigned threads = 0);
+
+/***
+ * @brief Print the number of components and a table of the largest ones.
+ * @param labels The labels to summarize
+ * @param rows Number of components listed
+*/
+void printComponentSummary(const ComponentLabels& labels, size_t rows = 10);
+
+#endif // COMPONENTS_HPP
@@ -28,6 +28,9 @@
  * NEAR_BOTTOM_RIGHT: 4
  * FAR_BOTTOM_RIGHT: 2
  * FAR_BOTTOM_LEFT: 1
+ * REFRESH_SECONDS: Longest wait for events while the extraction or playback runs
+ * MAX_FRAME_SECONDS: Cap on the frame time used for camera motion
+ * ENGINE_VERSION: Version of the extraction engine, part of every mesh cache key
  */
 
 #ifndef CONSTANTS_HPP
@@ -46,5 +49,14 @@ const int FAR_BOTTOM_LEFT = 1;
 // GRAPHICS CONSTANTS
 const float SHININESS = 64.0;
 
+// RENDER LOOP CONSTANTS
+const double REFRESH_SECONDS = 1.0 / 60.0; // Longest wait for events while the mesh is still changing
+const float MAX_FRAME_SECONDS = 0.05f;     // Longest frame time applied to camera motion, after an idle wait
+
+// ENGINE CONSTANTS
+// Bump whenever a change to the extraction code alters its output, so that
+// meshes cached by an older engine are never served again.
+const int ENGINE_VERSION = 1;
+
 
 #endif // CONSTANTS_HPP
\ No newline at end of file
@@ -0,0 +1,365 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Daemon.cpp
+ *
+ * @brief Implementation of the extraction daemon and its client.
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Daemon.hpp"
+#include "MeshStream.hpp"
+#include "PLYWriter.hpp"
+#include "Trace.hpp"
+
+// Longest request line the daemon accepts
+const size_t DAEMON_MAX_REQUEST = 1024;
+
+// Floats of vertices per chunk of a streamed mesh
+const size_t DAEMON_CHUNK_FLOATS = 1 << 16;
+
+
+std::string formatDaemonRequest(const DaemonRequest& request) {
+    char line[DAEMON_MAX_REQUEST];
+    snprintf(line, sizeof(line), "ISOREQ %d %s %a %a %a %a %a %a %a %a %s\n",
+             DAEMON_PROTOCOL_VERSION, request.fieldId.c_str(), request.isovalue,
+             request.grid.minx, request.grid.maxx, request.grid.miny, request.grid.maxy,
+             request.grid.minz, request.grid.maxz, request.grid.stepsize, request.format.c_str());
+    return line;
+}
+
+
+bool parseDaemonRequest(const std::string& line, DaemonRequest& request) {
+    int version = 0;
+    char field[64];
+    char format[16];
+    int parsed = sscanf(line.c_str(), "ISOREQ %d %63s %a %a %a %a %a %a %a %a %15s",
+                        &version, field, &request.isovalue,
+                        &request.grid.minx, &request.grid.maxx, &request.grid.miny, &request.grid.maxy,
+                        &request.grid.minz, &request.grid.maxz, &request.grid.stepsize, format);
+    if (parsed != 11 || version != DAEMON_PROTOCOL_VERSION) return false;
+    request.fieldId = field;
+    request.format = format;
+    return request.grid.stepsize > 0.0f && (request.format == "mesh" || request.format == "ply");
+}
+
+
+/***
+ * DaemonJob: one extraction and the connections waiting for it
+*/
+struct DaemonJob {
+    std::string key;
+    DaemonRequest request;
+    bool done = false;
+    bool ok = false;
+    Mesh mesh;
+};
+
+/***
+ * DaemonConnection: a client connection and the thread serving it
+*/
+struct DaemonConnection {
+    int fd;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+};
+
+/***
+ * Daemon: the job queue shared by the connection and job threads
+*/
+struct Daemon {
+    const DaemonOptions& options;
+    std::mutex mutex;
+    std::condition_variable jobQueued;   // a job was queued, or the daemon is stopping
+    std::condition_variable jobFinished; // a job was queued, finished or left the queue
+    std::deque<std::shared_ptr<DaemonJob>> queue;
+    std::unordered_map<std::string, std::shared_ptr<DaemonJob>> pending;
+    bool stopping = false;
+    size_t requests = 0;
+    size_t extractions = 0;
+
+    explicit Daemon(const DaemonOptions& options) : options(options) {}
+
+    /***
+     * @brief Queue a request, or attach it to an identical job, and wait for the result.
+    */
+    std::shared_ptr<DaemonJob> run(const DaemonRequest& request) {
+        DaemonRequest key = request;
+        key.format = "";
+        std::string jobKey = formatDaemonRequest(key);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        requests++;
+        std::shared_ptr<DaemonJob> job;
+
+        // Backpressure: hold the connection until the queue has room, unless an identical
+        // job is or becomes pending meanwhile, which the request then waits for instead
+        jobFinished.wait(lock, [&]() { return stopping || pending.count(jobKey) > 0 || queue.size() < options.maxQueuedJobs; });
+        auto found = pending.find(jobKey);
+        if (found != pending.end()) {
+            job = found->second;
+            TRACE_COUNT("daemon_batched", 1);
+        } else {
+            if (stopping) return nullptr;
+            job = std::make_shared<DaemonJob>();
+            job->key = jobKey;
+            job->request = request;
+            pending[jobKey] = job;
+            queue.push_back(job);
+            jobQueued.notify_one();
+            jobFinished.notify_all();
+        }
+        jobFinished.wait(lock, [&]() { return job->done; });
+        return job;
+    }
+
+    /***
+     * @brief Drain the queue until the daemon stops and the queue is empty.
+    */
+    void jobLoop() {
+        for (;;) {
+            std::shared_ptr<DaemonJob> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobQueued.wait(lock, [&]() { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                job = queue.front();
+                queue.pop_front();
+                jobFinished.notify_all();
+            }
+
+            Mesh mesh;
+            bool ok = false;
+            scalar_field_3d f = findField(job->request.fieldId);
+            if (f != nullptr) {
+                TRACE_SCOPE("daemon_job");
+                IsoSurfaceExtractor extractor(f, job->request.fieldId, job->request.grid, options.extraction);
+                mesh = extractor.extract(job->request.isovalue);
+                ok = true;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            extractions++;
+            auto entry = pending.find(job->key);
+            if (entry != pending.end() && entry->second == job) pending.erase(entry);
+            job->mesh = std::move(mesh);
+            job->ok = ok;
+            job->done = true;
+            jobFinished.notify_all();
+        }
+    }
+};
+
+
+/***
+ * @brief Send the result of a job in the format of a request.
+*/
+static bool sendResult(int fd, const DaemonRequest& request, const DaemonJob* job) {
+    if (job == nullptr || !job->ok) {
+        return MeshStreamWriter(fd, 1).finish();
+    }
+
+    const Mesh& mesh = job->mesh;
+    if (request.format == "ply") {
+        std::ostringstream ply;
+        writePLYHeader(ply, mesh.vertexCount(), mesh.hasStats() ? &mesh.stats : nullptr);
+        writePLYVertices(ply, mesh.vertices.data(), mesh.normals.data(), mesh.vertices.size());
+        writePLYFaces(ply, mesh.vertexCount());
+        std::string text = ply.str();
+
+        MeshStreamHeader header;
+        memcpy(header.magic, MESH_STREAM_MAGIC, sizeof(header.magic));
+        header.format = MESH_STREAM_FORMAT;
+        header.status = 0;
+        uint64_t length = text.size();
+        return writeAll(fd, &header, sizeof(header)) && writeAll(fd, &length, sizeof(length)) &&
+               writeAll(fd, text.data(), text.size());
+    }
+
+    MeshStreamWriter stream(fd);
+    for (size_t offset = 0; offset < mesh.vertices.size(); offset += DAEMON_CHUNK_FLOATS) {
+        size_t count = std::min(DAEMON_CHUNK_FLOATS, mesh.vertices.size() - offset);
+        stream.write(mesh.vertices.data() + offset, mesh.normals.data() + offset, count);
+    }
+    return stream.finish();
+}
+
+
+/***
+ * @brief Serve the requests of one connection until it closes.
+*/
+static void serveConnection(Daemon& daemon, DaemonConnection& connection) {
+    std::string buffer;
+    char bytes[4096];
+    bool open = true;
+
+    while (open) {
+        size_t newline;
+        while ((newline = buffer.find('\n')) == std::string::npos) {
+            ssize_t got = read(connection.fd, bytes, sizeof(bytes));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0 || buffer.size() > DAEMON_MAX_REQUEST) {
+                open = false;
+                break;
+            }
+            buffer.append(bytes, got);
+        }
+        if (!open) break;
+
+        std::string line = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+
+        DaemonRequest request;
+        std::shared_ptr<DaemonJob> job;
+        if (parseDaemonRequest(line, request)) job = daemon.run(request);
+        else fprintf(stderr, "Invalid daemon request: %s\n", line.c_str());
+        open = sendResult(connection.fd, request, job.get());
+    }
+
+    close(connection.fd);
+    connection.finished = true;
+}
+
+
+bool runDaemon(const DaemonOptions& options, const std::atomic<bool>& stop) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (options.socketPath.size() >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path %s is too long\n", options.socketPath.c_str());
+        return false;
+    }
+    strcpy(address.sun_path, options.socketPath.c_str());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(options.socketPath.c_str());
+    if (listener < 0 || bind(listener, (sockaddr*) &address, sizeof(address)) != 0 || listen(listener, 128) != 0) {
+        fprintf(stderr, "Failed to listen on %s: %s\n", options.socketPath.c_str(), strerror(errno));
+        if (listener >= 0) close(listener);
+        return false;
+    }
+
+    // A client that hangs up mid-response must not kill the daemon
+    signal(SIGPIPE, SIG_IGN);
+    printf("Listening on %s\n", options.socketPath.c_str());
+
+    Daemon daemon(options);
+    std::vector<std::thread> jobThreads;
+    for (unsigned j = 0; j < std::max(1u, options.maxConcurrentJobs); ++j) {
+        jobThreads.emplace_back([&daemon]() { daemon.jobLoop(); });
+    }
+
+    std::list<std::unique_ptr<DaemonConnection>> connections;
+    auto reap = [&]() {
+        for (auto it = connections.begin(); it != connections.end(); ) {
+            if ((*it)->finished) {
+                (*it)->thread.join();
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    };
+
+    while (!stop.load()) {
+        reap();
+
+        // Leave new connections in the backlog while the connection limit is reached
+        if (connections.size() >= std::max(1u, options.maxConnections)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        pollfd waiting = {listener, POLLIN, 0};
+        if (poll(&waiting, 1, 200) <= 0) continue;
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        connections.emplace_back(new DaemonConnection());
+        DaemonConnection& connection = *connections.back();
+        connection.fd = fd;
+        connection.thread = std::thread([&daemon, &connection]() { serveConnection(daemon, connection); });
+    }
+
+    // Stop taking requests, finish the queued jobs and wait for every connection
+    close(listener);
+    unlink(options.socketPath.c_str());
+    {
+        std::lock_guard<std::mutex> lock(daemon.mutex);
+        daemon.stopping = true;
+        daemon.jobQueued.notify_all();
+        daemon.jobFinished.notify_all();
+    }
+    for (std::thread& thread : jobThreads) thread.join();
+    for (auto& connection : connections) {
+        if (!connection->finished) shutdown(connection->fd, SHUT_RDWR);
+    }
+    for (auto& connection : connections) connection->thread.join();
+
+    printf("Served %zu requests with %zu extractions\n", daemon.requests, daemon.extractions);
+    return true;
+}
+
+
+bool DaemonClient::connect(const std::string& socketPath) {
+    disconnect();
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return false;
+    strcpy(address.sun_path, socketPath.c_str());
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (::connect(fd, (sockaddr*) &address, sizeof(address)) != 0) {
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+
+void DaemonClient::disconnect() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+}
+
+
+bool DaemonClient::extract(const DaemonRequest& request, Mesh& mesh) {
+    if (fd < 0) return false;
+
+    DaemonRequest meshRequest = request;
+    meshRequest.format = "mesh";
+    std::string line = formatDaemonRequest(meshRequest);
+    if (!writeAll(fd, line.data(), line.size())) return false;
+
+    mesh.clear();
+    return readMeshStream(fd, mesh);
+}
@@ -0,0 +1,127 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Daemon.hpp
+ *
+ * @brief A long-running extraction service on a Unix domain socket.
+ * Clients connect to the socket and send one request line per extraction;
+ * a connection can carry any number of requests, answered in order. Every
+ * request becomes a job in a bounded queue that at most maxConcurrentJobs
+ * job threads drain, each extraction running on the shared thread pool.
+ * Requests with the same field, bounds, step size and isovalue as a job
+ * that is queued or running attach to that job instead of adding their
+ * own, so a burst of identical requests costs a single extraction.
+ *
+ * Backpressure: when the queue is full, connections block before queueing
+ * their next job and stop reading from their sockets, so clients are held
+ * back by the socket buffers; beyond maxConnections open connections, new
+ * ones wait in the listen backlog.
+ *
+ * Request line (floats in hexadecimal so that they are exact):
+ *
+ * ISOREQ <version> <field> <isovalue> <minx> <maxx> <miny> <maxy> <minz> <maxz> <stepsize> <format>
+ *
+ * Responses, by format:
+ *
+ * mesh: a mesh stream (see MeshStream.hpp)
+ * ply: a MeshStreamHeader, then the byte count (uint64_t) and the ASCII PLY file
+ *
+ * A request that cannot be served is answered with a MeshStreamHeader whose
+ * status is not 0 (followed by the end of a mesh stream).
+ */
+
+#ifndef DAEMON_HPP
+#define DAEMON_HPP
+
+#include <stddef.h>
+#include <atomic>
+#include <string>
+
+#include "IsoSurfaceExtractor.hpp"
+#include "Mesh.hpp"
+
+const int DAEMON_PROTOCOL_VERSION = 1;
+
+/***
+ * DaemonRequest: one extraction asked of the daemon
+*/
+struct DaemonRequest {
+    std::string fieldId;          // A built-in field name, see findField
+    float isovalue;
+    Grid grid;
+    std::string format = "mesh";  // "mesh" or "ply"
+};
+
+/***
+ * DaemonOptions: where the daemon listens and how much work it takes on
+*/
+struct DaemonOptions {
+    std::string socketPath = "/tmp/assign5.sock"; // Path of the Unix domain socket
+    unsigned maxConcurrentJobs = 2;               // Extractions running at once
+    size_t maxQueuedJobs = 64;                    // Jobs waiting before connections are held back
+    unsigned maxConnections = 64;                 // Connections served at once
+    ExtractionOptions extraction;                 // Options of every extraction, such as the mesh cache
+};
+
+/***
+ * @brief Format a request as its protocol line, including the newline.
+*/
+std::string formatDaemonRequest(const DaemonRequest& request);
+
+/***
+ * @brief Parse a request line.
+ * @return bool True if the line is a valid request of this protocol version
+*/
+bool parseDaemonRequest(const std::string& line, DaemonRequest& request);
+
+/***
+ * @brief Serve requests on the socket until stop becomes true.
+ * Queued and running jobs are finished before the call returns.
+ * @param options The socket and the limits
+ * @param stop Flag that shuts the daemon down, checked several times a second
+ * @return bool False if the socket could not be opened
+*/
+bool runDaemon(const DaemonOptions& options, const std::atomic<bool>& stop);
+
+/***
+ * DaemonClient: a connection to a daemon that sends requests one after another
+*/
+class DaemonClient {
+
+private:
+
+    int fd = -1;
+
+public:
+
+    DaemonClient() {}
+    DaemonClient(const DaemonClient&) = delete;
+    DaemonClient& operator=(const DaemonClient&) = delete;
+    ~DaemonClient() { disconnect(); }
+
+    /***
+     * @brief Connect to the daemon listening on a socket.
+     * @return bool True if connected
+    */
+    bool connect(const std::string& socketPath);
+
+    void disconnect();
+
+    /***
+     * @brief Send a request in the mesh format and read the mesh back.
+     * @param request The request; its format is ignored
+     * @param[out] mesh Receives the isosurface
+     * @return bool True if the daemon served the request
+    */
+    bool extract(const DaemonRequest& request, Mesh& mesh);
+};
+
+#endif // DAEMON_HPP
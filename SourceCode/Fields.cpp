@@ -0,0 +1,106 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Fields.cpp
+ *
+ * @brief Definitions of the built-in generating functions.
+ */
+
+#include <cmath>
+
+#include "Fields.hpp"
+
+
+/***
+ * Our generating functions
+*/
+float f1(float x, float y, float z) {
+	return x*x+y*y+z*z;
+}
+float f2(float x, float y, float z) {
+	return y-sin(x)*cos(z);
+}
+float f3(float x, float y, float z) {
+	return x*x-y*y-z*z-z;
+}
+// Torus shape
+float f4(float x, float y, float z) {
+	float r1 = 3.0; // radius of torus
+	float r2 = 1.0; // radius of tube
+	float d = sqrt(x*x+y*y);
+	return (r1 - d)*(r1 - d) + z*z - r2*r2;
+}
+// Saddle
+float f5(float x, float y, float z) {
+	return x*x - y*y - z*z*z;
+}
+// Sphere with a hole
+float f6(float x, float y, float z) {
+	float r1 = 3.0; // radius of outer sphere
+	float r2 = 1.0; // radius of inner sphere
+	float d = sqrt(x*x+y*y+z*z);
+	return (d - r1)*(d - r2);
+}
+// Twisted Torus
+float f7(float x, float y, float z) {
+	float r1 = 3.0; // radius of torus
+	float r2 = 1.0; // radius of tube
+	float d = sqrt(x*x+y*y);
+	float twist = sin(x+y+z);
+	return (r1 - d)*(r1 - d) + (z - twist)*(z - twist) - r2*r2;
+}
+// Mobius strip
+float f8(float x, float y, float z) {
+	float a = 0.5; // width of strip
+	float b = 2.0; // radius of loop
+	float u = x*cos(z) + y*sin(z);
+	float v = -x*sin(z) + y*cos(z);
+	return v*v - b*b + a*u;
+}
+
+
+/***
+ * Our animated generating functions
+*/
+// Torus with a pulsing tube
+float f4t(float x, float y, float z, float t) {
+	float r1 = 3.0; // radius of torus
+	float r2 = 1.0 + 0.25 * sin(t); // radius of tube
+	float d = sqrt(x*x+y*y);
+	return (r1 - d)*(r1 - d) + z*z - r2*r2;
+}
+// Twisted Torus with a travelling twist
+float f7t(float x, float y, float z, float t) {
+	float r1 = 3.0; // radius of torus
+	float r2 = 1.0; // radius of tube
+	float d = sqrt(x*x+y*y);
+	float twist = sin(x+y+z+t);
+	return (r1 - d)*(r1 - d) + (z - twist)*(z - twist) - r2*r2;
+}
+
+
+scalar_field_3d findField(const std::string& name) {
+    static const scalar_field_3d fields[8] = {f1, f2, f3, f4, f5, f6, f7, f8};
+    if (name.size() == 2 && name[0] == 'f' && name[1] >= '1' && name[1] <= '8') {
+        return fields[name[1] - '1'];
+    }
+    return nullptr;
+}
+
+
+TimeVaryingField findTimeVaryingField(const std::string& name) {
+    if (name == "f4") return f4t;
+    if (name == "f7") return f7t;
+
+    scalar_field_3d f = findField(name);
+    if (f == nullptr) return TimeVaryingField();
+    return [f](float x, float y, float z, float) { return f(x, y, z); };
+}
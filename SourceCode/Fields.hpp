@@ -0,0 +1,66 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Fields.hpp
+ *
+ * @brief The scalar fields the isosurface library can extract.
+ * This file declares the field types accepted by the library and the eight
+ * built-in generating functions f1 - f8, which can also be looked up by
+ * name ("f1" - "f8") so that a field can be named in a cache key, a
+ * command line or a request from another process. Time-varying fields take
+ * a fourth argument, the time; animated versions of the torus (f4) and the
+ * twisted torus (f7) are built in.
+ */
+
+#ifndef FIELDS_HPP
+#define FIELDS_HPP
+
+#include <functional>
+#include <string>
+
+typedef float (*scalar_field_3d)(float, float, float);
+
+// Any callable field, including lambdas that capture state
+typedef std::function<float(float, float, float)> ScalarField;
+
+// A field that also depends on time, f(x, y, z, t)
+typedef std::function<float(float, float, float, float)> TimeVaryingField;
+
+// Our generating functions
+float f1(float x, float y, float z);
+float f2(float x, float y, float z);
+float f3(float x, float y, float z);
+float f4(float x, float y, float z); // Torus shape
+float f5(float x, float y, float z); // Saddle
+float f6(float x, float y, float z); // Sphere with a hole
+float f7(float x, float y, float z); // Twisted Torus
+float f8(float x, float y, float z); // Mobius strip
+
+// Animated generating functions, equal to their static versions at t = 0
+float f4t(float x, float y, float z, float t); // Torus with a pulsing tube
+float f7t(float x, float y, float z, float t); // Twisted Torus with a travelling twist
+
+/***
+ * @brief Look up a built-in generating function by name.
+ * @param name Name of the function, "f1" to "f8"
+ * @return scalar_field_3d The function, or nullptr if the name is unknown
+*/
+scalar_field_3d findField(const std::string& name);
+
+/***
+ * @brief Look up the time-varying version of a built-in generating function by name.
+ * f4 and f7 are animated; the other functions are returned unchanged over time.
+ * @param name Name of the function, "f1" to "f8"
+ * @return TimeVaryingField The function, or an empty function if the name is unknown
+*/
+TimeVaryingField findTimeVaryingField(const std::string& name);
+
+#endif // FIELDS_HPP
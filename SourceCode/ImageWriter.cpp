@@ -0,0 +1,144 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file ImageWriter.cpp
+ *
+ * @brief Implementation of the PPM and PNG output.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <fstream>
+
+#include "ImageWriter.hpp"
+
+// Largest payload of a stored deflate block
+const size_t DEFLATE_STORED_MAX = 65535;
+
+
+bool writePPM(const Image& image, const std::string& outputPath) {
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out.is_open()) {
+        fprintf(stderr, "Failed to open image file %s\n", outputPath.c_str());
+        return false;
+    }
+    out << "P6\n" << image.width << " " << image.height << "\n255\n";
+    out.write((const char*) image.rgb.data(), image.rgb.size());
+    out.close();
+    return !out.fail();
+}
+
+
+/***
+ * @brief Update a CRC-32 (as used by PNG chunks) with more bytes.
+*/
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    static uint32_t table[256];
+    static bool filled = false;
+    if (!filled) {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        filled = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+
+static void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+
+/***
+ * @brief Write a PNG chunk: length, type, data and the CRC of type and data.
+*/
+static void writeChunk(std::ostream& out, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    chunk.reserve(data.size() + 12);
+    appendBigEndian(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    appendBigEndian(chunk, crc32(0, &chunk[4], data.size() + 4));
+    out.write((const char*) chunk.data(), chunk.size());
+}
+
+
+bool writePNG(const Image& image, const std::string& outputPath) {
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out.is_open()) {
+        fprintf(stderr, "Failed to open image file %s\n", outputPath.c_str());
+        return false;
+    }
+
+    const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.write((const char*) signature, sizeof(signature));
+
+    // 8-bit truecolour, no interlacing
+    std::vector<uint8_t> header;
+    appendBigEndian(header, image.width);
+    appendBigEndian(header, image.height);
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+    writeChunk(out, "IHDR", header);
+
+    // Every row starts with filter type 0 (none)
+    const size_t rowBytes = 3 * (size_t) image.width;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * image.height);
+    for (unsigned y = 0; y < image.height; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), image.rgb.begin() + y * rowBytes, image.rgb.begin() + (y + 1) * rowBytes);
+    }
+
+    // A zlib stream of stored blocks, followed by the Adler-32 of the raw bytes
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    zlib.reserve(raw.size() + raw.size() / DEFLATE_STORED_MAX * 5 + 16);
+    size_t offset = 0;
+    do {
+        size_t length = std::min(DEFLATE_STORED_MAX, raw.size() - offset);
+        bool last = offset + length == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(length & 0xFF);
+        zlib.push_back(length >> 8);
+        zlib.push_back(~length & 0xFF);
+        zlib.push_back((~length >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+    writeChunk(out, "IDAT", zlib);
+    writeChunk(out, "IEND", {});
+
+    out.close();
+    return !out.fail();
+}
+
+
+bool writeImage(const Image& image, const std::string& outputPath) {
+    const std::string png = ".png";
+    bool isPNG = outputPath.size() >= png.size() &&
+                 std::equal(png.rbegin(), png.rend(), outputPath.rbegin(), [](char a, char b) { return a == tolower(b); });
+    printf("Writing image : %s\n", outputPath.c_str());
+    return isPNG ? writePNG(image, outputPath) : writePPM(image, outputPath);
+}
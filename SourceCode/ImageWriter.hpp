@@ -0,0 +1,54 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file ImageWriter.hpp
+ *
+ * @brief RGB images and their output as PPM or PNG files.
+ * The PNG writer has no dependency: the pixels go into stored (uncompressed)
+ * deflate blocks, so files are about the size of the raw pixels, which is
+ * fine for thumbnails.
+ */
+
+#ifndef IMAGEWRITER_HPP
+#define IMAGEWRITER_HPP
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/***
+ * Image: 8-bit RGB pixels, row by row from the top
+*/
+struct Image {
+    unsigned width = 0;
+    unsigned height = 0;
+    std::vector<uint8_t> rgb;
+};
+
+/***
+ * @brief Write an image as a binary PPM (P6) file.
+ * @return bool True if the file was written
+*/
+bool writePPM(const Image& image, const std::string& outputPath);
+
+/***
+ * @brief Write an image as a PNG file.
+ * @return bool True if the file was written
+*/
+bool writePNG(const Image& image, const std::string& outputPath);
+
+/***
+ * @brief Write an image as PNG if the path ends in .png, and as PPM otherwise.
+ * @return bool True if the file was written
+*/
+bool writeImage(const Image& image, const std::string& outputPath);
+
+#endif // IMAGEWRITER_HPP
@@ -0,0 +1,175 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file IndexedMesh.cpp
+ *
+ * @brief Implementation of the parallel vertex welding.
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "IndexedMesh.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+/***
+ * VertexKey: the bit pattern of a position, with -0 folded into +0
+*/
+struct VertexKey {
+    uint32_t bits[3];
+
+    bool operator==(const VertexKey& other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        uint64_t h = key.bits[0] * 0x9E3779B97F4A7C15ULL;
+        h ^= (h >> 29) + key.bits[1] * 0xBF58476D1CE4E5B9ULL;
+        h ^= (h >> 31) + key.bits[2] * 0x94D049BB133111EBULL;
+        return h ^ (h >> 32);
+    }
+};
+
+
+static VertexKey vertexKey(const float* p) {
+    VertexKey key;
+    for (int d = 0; d < 3; ++d) {
+        float v = p[d] + 0.0f;
+        memcpy(&key.bits[d], &v, sizeof(v));
+    }
+    return key;
+}
+
+
+IndexedMesh weldMesh(const Mesh& mesh, unsigned threads) {
+    TRACE_SCOPE("weld");
+    const size_t vertexCount = mesh.vertexCount();
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(threads, vertexCount / 4096 + 1));
+
+    IndexedMesh indexed;
+    indexed.indices.resize(vertexCount);
+
+    // Count the vertices of every part that fall in every bucket
+    std::vector<size_t> counts(parts * parts, 0);
+    std::vector<uint32_t> bucketOf(vertexCount);
+    VertexKeyHash hash;
+    pool.parallelFor(parts, [&](size_t p) {
+        for (size_t v = vertexCount * p / parts; v < vertexCount * (p + 1) / parts; ++v) {
+            bucketOf[v] = hash(vertexKey(&mesh.vertices[3 * v])) % parts;
+            counts[p * parts + bucketOf[v]]++;
+        }
+    }, threads);
+
+    // Scatter the vertex numbers into their buckets, keeping the soup order within a bucket
+    std::vector<size_t> starts(parts * parts);
+    std::vector<size_t> bucketStart(parts + 1, 0);
+    size_t offset = 0;
+    for (size_t b = 0; b < parts; ++b) {
+        bucketStart[b] = offset;
+        for (size_t p = 0; p < parts; ++p) {
+            starts[p * parts + b] = offset;
+            offset += counts[p * parts + b];
+        }
+    }
+    bucketStart[parts] = offset;
+
+    std::vector<uint32_t> scattered(vertexCount);
+    pool.parallelFor(parts, [&](size_t p) {
+        size_t* next = &starts[p * parts];
+        for (size_t v = vertexCount * p / parts; v < vertexCount * (p + 1) / parts; ++v) {
+            scattered[next[bucketOf[v]]++] = v;
+        }
+    }, threads);
+
+    // Weld every bucket on its own, numbering its unique vertices from zero
+    std::vector<std::vector<uint32_t>> uniques(parts);
+    pool.parallelFor(parts, [&](size_t b) {
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> ids;
+        ids.reserve(bucketStart[b + 1] - bucketStart[b]);
+        for (size_t s = bucketStart[b]; s < bucketStart[b + 1]; ++s) {
+            uint32_t v = scattered[s];
+            auto inserted = ids.emplace(vertexKey(&mesh.vertices[3 * v]), (uint32_t) uniques[b].size());
+            if (inserted.second) uniques[b].push_back(v);
+            indexed.indices[v] = inserted.first->second;
+        }
+    }, threads);
+
+    // Number the unique vertices in the order they first appear in the soup, whatever the number of parts
+    std::vector<uint32_t> firstOf(vertexCount);
+    pool.parallelFor(parts, [&](size_t b) {
+        for (size_t s = bucketStart[b]; s < bucketStart[b + 1]; ++s) firstOf[scattered[s]] = uniques[b][indexed.indices[scattered[s]]];
+    }, threads);
+
+    std::vector<size_t> firstsBefore(parts + 1, 0);
+    pool.parallelFor(parts, [&](size_t p) {
+        for (size_t v = vertexCount * p / parts; v < vertexCount * (p + 1) / parts; ++v) firstsBefore[p + 1] += firstOf[v] == v;
+    }, threads);
+    for (size_t p = 0; p < parts; ++p) firstsBefore[p + 1] += firstsBefore[p];
+    indexed.positions.resize(3 * firstsBefore[parts]);
+
+    // The rank of a first occurrence is its vertex number; the first occurrence always comes first
+    std::vector<uint32_t> rank = std::move(scattered);
+    pool.parallelFor(parts, [&](size_t p) {
+        uint32_t next = firstsBefore[p];
+        for (size_t v = vertexCount * p / parts; v < vertexCount * (p + 1) / parts; ++v) {
+            if (firstOf[v] != v) continue;
+            rank[v] = next;
+            memcpy(&indexed.positions[3 * next], &mesh.vertices[3 * v], 3 * sizeof(float));
+            next++;
+        }
+    }, threads);
+
+    pool.parallelFor(parts, [&](size_t p) {
+        for (size_t v = vertexCount * p / parts; v < vertexCount * (p + 1) / parts; ++v) indexed.indices[v] = rank[firstOf[v]];
+    }, threads);
+
+    TRACE_COUNT("welded_vertices", firstsBefore[parts]);
+    return indexed;
+}
+
+
+void computeVertexNormals(IndexedMesh& mesh) {
+    TRACE_SCOPE("vertex_normals");
+    mesh.normals.assign(mesh.positions.size(), 0.0f);
+
+    // The cross product is twice the area times the unit normal, so summing it weights by area
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        const float* p0 = &mesh.positions[3 * mesh.indices[t]];
+        const float* p1 = &mesh.positions[3 * mesh.indices[t + 1]];
+        const float* p2 = &mesh.positions[3 * mesh.indices[t + 2]];
+        float a[3] = {p0[0] - p1[0], p0[1] - p1[1], p0[2] - p1[2]};
+        float b[3] = {p0[0] - p2[0], p0[1] - p2[1], p0[2] - p2[2]};
+        float n[3] = {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        for (int c = 0; c < 3; ++c) {
+            float* normal = &mesh.normals[3 * mesh.indices[t + c]];
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+        }
+    }
+
+    for (size_t v = 0; v < mesh.normals.size(); v += 3) {
+        float* normal = &mesh.normals[v];
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0.0f) {
+            normal[0] /= length;
+            normal[1] /= length;
+            normal[2] /= length;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file IndexedMesh.hpp
+ *
+ * @brief Indexed meshes built by welding the vertices of a triangle soup.
+ * Marching cubes places every vertex at the midpoint of a grid edge, and
+ * the cells sharing an edge compute that midpoint bit for bit identically,
+ * so welding vertices with exactly equal positions recovers the shared
+ * vertices of the surface without any tolerance.
+ *
+ * Welding runs in parallel: vertices are hashed and scattered into one
+ * bucket per part, each bucket is welded on its own, and a prefix sum over
+ * the first occurrences numbers the unique vertices in the order they first
+ * appear in the soup, so the result does not depend on the thread count.
+ */
+
+#ifndef INDEXEDMESH_HPP
+#define INDEXEDMESH_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "Mesh.hpp"
+
+/***
+ * IndexedMesh: unique vertex positions and three vertex indices per triangle
+*/
+struct IndexedMesh {
+    std::vector<float> positions;  // x, y, z per vertex
+    std::vector<float> normals;    // x, y, z per vertex, empty until computeVertexNormals
+    std::vector<uint32_t> indices; // three per triangle, in the order of the soup
+
+    size_t vertexCount() const { return positions.size() / 3; }
+    size_t triangleCount() const { return indices.size() / 3; }
+};
+
+/***
+ * @brief Weld the vertices of a triangle soup that have exactly the same position.
+ * Triangle t of the result is triangle t of the soup, and vertices are
+ * numbered in order of first appearance. -0 and +0 are welded.
+ * @param mesh The triangle soup
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @return IndexedMesh The welded mesh
+*/
+IndexedMesh weldMesh(const Mesh& mesh, unsigned threads = 0);
+
+/***
+ * @brief Compute smooth vertex normals, the area-weighted average of the
+ * normals of the triangles around each vertex.
+ * The winding matches compute_normals, so the normals face the same way as
+ * those of the soup. Vertices used only by degenerate triangles get a zero normal.
+ * @param[in,out] mesh The mesh whose normals are filled in
+*/
+void computeVertexNormals(IndexedMesh& mesh);
+
+#endif // INDEXEDMESH_HPP
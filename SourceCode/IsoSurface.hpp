@@ -0,0 +1,80 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file IsoSurface.hpp
+ *
+ * @brief The public headers of libisosurface in one include.
+ * Programs embedding the library include this file and link against
+ * libisosurface.a or libisosurface.so; nothing here depends on OpenGL.
+ *
+ * Included headers:
+ *
+ * Fields.hpp: Field types and the built-in generating functions
+ * Mesh.hpp: Grid and mesh types, and the statistics of a mesh
+ * MarchingCubes.hpp: The marching cubes kernel
+ * IsoSurfaceExtractor.hpp: The extraction entry point
+ * Batch.hpp: Manifests of many extractions scheduled together
+ * CSGScene.hpp: CSG scenes of many primitives, evaluated through bounding volume hierarchies
+ * ImageWriter.hpp: PNG and PPM output of rendered images
+ * IndexedMesh.hpp: Welding of triangle soups into indexed meshes
+ * JobScheduler.hpp: Cancellable, prioritized extraction jobs
+ * ChunkedMesh.hpp: Spatial chunks of a mesh and their frustum culling
+ * Components.hpp: Connected components and culling of small ones
+ * Daemon.hpp: Extraction service on a Unix domain socket
+ * MeshCache.hpp: Persistent on-disk cache of extracted meshes
+ * MeshOptimizer.hpp: Vertex cache and vertex fetch reordering of indexed meshes
+ * MeshStream.hpp: Binary mesh streams between processes
+ * OutOfCore.hpp: Brick-by-brick extraction of grids larger than memory
+ * PLYWriter.hpp: PLY output
+ * RayCaster.hpp: Mesh-free ray-cast previews of an isosurface
+ * RegionOfInterest.hpp: Finer re-extraction of a sub-box of a mesh
+ * SampleGrid.hpp: Bricked, Morton-ordered storage of grid samples
+ * Shard.hpp: Extraction split across worker processes
+ * SharedMesh.hpp: Zero-copy mesh hand-off to a viewer through shared memory
+ * SoftwareRenderer.hpp: Multithreaded CPU rasterizer for headless rendering
+ * SparseGrid.hpp: Narrow-band sparse storage of field samples
+ * SurfaceNets.hpp: The Surface Nets kernel, the dual alternative to marching cubes
+ * TimeVarying.hpp: Incremental extraction of time-varying fields
+ * Trace.hpp: Scoped timers and counters with Chrome trace export
+ */
+
+#ifndef ISOSURFACE_HPP
+#define ISOSURFACE_HPP
+
+#include "Fields.hpp"
+#include "Mesh.hpp"
+#include "MarchingCubes.hpp"
+#include "IsoSurfaceExtractor.hpp"
+#include "Batch.hpp"
+#include "CSGScene.hpp"
+#include "ImageWriter.hpp"
+#include "IndexedMesh.hpp"
+#include "JobScheduler.hpp"
+#include "ChunkedMesh.hpp"
+#include "Components.hpp"
+#include "Daemon.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshStream.hpp"
+#include "OutOfCore.hpp"
+#include "PLYWriter.hpp"
+#include "RayCaster.hpp"
+#include "RegionOfInterest.hpp"
+#include "SampleGrid.hpp"
+#include "Shard.hpp"
+#include "SharedMesh.hpp"
+#include "SoftwareRenderer.hpp"
+#include "SparseGrid.hpp"
+#include "SurfaceNets.hpp"
+#include "TimeVarying.hpp"
+#include "Trace.hpp"
+
+#endif // ISOSURFACE_HPP
@@ -0,0 +1,197 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file IsoSurfaceExtractor.cpp
+ *
+ * @brief Implementation of the isosurface library entry point.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+#include "IsoSurfaceExtractor.hpp"
+#include "MeshCache.hpp"
+#include "SurfaceNets.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+
+IsoSurfaceExtractor::IsoSurfaceExtractor(const ScalarField& field, const std::string& fieldId, const Grid& grid, const ExtractionOptions& options) :
+field(field), fieldId(fieldId), grid(grid), options(options) {}
+
+
+std::string IsoSurfaceExtractor::cacheKey(float isovalue) const {
+    std::string key = meshCacheKey(fieldId, isovalue, grid.minx, grid.maxx, grid.miny, grid.maxy, grid.minz, grid.maxz, grid.stepsize);
+    if (options.engine != ExtractionEngine::MarchingCubes) key += std::string(" kernel=") + extractionEngineName(options.engine);
+    return key;
+}
+
+
+bool IsoSurfaceExtractor::extractChunks(float isovalue, const ChunkCallback& onChunk, MeshStats* stats) const {
+    bool cached = options.useCache && !fieldId.empty();
+    std::string key;
+
+    if (cached) {
+        key = cacheKey(isovalue);
+        MappedMesh mesh;
+        if (meshCacheLookup(options.cacheDirectory, key, mesh)) {
+            if (options.cacheHit) options.cacheHit(meshCachePath(options.cacheDirectory, key));
+            onChunk(mesh.vertices(), mesh.normals(), mesh.floatCount());
+            if (stats) stats->add(mesh.vertices(), mesh.floatCount());
+            if (options.progress) options.progress(1, 1);
+            return true;
+        }
+    }
+
+    // Surface Nets joins cells of neighbouring slabs, so its mesh is delivered whole
+    if (options.engine == ExtractionEngine::SurfaceNets) {
+        Mesh mesh;
+        bool ok = surface_nets(field, grid, isovalue, mesh, options.threads, options.progress, options.cancel);
+        if (ok) onChunk(mesh.vertices.data(), mesh.normals.data(), mesh.vertices.size());
+        if (ok && stats) stats->merge(mesh.stats);
+        if (ok && cached) meshCacheStore(options.cacheDirectory, options.cacheMaxBytes, key, mesh.vertices, mesh.normals);
+        return ok;
+    }
+
+    // Keep a copy of the mesh for the cache while streaming the slabs out
+    Mesh full;
+    bool ok = marching_cubes_slabs(field, grid, isovalue, [&](size_t, const std::vector<float>& vertices, const std::vector<float>& normals) {
+        onChunk(vertices.data(), normals.data(), vertices.size());
+        if (cached) {
+            full.vertices.insert(full.vertices.end(), vertices.begin(), vertices.end());
+            full.normals.insert(full.normals.end(), normals.begin(), normals.end());
+        }
+    }, options.progress, options.cancel, stats);
+
+    if (ok && cached) meshCacheStore(options.cacheDirectory, options.cacheMaxBytes, key, full.vertices, full.normals);
+    return ok;
+}
+
+
+Mesh IsoSurfaceExtractor::extract(float isovalue) const {
+    Mesh mesh;
+    if (!options.twoPass) {
+        bool ok = extractChunks(isovalue, [&](const float* vertices, const float* normals, size_t count) {
+            mesh.vertices.insert(mesh.vertices.end(), vertices, vertices + count);
+            mesh.normals.insert(mesh.normals.end(), normals, normals + count);
+        }, &mesh.stats);
+
+        // The slabs streamed before a cancellation are only part of the surface
+        if (!ok) mesh.clear();
+        return mesh;
+    }
+
+    bool cached = options.useCache && !fieldId.empty();
+    std::string key;
+    if (cached) {
+        key = cacheKey(isovalue);
+        MappedMesh mapped;
+        if (meshCacheLookup(options.cacheDirectory, key, mapped)) {
+            if (options.cacheHit) options.cacheHit(meshCachePath(options.cacheDirectory, key));
+            mesh.vertices.assign(mapped.vertices(), mapped.vertices() + mapped.floatCount());
+            mesh.normals.assign(mapped.normals(), mapped.normals() + mapped.floatCount());
+            mesh.stats.add(mesh.vertices.data(), mesh.vertices.size());
+            if (options.progress) options.progress(1, 1);
+            return mesh;
+        }
+    }
+
+    bool ok;
+    if (options.engine == ExtractionEngine::SurfaceNets) ok = surface_nets(field, grid, isovalue, mesh, options.threads, options.progress, options.cancel);
+    else ok = marching_cubes_two_pass(field, grid, isovalue, mesh, options.threads, options.progress, options.cancel);
+    if (ok && cached) meshCacheStore(options.cacheDirectory, options.cacheMaxBytes, key, mesh.vertices, mesh.normals);
+    return mesh;
+}
+
+
+bool IsoSurfaceExtractor::extractBricks(float isovalue, const float eye[3], const ChunkCallback& onChunk, MeshStats* stats) const {
+    // Surface Nets joins cells across bricks, so its mesh is delivered whole
+    if (options.engine == ExtractionEngine::SurfaceNets) return extractChunks(isovalue, onChunk, stats);
+
+    // Bricks finish out of grid order, so their meshes are served from the cache but never stored in it
+    if (options.useCache && !fieldId.empty()) {
+        std::string key = cacheKey(isovalue);
+        MappedMesh mesh;
+        if (meshCacheLookup(options.cacheDirectory, key, mesh)) {
+            if (options.cacheHit) options.cacheHit(meshCachePath(options.cacheDirectory, key));
+            onChunk(mesh.vertices(), mesh.normals(), mesh.floatCount());
+            if (stats) stats->add(mesh.vertices(), mesh.floatCount());
+            if (options.progress) options.progress(1, 1);
+            return true;
+        }
+    }
+
+    const GridAxes axes = gridAxes(grid);
+    const size_t side = std::max<size_t>(1, options.brickCells);
+    std::vector<CellBox> bricks;
+    for (size_t i = 0; i < axes.nx(); i += side) {
+        for (size_t j = 0; j < axes.ny(); j += side) {
+            for (size_t k = 0; k < axes.nz(); k += side) {
+                bricks.push_back({i, std::min(axes.nx(), i + side), j, std::min(axes.ny(), j + side), k, std::min(axes.nz(), k + side)});
+            }
+        }
+    }
+
+    // Nearest first: by the distance from the eye to the box, then to its centre
+    std::vector<std::pair<float, float>> distances;
+    for (const CellBox& box : bricks) {
+        const float lo[3] = {axes.xs[box.i0], axes.ys[box.j0], axes.zs[box.k0]};
+        const float hi[3] = {axes.xs[box.i1], axes.ys[box.j1], axes.zs[box.k1]};
+        float outside = 0.0f, centre = 0.0f;
+        for (int a = 0; a < 3; ++a) {
+            float d = std::max(std::max(lo[a] - eye[a], eye[a] - hi[a]), 0.0f);
+            float c = 0.5f * (lo[a] + hi[a]) - eye[a];
+            outside += d * d;
+            centre += c * c;
+        }
+        distances.push_back({outside, centre});
+    }
+    std::vector<size_t> order(bricks.size());
+    for (size_t b = 0; b < order.size(); ++b) order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return distances[a] < distances[b]; });
+
+    // Bricks are claimed in that order; their chunks are handed over one at a time as they come
+    std::mutex deliver;
+    std::atomic<size_t> completed(0);
+    ThreadPool::shared().parallelFor(order.size(), [&](size_t n) {
+        if (options.cancel.cancelled()) return;
+        TRACE_SCOPE("view_brick");
+        MeshStats brickStats;
+        bool ok = marching_cubes_brick(field, axes, bricks[order[n]], isovalue, 1 << 16, [&](const float* vertices, const float* normals, size_t count) {
+            std::lock_guard<std::mutex> lock(deliver);
+            onChunk(vertices, normals, count);
+        }, options.cancel, &brickStats);
+        if (stats) {
+            std::lock_guard<std::mutex> lock(deliver);
+            stats->merge(brickStats);
+        }
+        if (ok) {
+            size_t done = ++completed;
+            if (options.progress) options.progress(done, order.size());
+        }
+    }, options.threads);
+    return completed.load() == order.size();
+}
+
+
+std::vector<Mesh> IsoSurfaceExtractor::extract(const std::vector<float>& isovalues) const {
+    std::vector<Mesh> meshes;
+    meshes.reserve(isovalues.size());
+    for (float isovalue : isovalues) meshes.push_back(extract(isovalue));
+    return meshes;
+}
+
+
+bool IsoSurfaceExtractor::refine(Mesh& mesh, float isovalue, const RegionOfInterest& roi, unsigned refinement) const {
+    return refineRegion(field, grid, isovalue, roi, refinement, mesh, options.threads);
+}
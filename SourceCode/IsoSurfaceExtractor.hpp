@@ -0,0 +1,143 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file IsoSurfaceExtractor.hpp
+ *
+ * @brief The entry point of the isosurface library.
+ * An IsoSurfaceExtractor binds a scalar field to a grid and a set of
+ * options, and extracts the isosurface of any isovalue from it, either as a
+ * complete mesh or as a stream of chunks delivered while the extraction
+ * runs. It has no OpenGL dependency, so it can be embedded in any program.
+ *
+ * Example:
+ *
+ * IsoSurfaceExtractor extractor(f4, "f4", Grid::cube(-5, 5, 0.1f));
+ * Mesh torus = extractor.extract(0.0f);
+ */
+
+#ifndef ISOSURFACEEXTRACTOR_HPP
+#define ISOSURFACEEXTRACTOR_HPP
+
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Fields.hpp"
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+#include "RegionOfInterest.hpp"
+
+/***
+ * ExtractionOptions: how an extraction is run
+*/
+struct ExtractionOptions {
+    bool useCache = false;                                     // Serve and store meshes through the mesh cache
+    std::string cacheDirectory = "MeshCache";                  // Where cached meshes are stored
+    unsigned long long cacheMaxBytes = 2ULL << 30;             // Evict least recently used meshes above this size
+    bool twoPass = true;                                       // Count then emit into an exact allocation (extract only)
+    ExtractionEngine engine = ExtractionEngine::MarchingCubes; // Marching cubes or Surface Nets
+    unsigned threads = 0;                                      // Threads for the two-pass kernel, 0 for all
+    size_t brickCells = 32;                                    // Cells per side of the bricks of extractBricks
+    ProgressCallback progress;                                 // Receives the completed and total slabs
+    std::function<void(const std::string&)> cacheHit;          // Receives the cache file a mesh was served from
+    CancellationToken cancel;                                  // Stops the extraction between two slabs or bricks
+};
+
+/***
+ * IsoSurfaceExtractor: extracts isosurfaces of one field over one grid
+*/
+class IsoSurfaceExtractor {
+
+private:
+
+    ScalarField field;
+    std::string fieldId;
+    Grid grid;
+    ExtractionOptions options;
+
+public:
+
+    /***
+     * @brief Construct an extractor.
+     * @param field The scalar field
+     * @param fieldId Identity of the field (its name or expression text); the
+     * cache is only used for fields with a non-empty identity
+     * @param grid The sampled box and step size
+     * @param options Extraction options
+    */
+    IsoSurfaceExtractor(const ScalarField& field, const std::string& fieldId, const Grid& grid, const ExtractionOptions& options = ExtractionOptions());
+
+    /***
+     * @brief Extract one isosurface, delivering it in chunks as it is produced.
+     * On a cache hit the whole mesh is delivered as one chunk straight from
+     * the memory-mapped cache file, and so is a Surface Nets mesh.
+     * @param isovalue Isovalue
+     * @param onChunk Callback receiving every chunk, in order
+     * @param[in,out] stats Optional statistics the triangles are added to as they are emitted
+     * (a cached mesh is read once more to compute them)
+     * @return bool True if the extraction completed
+    */
+    bool extractChunks(float isovalue, const ChunkCallback& onChunk, MeshStats* stats = nullptr) const;
+
+    /***
+     * @brief Extract one isosurface in bricks, the bricks nearest a point first.
+     * Bricks of options.brickCells cells per side are claimed by the shared
+     * thread pool in order of their distance from the point, so the part of
+     * the surface nearest the camera arrives first; the chunks of the bricks
+     * are handed to onChunk one at a time as they are produced. Surface Nets
+     * meshes and cache hits are delivered whole, as by extractChunks.
+     * @param isovalue Isovalue
+     * @param eye The point, usually the camera position
+     * @param onChunk Callback receiving every chunk
+     * @param[in,out] stats Optional statistics the triangles are added to as they are emitted
+     * @return bool True if every brick was extracted (false once cancelled)
+    */
+    bool extractBricks(float isovalue, const float eye[3], const ChunkCallback& onChunk, MeshStats* stats = nullptr) const;
+
+    /***
+     * @brief Extract one isosurface as a complete mesh.
+     * With options.twoPass the mesh is produced by the parallel two-pass
+     * kernel, whose peak memory is the mesh itself plus about 9 bytes per
+     * active cell. Surface Nets always runs in parallel. The area, volume and
+     * bounds of the mesh are accumulated in mesh.stats by the kernel as it
+     * emits the triangles.
+     * @param isovalue Isovalue
+     * @return Mesh The isosurface, empty if options.cancel was cancelled
+    */
+    Mesh extract(float isovalue) const;
+
+    /***
+     * @brief Extract several isosurfaces of the same field.
+     * @param isovalues Isovalues
+     * @return std::vector<Mesh> One mesh per isovalue, in the same order
+    */
+    std::vector<Mesh> extract(const std::vector<float>& isovalues) const;
+
+    /***
+     * @brief Re-extract a region of a mesh of this field and grid at a finer step.
+     * See refineRegion; the cost scales with the volume of the region.
+     * @param[in,out] mesh A mesh extracted at isovalue
+     * @param isovalue Isovalue the mesh was extracted at
+     * @param roi The region to refine
+     * @param refinement Fine cells per grid cell along each axis
+     * @return bool True if the region was refined
+    */
+    bool refine(Mesh& mesh, float isovalue, const RegionOfInterest& roi, unsigned refinement) const;
+
+    /***
+     * @brief The mesh cache key of an isovalue of this field and grid.
+     * Surface Nets meshes have keys of their own.
+    */
+    std::string cacheKey(float isovalue) const;
+};
+
+#endif // ISOSURFACEEXTRACTOR_HPP
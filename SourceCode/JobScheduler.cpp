@@ -0,0 +1,147 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file JobScheduler.cpp
+ *
+ * @brief Implementation of the job scheduler.
+ */
+
+#include <algorithm>
+
+#include "JobScheduler.hpp"
+#include "Trace.hpp"
+
+/***
+ * JobRecord: a job and its state, shared by the scheduler and the handles
+*/
+struct JobRecord {
+    JobFunction work;
+    int priority;
+    uint64_t order;
+    CancellationToken cancel;
+    std::mutex mutex;
+    std::condition_variable finished;
+    JobState state = JobState::Queued;
+};
+
+/***
+ * @brief Heap order: the highest priority, then the earliest submitted, on top.
+*/
+static bool runsAfter(const std::shared_ptr<JobRecord>& a, const std::shared_ptr<JobRecord>& b) {
+    if (a->priority != b->priority) return a->priority < b->priority;
+    return a->order > b->order;
+}
+
+
+void JobHandle::cancel() const {
+    if (!job) return;
+    job->cancel.cancel();
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (job->state == JobState::Queued) {
+        job->state = JobState::Cancelled;
+        job->finished.notify_all();
+    }
+}
+
+
+JobState JobHandle::state() const {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    return job->state;
+}
+
+
+bool JobHandle::finished() const {
+    JobState now = state();
+    return now != JobState::Queued && now != JobState::Running;
+}
+
+
+JobState JobHandle::wait() const {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&]() { return job->state != JobState::Queued && job->state != JobState::Running; });
+    return job->state;
+}
+
+
+JobScheduler::JobScheduler(unsigned count) {
+    for (unsigned i = 0; i < std::max(1u, count); ++i) threads.emplace_back([this]() { jobLoop(); });
+}
+
+
+JobScheduler::~JobScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (const std::shared_ptr<JobRecord>& job : queue) JobHandle(job).cancel();
+        for (const std::shared_ptr<JobRecord>& job : running) JobHandle(job).cancel();
+        queue.clear();
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) thread.join();
+}
+
+
+void JobScheduler::jobLoop() {
+    for (;;) {
+        std::shared_ptr<JobRecord> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            std::pop_heap(queue.begin(), queue.end(), runsAfter);
+            job = queue.back();
+            queue.pop_back();
+
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+            if (job->state == JobState::Cancelled) continue;
+            job->state = JobState::Running;
+            running.push_back(job);
+        }
+
+        bool ok;
+        {
+            TRACE_SCOPE("job");
+            ok = job->work(job->cancel);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running.erase(std::find(running.begin(), running.end(), job));
+        }
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (ok) job->state = JobState::Done;
+        else job->state = job->cancel.cancelled() ? JobState::Cancelled : JobState::Failed;
+        job->work = nullptr;
+        job->finished.notify_all();
+    }
+}
+
+
+JobHandle JobScheduler::submit(const JobFunction& work, int priority, const CancellationToken& cancel) {
+    std::shared_ptr<JobRecord> job = std::make_shared<JobRecord>();
+    job->work = work;
+    job->priority = priority;
+    job->cancel = cancel;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job->order = submitted++;
+        queue.push_back(job);
+        std::push_heap(queue.begin(), queue.end(), runsAfter);
+    }
+    wake.notify_one();
+    return JobHandle(job);
+}
+
+
+size_t JobScheduler::queued() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
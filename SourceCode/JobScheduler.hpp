@@ -0,0 +1,145 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file JobScheduler.hpp
+ *
+ * @brief Cancellable, prioritized jobs on a few job threads.
+ * A job is a function taking a CancellationToken. Queued jobs run highest
+ * priority first (in submission order among equals) on the scheduler's job
+ * threads, while the work inside a job is spread over the shared thread
+ * pool as usual. Cancelling a queued job drops it; cancelling a running job
+ * sets its token, which the extraction kernels check before every slab and
+ * brick, so the job ends within the time of one of them. Unlike the future
+ * of std::async, a handle can be dropped without waiting for the job.
+ *
+ * Example:
+ *
+ * JobScheduler jobs;
+ * ExtractionOptions options;
+ * JobHandle job = jobs.submit([&](const CancellationToken&) { ... }, 1, options.cancel);
+ * job.cancel();
+ * job.wait();
+ */
+
+#ifndef JOBSCHEDULER_HPP
+#define JOBSCHEDULER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MarchingCubes.hpp"
+
+// Runs on a job thread; returns false if the job failed or stopped early
+typedef std::function<bool(const CancellationToken&)> JobFunction;
+
+/***
+ * JobState: where a job is in its life
+*/
+enum class JobState {
+    Queued,
+    Running,
+    Done,       // Returned true
+    Failed,     // Returned false without being cancelled
+    Cancelled   // Dropped from the queue, or returned false after being cancelled
+};
+
+struct JobRecord;
+
+/***
+ * JobHandle: a reference to a submitted job
+*/
+class JobHandle {
+
+private:
+
+    std::shared_ptr<JobRecord> job;
+
+public:
+
+    JobHandle() {}
+    explicit JobHandle(std::shared_ptr<JobRecord> job) : job(std::move(job)) {}
+
+    bool valid() const { return job != nullptr; }
+
+    /***
+     * @brief Cancel the job: a queued job never runs, a running one sees its token set.
+    */
+    void cancel() const;
+
+    JobState state() const;
+
+    /***
+     * @brief True once the job is Done, Failed or Cancelled.
+    */
+    bool finished() const;
+
+    /***
+     * @brief Wait until the job has finished.
+     * @return JobState The final state
+    */
+    JobState wait() const;
+};
+
+/***
+ * JobScheduler: a priority queue of jobs drained by a few job threads
+*/
+class JobScheduler {
+
+private:
+
+    std::vector<std::thread> threads;
+    std::vector<std::shared_ptr<JobRecord>> queue;   // a heap, highest priority on top
+    std::vector<std::shared_ptr<JobRecord>> running;
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint64_t submitted = 0;
+    bool stopping = false;
+
+    void jobLoop();
+
+public:
+
+    /***
+     * @brief Start the job threads.
+     * @param threads Jobs running at once
+    */
+    explicit JobScheduler(unsigned threads = 1);
+
+    /***
+     * @brief Cancel every queued and running job and join the job threads.
+    */
+    ~JobScheduler();
+
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    /***
+     * @brief Queue a job.
+     * @param work The job
+     * @param priority Higher priorities run first
+     * @param cancel The token passed to the job, e.g. the one of its ExtractionOptions
+     * @return JobHandle A handle to cancel or wait for the job
+    */
+    JobHandle submit(const JobFunction& work, int priority = 0, const CancellationToken& cancel = CancellationToken());
+
+    /***
+     * @brief Jobs waiting in the queue (including cancelled ones not yet dropped).
+    */
+    size_t queued();
+};
+
+#endif // JOBSCHEDULER_HPP
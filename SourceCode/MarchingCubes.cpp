@@ -0,0 +1,709 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MarchingCubes.cpp
+ *
+ * @brief Implementation of the marching cubes extraction kernel.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+
+#include <glm/glm.hpp>
+
+#include "Constants.hpp"
+#include "MarchingCubes.hpp"
+#include "SampleGrid.hpp"
+#include "SparseGrid.hpp"
+#include "SurfaceNets.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include "TriTable.hpp"
+
+
+const char* extractionEngineName(ExtractionEngine engine) {
+    return engine == ExtractionEngine::SurfaceNets ? "surface-nets" : "marching-cubes";
+}
+
+
+bool parseExtractionEngine(const std::string& name, ExtractionEngine& engine) {
+    if (name == "marching-cubes" || name == "mc") engine = ExtractionEngine::MarchingCubes;
+    else if (name == "surface-nets" || name == "sn") engine = ExtractionEngine::SurfaceNets;
+    else return false;
+    return true;
+}
+
+
+std::vector<float> gridAxis(float min, float max, float stepsize) {
+    std::vector<float> corners;
+    float v = min;
+    for ( ; v < max; v += stepsize) corners.push_back(v);
+    corners.push_back(v);
+    return corners;
+}
+
+
+GridAxes gridAxes(const Grid& grid) {
+    GridAxes axes;
+    axes.xs = gridAxis(grid.minx, grid.maxx, grid.stepsize);
+    axes.ys = gridAxis(grid.miny, grid.maxy, grid.stepsize);
+    axes.zs = gridAxis(grid.minz, grid.maxz, grid.stepsize);
+    axes.stepsize = grid.stepsize;
+    return axes;
+}
+
+
+const unsigned char* marching_cubes_triangle_counts() {
+    static const std::vector<unsigned char> counts = []() {
+        std::vector<unsigned char> table(256);
+        for (int which = 0; which < 256; ++which) {
+            int n = 0;
+            while (n < 16 && marching_cubes_lut[which][n] >= 0) n++;
+            table[which] = n / 3;
+        }
+        return table;
+    }();
+    return counts.data();
+}
+
+
+std::vector<float> compute_normals(const std::vector<float>& vertices) {
+    const size_t num_vertices = vertices.size() / 3;
+    std::vector<float> normals(num_vertices * 3);
+    const size_t num_triangles = num_vertices / 3;
+
+    for (size_t i = 0; i < num_triangles; ++i) {
+        size_t idx = i * 9;
+
+        // Due to winding order, the direction of the normal is set by the order of vertices
+        glm::vec3 v1 = {vertices[idx], vertices[idx + 1], vertices[idx + 2]};
+        glm::vec3 v2 = {vertices[idx + 3], vertices[idx + 4], vertices[idx + 5]};
+        glm::vec3 v3 = {vertices[idx + 6], vertices[idx + 7], vertices[idx + 8]};
+
+        glm::vec3 diff1 = v1 - v2;
+        glm::vec3 diff2 = v1 - v3;
+        glm::vec3 norm = glm::normalize(glm::cross(diff1, diff2));
+
+        // Store the computed normal for each vertex of the triangle
+        for (size_t j = 0; j < 3; ++j) {
+            size_t normal_idx = i * 9 + j * 3;
+            normals[normal_idx] = norm.x;
+            normals[normal_idx + 1] = norm.y;
+            normals[normal_idx + 2] = norm.z;
+        }
+    }
+
+    return normals;
+}
+
+
+bool marching_cubes_slabs(const ScalarField& f, const Grid& grid, float isoval, const SlabCallback& onSlab, const ProgressCallback& progress, const CancellationToken& cancel, MeshStats* stats) {
+    const float minx = grid.minx, maxx = grid.maxx;
+    const float miny = grid.miny, maxy = grid.maxy;
+    const float minz = grid.minz, maxz = grid.maxz;
+    const float stepsize = grid.stepsize;
+
+    std::vector<float> tempVertices;
+    std::vector<float> tempNormals;
+
+    // Corner coordinates along y and z, accumulated the same way as the x loop
+    std::vector<float> ys = gridAxis(miny, maxy, stepsize);
+    std::vector<float> zs = gridAxis(minz, maxz, stepsize);
+    const size_t ny = ys.size() - 1;
+    const size_t nz = zs.size() - 1;
+    const size_t totalSlabs = gridAxis(minx, maxx, stepsize).size() - 1;
+
+    // Field samples on the near (x) and far (x + stepsize) planes of the current slab
+    std::vector<float> nearPlane((ny + 1) * (nz + 1));
+    std::vector<float> farPlane((ny + 1) * (nz + 1));
+    std::vector<unsigned char> cases(ny * nz);
+
+	float x = minx;
+	float ftl, ftr, fbr, fbl, ntl, ntr, nbr, nbl;
+	int which = 0;
+	int* verts;
+    size_t slab = 0;
+
+    if (totalSlabs > 0) {
+        TRACE_SLAB_SCOPE("field", -1);
+        for (size_t j = 0; j <= ny; ++j) {
+            for (size_t k = 0; k <= nz; ++k) {
+                nearPlane[j * (nz + 1) + k] = f(x, ys[j], zs[k]);
+            }
+        }
+    }
+
+	for ( ; x < maxx; x += stepsize, ++slab) {
+        if (cancel.cancelled()) return false;
+        float xstep = x + stepsize;
+
+        {
+            TRACE_SLAB_SCOPE("field", slab);
+            for (size_t j = 0; j <= ny; ++j) {
+                for (size_t k = 0; k <= nz; ++k) {
+                    farPlane[j * (nz + 1) + k] = f(xstep, ys[j], zs[k]);
+                }
+            }
+        }
+
+        {
+            TRACE_SLAB_SCOPE("classify", slab);
+            for (size_t j = 0; j < ny; ++j) {
+                for (size_t k = 0; k < nz; ++k) {
+                    size_t c = j * (nz + 1) + k;
+
+                    // Test the cube
+                    ntl = nearPlane[c + nz + 2];
+                    ntr = farPlane[c + nz + 2];
+                    nbr = farPlane[c + 1];
+                    nbl = nearPlane[c + 1];
+                    ftl = nearPlane[c + nz + 1];
+                    ftr = farPlane[c + nz + 1];
+                    fbr = farPlane[c];
+                    fbl = nearPlane[c];
+
+				    which = 0;
+
+                    if (ntl < isoval) which |= NEAR_TOP_LEFT;
+                    if (ntr < isoval) which |= NEAR_TOP_RIGHT;
+                    if (nbr < isoval) which |= NEAR_BOTTOM_RIGHT;
+                    if (nbl < isoval) which |= NEAR_BOTTOM_LEFT;
+                    if (ftl < isoval) which |= FAR_TOP_LEFT;
+                    if (ftr < isoval) which |= FAR_TOP_RIGHT;
+                    if (fbr < isoval) which |= FAR_BOTTOM_RIGHT;
+                    if (fbl < isoval) which |= FAR_BOTTOM_LEFT;
+
+                    cases[j * nz + k] = which;
+                }
+            }
+        }
+
+        {
+            TRACE_SLAB_SCOPE("emit", slab);
+            for (size_t j = 0; j < ny; ++j) {
+                for (size_t k = 0; k < nz; ++k) {
+				    verts = marching_cubes_lut[cases[j * nz + k]];
+                    if (verts[0] < 0) continue;
+
+                    // Grow the holder explicitly so that reallocations show up in the trace
+                    if (tempVertices.size() + 45 > tempVertices.capacity()) {
+                        TRACE_SLAB_SCOPE("grow", slab);
+                        TRACE_COUNT("grow_reallocs", 1);
+                        tempVertices.reserve(2 * tempVertices.capacity() + 45);
+                    }
+
+                    // Generate vertices
+                    for (int i = 0; verts[i] >= 0; i += 3) {
+                        for (int v = 0; v < 3; ++v) {
+                            tempVertices.emplace_back(x + stepsize * vertTable[verts[i + v]][0]);
+						    tempVertices.emplace_back(ys[j] + stepsize * vertTable[verts[i + v]][1]);
+						    tempVertices.emplace_back(zs[k] + stepsize * vertTable[verts[i + v]][2]);
+                        }
+                        if (stats) stats->addTriangle(&tempVertices[tempVertices.size() - 9]);
+                    }
+                }
+			}
+		}
+        TRACE_COUNT("cells", ny * nz);
+        TRACE_COUNT("field_evals", (ny + 1) * (nz + 1));
+        TRACE_COUNT("triangles", tempVertices.size() / 9);
+
+        {
+            TRACE_SLAB_SCOPE("compute_normals", slab);
+            tempNormals = compute_normals(tempVertices);
+        }
+
+        {
+            TRACE_SLAB_SCOPE("merge", slab);
+            onSlab(slab, tempVertices, tempNormals);
+        }
+
+        // Clear our temporary holders
+        tempVertices.clear();
+        tempNormals.clear();
+        nearPlane.swap(farPlane);
+
+        if (progress) progress(slab + 1, totalSlabs);
+	}
+
+	return true;
+}
+
+
+// The active (triangle producing) cells of one block of slabs, found by the count pass
+struct ActiveCells {
+    std::vector<size_t> cells;   // (slab - first slab) * ny * nz + j * nz + k
+    std::vector<unsigned char> cases;
+    size_t triangles = 0;
+    MeshStats stats;             // Of the triangles the block emits
+};
+
+
+bool marching_cubes_two_pass(const ScalarField& f, const Grid& grid, float isoval, Mesh& mesh, unsigned threads, const ProgressCallback& progress, const CancellationToken& cancel) {
+    const float stepsize = grid.stepsize;
+    const std::vector<float> xs = gridAxis(grid.minx, grid.maxx, stepsize);
+    const std::vector<float> ys = gridAxis(grid.miny, grid.maxy, stepsize);
+    const std::vector<float> zs = gridAxis(grid.minz, grid.maxz, stepsize);
+    const size_t nx = xs.size() - 1;
+    const size_t ny = ys.size() - 1;
+    const size_t nz = zs.size() - 1;
+    const unsigned char* triangleCounts = marching_cubes_triangle_counts();
+
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+
+    // Blocks of consecutive slabs, a few per thread for load balance
+    const size_t slabsPerBlock = std::max<size_t>(1, nx / (4 * threads));
+    const size_t blocks = (nx + slabsPerBlock - 1) / slabsPerBlock;
+
+    std::vector<ActiveCells> active(blocks);
+    std::atomic<size_t> completed(0);
+
+    // Pass one: sample and classify every cell, keeping only the cells that produce triangles
+    pool.parallelFor(blocks, [&](size_t b) {
+        const size_t first = b * slabsPerBlock;
+        const size_t last = std::min(nx, first + slabsPerBlock);
+        TRACE_SLAB_SCOPE("count", first);
+
+        std::vector<float> nearPlane((ny + 1) * (nz + 1));
+        std::vector<float> farPlane((ny + 1) * (nz + 1));
+        for (size_t j = 0; j <= ny; ++j) {
+            for (size_t k = 0; k <= nz; ++k) {
+                nearPlane[j * (nz + 1) + k] = f(xs[first], ys[j], zs[k]);
+            }
+        }
+
+        ActiveCells& cells = active[b];
+        for (size_t i = first; i < last; ++i) {
+            if (cancel.cancelled()) return;
+            for (size_t j = 0; j <= ny; ++j) {
+                for (size_t k = 0; k <= nz; ++k) {
+                    farPlane[j * (nz + 1) + k] = f(xs[i + 1], ys[j], zs[k]);
+                }
+            }
+
+            for (size_t j = 0; j < ny; ++j) {
+                for (size_t k = 0; k < nz; ++k) {
+                    size_t c = j * (nz + 1) + k;
+                    int which = 0;
+                    if (nearPlane[c + nz + 2] < isoval) which |= NEAR_TOP_LEFT;
+                    if (farPlane[c + nz + 2] < isoval) which |= NEAR_TOP_RIGHT;
+                    if (farPlane[c + 1] < isoval) which |= NEAR_BOTTOM_RIGHT;
+                    if (nearPlane[c + 1] < isoval) which |= NEAR_BOTTOM_LEFT;
+                    if (nearPlane[c + nz + 1] < isoval) which |= FAR_TOP_LEFT;
+                    if (farPlane[c + nz + 1] < isoval) which |= FAR_TOP_RIGHT;
+                    if (farPlane[c] < isoval) which |= FAR_BOTTOM_RIGHT;
+                    if (nearPlane[c] < isoval) which |= FAR_BOTTOM_LEFT;
+
+                    if (triangleCounts[which] > 0) {
+                        cells.cells.push_back((i - first) * ny * nz + j * nz + k);
+                        cells.cases.push_back(which);
+                        cells.triangles += triangleCounts[which];
+                    }
+                }
+            }
+            nearPlane.swap(farPlane);
+        }
+
+        TRACE_COUNT("cells", (last - first) * ny * nz);
+        TRACE_COUNT("active_cells", cells.cells.size());
+        if (progress) progress(completed += last - first, 2 * nx);
+    }, threads);
+
+    mesh.clear();
+    if (cancel.cancelled()) return false;
+
+    // Prefix sum of the per-block triangle counts gives every block its output offset
+    std::vector<size_t> offsets(blocks + 1, 0);
+    for (size_t b = 0; b < blocks; ++b) offsets[b + 1] = offsets[b] + active[b].triangles;
+
+    mesh.vertices.resize(offsets[blocks] * 9);
+    mesh.normals.resize(offsets[blocks] * 9);
+    TRACE_COUNT("triangles", offsets[blocks]);
+
+    // Pass two: every block writes its triangles straight into its own range of the output
+    pool.parallelFor(blocks, [&](size_t b) {
+        const size_t first = b * slabsPerBlock;
+        TRACE_SLAB_SCOPE("emit", first);
+
+        float* vertices = mesh.vertices.data() + offsets[b] * 9;
+        float* normals = mesh.normals.data() + offsets[b] * 9;
+        ActiveCells& cells = active[b];
+        size_t slab = SIZE_MAX;
+
+        for (size_t c = 0; c < cells.cells.size(); ++c) {
+            const size_t i = first + cells.cells[c] / (ny * nz);
+            if (i != slab) {
+                if (cancel.cancelled()) return;
+                slab = i;
+            }
+            const size_t j = (cells.cells[c] / nz) % ny;
+            const size_t k = cells.cells[c] % nz;
+            const int* verts = marching_cubes_lut[cells.cases[c]];
+
+            for (int t = 0; verts[t] >= 0; t += 3) {
+                glm::vec3 v[3];
+                for (int n = 0; n < 3; ++n) {
+                    v[n] = glm::vec3(xs[i] + stepsize * vertTable[verts[t + n]][0],
+                                     ys[j] + stepsize * vertTable[verts[t + n]][1],
+                                     zs[k] + stepsize * vertTable[verts[t + n]][2]);
+                }
+
+                // Same winding and normal as compute_normals
+                glm::vec3 norm = glm::normalize(glm::cross(v[0] - v[1], v[0] - v[2]));
+                for (int n = 0; n < 3; ++n) {
+                    *vertices++ = v[n].x;
+                    *vertices++ = v[n].y;
+                    *vertices++ = v[n].z;
+                    *normals++ = norm.x;
+                    *normals++ = norm.y;
+                    *normals++ = norm.z;
+                }
+                cells.stats.addTriangle(vertices - 9);
+            }
+        }
+
+        if (progress) progress(completed += std::min(nx, first + slabsPerBlock) - first, 2 * nx);
+    }, threads);
+
+    // Blocks skipped after a cancellation leave holes, so nothing is kept
+    if (cancel.cancelled()) {
+        mesh.clear();
+        return false;
+    }
+    for (const ActiveCells& cells : active) mesh.stats.merge(cells.stats);
+    return true;
+}
+
+
+size_t marching_cubes_count(const ScalarField& f, const Grid& grid, float isoval, unsigned threads, size_t* activeCells) {
+    const GridAxes axes = gridAxes(grid);
+    const size_t nx = axes.nx();
+    const size_t ny = axes.ny();
+    const size_t nz = axes.nz();
+    const unsigned char* triangleCounts = marching_cubes_triangle_counts();
+
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+    const size_t slabsPerBlock = std::max<size_t>(1, nx / (4 * threads));
+    const size_t blocks = (nx + slabsPerBlock - 1) / slabsPerBlock;
+    std::atomic<size_t> triangles(0);
+    std::atomic<size_t> active(0);
+
+    // Pass one of marching_cubes_two_pass, keeping only the totals
+    pool.parallelFor(blocks, [&](size_t b) {
+        const size_t first = b * slabsPerBlock;
+        const size_t last = std::min(nx, first + slabsPerBlock);
+        TRACE_SLAB_SCOPE("count", first);
+
+        std::vector<float> nearPlane((ny + 1) * (nz + 1));
+        std::vector<float> farPlane((ny + 1) * (nz + 1));
+        for (size_t j = 0; j <= ny; ++j) {
+            for (size_t k = 0; k <= nz; ++k) {
+                nearPlane[j * (nz + 1) + k] = f(axes.xs[first], axes.ys[j], axes.zs[k]);
+            }
+        }
+
+        size_t blockTriangles = 0;
+        size_t blockActive = 0;
+        for (size_t i = first; i < last; ++i) {
+            for (size_t j = 0; j <= ny; ++j) {
+                for (size_t k = 0; k <= nz; ++k) {
+                    farPlane[j * (nz + 1) + k] = f(axes.xs[i + 1], axes.ys[j], axes.zs[k]);
+                }
+            }
+
+            for (size_t j = 0; j < ny; ++j) {
+                for (size_t k = 0; k < nz; ++k) {
+                    size_t c = j * (nz + 1) + k;
+                    int which = 0;
+                    if (nearPlane[c + nz + 2] < isoval) which |= NEAR_TOP_LEFT;
+                    if (farPlane[c + nz + 2] < isoval) which |= NEAR_TOP_RIGHT;
+                    if (farPlane[c + 1] < isoval) which |= NEAR_BOTTOM_RIGHT;
+                    if (nearPlane[c + 1] < isoval) which |= NEAR_BOTTOM_LEFT;
+                    if (nearPlane[c + nz + 1] < isoval) which |= FAR_TOP_LEFT;
+                    if (farPlane[c + nz + 1] < isoval) which |= FAR_TOP_RIGHT;
+                    if (farPlane[c] < isoval) which |= FAR_BOTTOM_RIGHT;
+                    if (nearPlane[c] < isoval) which |= FAR_BOTTOM_LEFT;
+
+                    blockTriangles += triangleCounts[which];
+                    blockActive += triangleCounts[which] > 0;
+                }
+            }
+            nearPlane.swap(farPlane);
+        }
+        triangles += blockTriangles;
+        active += blockActive;
+    }, threads);
+
+    if (activeCells) *activeCells = active.load();
+    return triangles.load();
+}
+
+
+/***
+ * @brief Coordinate of a vertex along one axis of a cell.
+ * An offset of 1 is the next corner itself rather than a step past this
+ * one, so the cells on either side of a corner place it identically even
+ * when the corners are not spaced by exactly the step size. On the axes of
+ * gridAxis the two are the same float.
+ * @param corners Corner coordinates of the axis
+ * @param i The cell
+ * @param offset 0, 0.5 or 1, from vertTable
+*/
+static inline float edgeCoordinate(const std::vector<float>& corners, size_t i, float stepsize, float offset) {
+    return offset == 1.0f ? corners[i + 1] : corners[i] + stepsize * offset;
+}
+
+
+bool marching_cubes_brick(const ScalarField& f, const GridAxes& axes, const CellBox& box, float isoval, size_t chunkFloats, const ChunkCallback& onChunk, const CancellationToken& cancel, MeshStats* stats) {
+    const std::vector<float>& xs = axes.xs;
+    const std::vector<float>& ys = axes.ys;
+    const std::vector<float>& zs = axes.zs;
+    const float stepsize = axes.stepsize;
+    const size_t ny = box.j1 - box.j0;
+    const size_t nz = box.k1 - box.k0;
+    chunkFloats = std::max<size_t>(chunkFloats, 45);
+
+    if (box.cellCount() == 0) return true;
+
+    std::vector<float> nearPlane((ny + 1) * (nz + 1));
+    std::vector<float> farPlane((ny + 1) * (nz + 1));
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    vertices.reserve(chunkFloats);
+    normals.reserve(chunkFloats);
+
+    for (size_t j = 0; j <= ny; ++j) {
+        for (size_t k = 0; k <= nz; ++k) {
+            nearPlane[j * (nz + 1) + k] = f(xs[box.i0], ys[box.j0 + j], zs[box.k0 + k]);
+        }
+    }
+
+    for (size_t i = box.i0; i < box.i1; ++i) {
+        if (cancel.cancelled()) return false;
+        TRACE_SLAB_SCOPE("brick_slab", i);
+        for (size_t j = 0; j <= ny; ++j) {
+            for (size_t k = 0; k <= nz; ++k) {
+                farPlane[j * (nz + 1) + k] = f(xs[i + 1], ys[box.j0 + j], zs[box.k0 + k]);
+            }
+        }
+
+        for (size_t j = 0; j < ny; ++j) {
+            for (size_t k = 0; k < nz; ++k) {
+                size_t c = j * (nz + 1) + k;
+                int which = 0;
+                if (nearPlane[c + nz + 2] < isoval) which |= NEAR_TOP_LEFT;
+                if (farPlane[c + nz + 2] < isoval) which |= NEAR_TOP_RIGHT;
+                if (farPlane[c + 1] < isoval) which |= NEAR_BOTTOM_RIGHT;
+                if (nearPlane[c + 1] < isoval) which |= NEAR_BOTTOM_LEFT;
+                if (nearPlane[c + nz + 1] < isoval) which |= FAR_TOP_LEFT;
+                if (farPlane[c + nz + 1] < isoval) which |= FAR_TOP_RIGHT;
+                if (farPlane[c] < isoval) which |= FAR_BOTTOM_RIGHT;
+                if (nearPlane[c] < isoval) which |= FAR_BOTTOM_LEFT;
+
+                const int* verts = marching_cubes_lut[which];
+                if (verts[0] < 0) continue;
+
+                // Hand the buffer over before a cell could overflow it (at most 5 triangles)
+                if (vertices.size() + 45 > chunkFloats) {
+                    onChunk(vertices.data(), normals.data(), vertices.size());
+                    vertices.clear();
+                    normals.clear();
+                }
+
+                for (int t = 0; verts[t] >= 0; t += 3) {
+                    glm::vec3 v[3];
+                    for (int n = 0; n < 3; ++n) {
+                        const float* offset = vertTable[verts[t + n]];
+                        v[n] = glm::vec3(edgeCoordinate(xs, i, stepsize, offset[0]),
+                                         edgeCoordinate(ys, box.j0 + j, stepsize, offset[1]),
+                                         edgeCoordinate(zs, box.k0 + k, stepsize, offset[2]));
+                    }
+
+                    glm::vec3 norm = glm::normalize(glm::cross(v[0] - v[1], v[0] - v[2]));
+                    for (int n = 0; n < 3; ++n) {
+                        vertices.push_back(v[n].x);
+                        vertices.push_back(v[n].y);
+                        vertices.push_back(v[n].z);
+                        normals.push_back(norm.x);
+                        normals.push_back(norm.y);
+                        normals.push_back(norm.z);
+                    }
+                    if (stats) stats->addTriangle(vertices.data() + vertices.size() - 9);
+                }
+            }
+        }
+        TRACE_COUNT("cells", ny * nz);
+        nearPlane.swap(farPlane);
+    }
+
+    if (!vertices.empty()) onChunk(vertices.data(), normals.data(), vertices.size());
+    return true;
+}
+
+
+/***
+ * @brief Emit the triangles of one cell from its eight corner samples.
+ * @param corners Corner c is offset by (c & 1, c >> 1 & 1, c >> 2 & 1) cells from corner (i, j, k)
+ * @param[out] mesh Mesh the triangles are appended to, and added to mesh.stats
+*/
+static void emitSampledCell(const GridAxes& axes, size_t i, size_t j, size_t k, const float* corners, float isoval, Mesh& mesh) {
+    const float stepsize = axes.stepsize;
+    int which = 0;
+    if (corners[6] < isoval) which |= NEAR_TOP_LEFT;
+    if (corners[7] < isoval) which |= NEAR_TOP_RIGHT;
+    if (corners[5] < isoval) which |= NEAR_BOTTOM_RIGHT;
+    if (corners[4] < isoval) which |= NEAR_BOTTOM_LEFT;
+    if (corners[2] < isoval) which |= FAR_TOP_LEFT;
+    if (corners[3] < isoval) which |= FAR_TOP_RIGHT;
+    if (corners[1] < isoval) which |= FAR_BOTTOM_RIGHT;
+    if (corners[0] < isoval) which |= FAR_BOTTOM_LEFT;
+
+    const int* verts = marching_cubes_lut[which];
+    for (int t = 0; verts[t] >= 0; t += 3) {
+        glm::vec3 v[3];
+        for (int n = 0; n < 3; ++n) {
+            v[n] = glm::vec3(axes.xs[i] + stepsize * vertTable[verts[t + n]][0],
+                             axes.ys[j] + stepsize * vertTable[verts[t + n]][1],
+                             axes.zs[k] + stepsize * vertTable[verts[t + n]][2]);
+        }
+
+        glm::vec3 norm = glm::normalize(glm::cross(v[0] - v[1], v[0] - v[2]));
+        for (int n = 0; n < 3; ++n) {
+            mesh.vertices.push_back(v[n].x);
+            mesh.vertices.push_back(v[n].y);
+            mesh.vertices.push_back(v[n].z);
+            mesh.normals.push_back(norm.x);
+            mesh.normals.push_back(norm.y);
+            mesh.normals.push_back(norm.z);
+        }
+        mesh.stats.addTriangle(&mesh.vertices[mesh.vertices.size() - 9]);
+    }
+}
+
+
+void marching_cubes_sampled(const SampleGrid& samples, const GridAxes& axes, const CellBox& box, float isoval, Mesh& mesh) {
+    samples.forEachCell(box, [&](size_t i, size_t j, size_t k, const float* corners) {
+        emitSampledCell(axes, i, j, k, corners, isoval, mesh);
+    });
+}
+
+
+void marching_cubes_sparse(const SparseGrid& samples, const GridAxes& axes, float isoval, Mesh& mesh, unsigned threads) {
+    TRACE_SCOPE("marching_cubes_sparse");
+    mesh.clear();
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+
+    // Blocks of consecutive leaves, a few per thread for load balance
+    const size_t leaves = samples.leafCount();
+    const size_t leavesPerBlock = std::max<size_t>(1, leaves / (4 * threads));
+    const size_t blocks = (leaves + leavesPerBlock - 1) / leavesPerBlock;
+    std::vector<Mesh> parts(blocks);
+
+    pool.parallelFor(blocks, [&](size_t b) {
+        Mesh& part = parts[b];
+        for (size_t leaf = b * leavesPerBlock; leaf < std::min(leaves, (b + 1) * leavesPerBlock); ++leaf) {
+            samples.forEachLeafCell(leaf, [&](size_t i, size_t j, size_t k, const float* corners) {
+                emitSampledCell(axes, i, j, k, corners, isoval, part);
+            });
+        }
+    }, threads);
+
+    // Gather the blocks in order into one exactly sized mesh
+    size_t floats = 0;
+    for (const Mesh& part : parts) floats += part.vertices.size();
+    mesh.vertices.reserve(floats);
+    mesh.normals.reserve(floats);
+    for (Mesh& part : parts) {
+        mesh.vertices.insert(mesh.vertices.end(), part.vertices.begin(), part.vertices.end());
+        mesh.normals.insert(mesh.normals.end(), part.normals.begin(), part.normals.end());
+        mesh.stats.merge(part.stats);
+        part = Mesh();
+    }
+    TRACE_COUNT("triangles", mesh.triangleCount());
+}
+
+
+bool marching_cubes_async(std::vector<float>& vertices, std::vector<float>& normals, const ScalarField& f, float isoval, float minx, float maxx, float miny, float maxy, float minz, float maxz, float stepsize, const ProgressCallback& progress, ExtractionEngine engine, MeshStats* stats) {
+    Grid grid = {minx, maxx, miny, maxy, minz, maxz, stepsize};
+    if (engine == ExtractionEngine::SurfaceNets) {
+        // Surface Nets needs the vertices of neighbouring slabs, so the mesh is appended whole
+        Mesh mesh;
+        bool ok = surface_nets(f, grid, isoval, mesh, 1, progress);
+        vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        normals.insert(normals.end(), mesh.normals.begin(), mesh.normals.end());
+        if (stats) stats->merge(mesh.stats);
+        return ok;
+    }
+    return marching_cubes_slabs(f, grid, isoval, [&](size_t, const std::vector<float>& slabVertices, const std::vector<float>& slabNormals) {
+        vertices.insert(vertices.end(), slabVertices.begin(), slabVertices.end());
+        normals.insert(normals.end(), slabNormals.begin(), slabNormals.end());
+    }, progress, CancellationToken(), stats);
+}
+
+
+/***
+ * Marching Cubes Algorithm ORIGINAL - FOR NON ASYNCHRONOUS CALLS
+*/
+/***
+std::vector<float> marching_cubes(scalar_field_3d f, float isoval, float minx, float maxx, float miny, float maxy, float minz, float maxz, float stepsize) {
+	std::vector<float> vertices;
+	float x = minx;
+	float y = miny;
+	float z = minz;
+	float ftl, ftr, fbr, fbl, ntl, ntr, nbr, nbl;
+	int which = 0;
+	int* verts;
+
+	for ( ; x < maxx; x += stepsize) {
+		for (y = miny ; y < maxy; y += stepsize) {
+			for (z = minz ; z < maxz ; z += stepsize){
+				//test the cube
+				ntl = (*f)(x, y+stepsize, z+stepsize);
+				ntr = (*f)(x+stepsize, y+stepsize, z+stepsize);
+				nbr = (*f)(x+stepsize, y, z+stepsize);
+				nbl = (*f)(x, y, z+stepsize);
+				ftl = (*f)(x, y+stepsize, z);
+				ftr = (*f)(x+stepsize, y+stepsize, z);
+				fbr = (*f)(x+stepsize, y, z);
+				fbl = (*f)(x, y, z);
+
+				which = 0;
+                if (ntl < isoval) which |= NEAR_TOP_LEFT;
+                if (ntr < isoval) which |= NEAR_TOP_RIGHT;
+                if (nbr < isoval) which |= NEAR_BOTTOM_RIGHT;
+                if (nbl < isoval) which |= NEAR_BOTTOM_LEFT;
+                if (ftl < isoval) which |= FAR_TOP_LEFT;
+                if (ftr < isoval) which |= FAR_TOP_RIGHT;
+                if (fbr < isoval) which |= FAR_BOTTOM_RIGHT;
+                if (fbl < isoval) which |= FAR_BOTTOM_LEFT;
+
+				verts = marching_cubes_lut[which];
+				
+                // Generate vertices
+                for (int i = 0; verts[i] >= 0; i += 3) {
+                    for (int j = 0; j < 3; ++j) {
+                        vertices.emplace_back(x + stepsize * vertTable[verts[i + j]][0]);
+                        vertices.emplace_back(y + stepsize * vertTable[verts[i + j]][1]);
+                        vertices.emplace_back(z + stepsize * vertTable[verts[i + j]][2]);
+                    }
+                }
+			
+			}
+		}
+	}
+
+	return vertices;
+}
+*/
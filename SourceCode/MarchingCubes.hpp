@@ -0,0 +1,249 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MarchingCubes.hpp
+ *
+ * @brief The marching cubes extraction kernel.
+ * This file declares the slab-by-slab marching cubes kernel, the two-pass
+ * count-then-emit kernel, the brick kernels used by the out-of-core and
+ * incremental extractions, the per triangle normal computation and the
+ * original marching_cubes_async entry point, which now appends the output
+ * of the slab kernel, or of the Surface Nets kernel, to two vectors.
+ */
+
+#ifndef MARCHINGCUBES_HPP
+#define MARCHINGCUBES_HPP
+
+#include <stddef.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Fields.hpp"
+#include "Mesh.hpp"
+
+class SampleGrid;
+class SparseGrid;
+
+// Receives the number of completed and total slabs
+typedef std::function<void(size_t, size_t)> ProgressCallback;
+
+// Receives the index of a completed slab with its vertices and normals
+typedef std::function<void(size_t, const std::vector<float>&, const std::vector<float>&)> SlabCallback;
+
+// Receives a chunk of triangles (vertices, normals and their float count) while the extraction runs
+typedef std::function<void(const float*, const float*, size_t)> ChunkCallback;
+
+/***
+ * CancellationToken: a flag shared by every copy of the token.
+ * The kernels check it before every slab (and brick), so a cancelled
+ * extraction stops within the time of one slab and returns false.
+*/
+class CancellationToken {
+
+private:
+
+    std::shared_ptr<std::atomic<bool>> flag = std::make_shared<std::atomic<bool>>(false);
+
+public:
+
+    void cancel() const { flag->store(true); }
+    bool cancelled() const { return flag->load(std::memory_order_relaxed); }
+};
+
+/***
+ * ExtractionEngine: the algorithm turning the sampled grid into triangles
+*/
+enum class ExtractionEngine {
+    MarchingCubes,  // Triangles from marching_cubes_lut, vertices at edge midpoints
+    SurfaceNets     // One vertex per crossed cell, one quad per crossed edge (SurfaceNets.hpp)
+};
+
+/***
+ * @brief The command line name of an engine ("marching-cubes" or "surface-nets").
+*/
+const char* extractionEngineName(ExtractionEngine engine);
+
+/***
+ * @brief Parse an engine name, also accepting "mc" and "sn".
+ * @param name The name
+ * @param[out] engine The engine, unchanged if the name is unknown
+ * @return bool True if the name is known
+*/
+bool parseExtractionEngine(const std::string& name, ExtractionEngine& engine);
+
+/***
+ * GridAxes: the corner coordinates of a grid along each axis
+*/
+struct GridAxes {
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> zs;
+    float stepsize;
+
+    size_t nx() const { return xs.size() - 1; }
+    size_t ny() const { return ys.size() - 1; }
+    size_t nz() const { return zs.size() - 1; }
+};
+
+/***
+ * @brief Corner coordinates along one axis of the grid.
+ * Coordinates are accumulated (v += stepsize) exactly like the original loops,
+ * so every engine and every partition of the grid samples the same points.
+ * @param min Minimum value
+ * @param max Maximum value
+ * @param stepsize Step size
+ * @return std::vector<float> The cell origins, followed by the far corner of the last cell
+*/
+std::vector<float> gridAxis(float min, float max, float stepsize);
+
+/***
+ * @brief Corner coordinates of a grid along all three axes.
+ * @param grid The sampled box and step size
+ * @return GridAxes The coordinates, see gridAxis
+*/
+GridAxes gridAxes(const Grid& grid);
+
+/***
+ * @brief Number of triangles of each of the 256 cube configurations, derived from marching_cubes_lut.
+*/
+const unsigned char* marching_cubes_triangle_counts();
+
+/***
+ * @brief Compute normals for each vertex in a given list of vertices.
+ * @param vertices A list of vertices
+ * @return std::vector<float> A list of computed normals for each vertex
+*/
+std::vector<float> compute_normals(const std::vector<float>& vertices);
+
+/***
+ * @brief Run the Marching Cubes algorithm over a grid, one x slab at a time.
+ * The field is sampled once per corner into two planes of samples (the far
+ * plane of a slab is the near plane of the next one), then every cell of the
+ * slab is classified and its triangles are emitted. Each stage is timed per
+ * slab when tracing is enabled.
+ * @param f Scalar field
+ * @param grid The sampled box and step size
+ * @param isoval Isovalue
+ * @param onSlab Callback receiving the triangles of every slab, in order
+ * @param progress Optional callback receiving the number of completed and total slabs
+ * @param cancel Checked before every slab
+ * @param[in,out] stats Optional statistics the triangles are added to as they are emitted
+ * @return bool Returns true if the algorithm executed successfully, false if it was cancelled
+*/
+bool marching_cubes_slabs(const ScalarField& f, const Grid& grid, float isoval, const SlabCallback& onSlab, const ProgressCallback& progress = nullptr, const CancellationToken& cancel = CancellationToken(), MeshStats* stats = nullptr);
+
+/***
+ * @brief Run the Marching Cubes algorithm in two passes with an exact output allocation.
+ * Pass one samples and classifies every cell in parallel blocks of slabs and
+ * keeps the cells that produce triangles, about 9 bytes per active cell on
+ * top of the output; the per-case triangle counts give the triangles of
+ * every block. A prefix sum over the blocks gives each block its offset in
+ * the output, which is allocated once at its exact size, and pass two emits
+ * the triangles and their normals straight into it in parallel, without
+ * locks, adding every triangle to the statistics of its block; the block
+ * statistics are summed into mesh.stats at the end. The mesh is identical to
+ * the one of marching_cubes_slabs.
+ * @param f Scalar field, called concurrently from several threads
+ * @param grid The sampled box and step size
+ * @param isoval Isovalue
+ * @param[out] mesh Output mesh, replaced by the isosurface and its statistics
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @param progress Optional callback receiving the completed and total slab passes
+ * @param cancel Checked before every slab of each pass; a cancelled call leaves the mesh empty
+ * @return bool Returns true if the algorithm executed successfully, false if it was cancelled
+*/
+bool marching_cubes_two_pass(const ScalarField& f, const Grid& grid, float isoval, Mesh& mesh, unsigned threads = 0, const ProgressCallback& progress = nullptr, const CancellationToken& cancel = CancellationToken());
+
+/***
+ * @brief Count the triangles of a marching cubes mesh without emitting them.
+ * This is pass one of marching_cubes_two_pass on its own: every cell is
+ * sampled and classified in parallel blocks of slabs, and only the totals
+ * are kept, so it takes about as long as that pass and no memory per cell.
+ * @param f Scalar field, called concurrently from several threads
+ * @param grid The sampled box and step size
+ * @param isoval Isovalue
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @param[out] activeCells Optional, receives the number of cells the surface crosses
+ * @return size_t Triangles of the mesh
+*/
+size_t marching_cubes_count(const ScalarField& f, const Grid& grid, float isoval, unsigned threads = 0, size_t* activeCells = nullptr);
+
+/***
+ * @brief Run the Marching Cubes algorithm over one box of cells.
+ * Only the corners of the box are sampled, at the coordinates of the whole
+ * grid, so neighbouring boxes sample their shared faces identically and
+ * their triangles meet exactly along the border. The corners need not be
+ * evenly spaced: a vertex on a corner plane is placed at the corner itself.
+ * Triangles are buffered and handed over whenever the buffer reaches
+ * chunkFloats, which bounds the memory of the call by the box face and the
+ * chunk size, not the mesh.
+ * @param f Scalar field
+ * @param axes Corner coordinates of the whole grid
+ * @param box The cells to polygonize
+ * @param isoval Isovalue
+ * @param chunkFloats Floats of vertices buffered before onChunk is called (at least 45)
+ * @param onChunk Callback receiving the triangles of the box in order
+ * @param cancel Checked before every slab of the box
+ * @param[in,out] stats Optional statistics the triangles are added to as they are emitted
+ * @return bool Returns true if the algorithm executed successfully, false if it was cancelled
+*/
+bool marching_cubes_brick(const ScalarField& f, const GridAxes& axes, const CellBox& box, float isoval, size_t chunkFloats, const ChunkCallback& onChunk, const CancellationToken& cancel = CancellationToken(), MeshStats* stats = nullptr);
+
+/***
+ * @brief Run the Marching Cubes algorithm over one box of cells of a sampled grid.
+ * Instead of calling a field, the corners are read from samples of the whole
+ * grid (see SampleGrid.hpp). The cells are visited brick by brick in the
+ * order the samples are stored, so the triangles are grouped by sample brick.
+ * @param samples Field values at every corner of the grid
+ * @param axes Corner coordinates of the whole grid
+ * @param box The cells to polygonize
+ * @param isoval Isovalue
+ * @param[out] mesh Mesh the triangles of the box are appended to, and added to mesh.stats
+*/
+void marching_cubes_sampled(const SampleGrid& samples, const GridAxes& axes, const CellBox& box, float isoval, Mesh& mesh);
+
+/***
+ * @brief Run the Marching Cubes algorithm over the leaves of a sparse grid.
+ * Blocks of leaves are polygonized in parallel and gathered in order, with
+ * the same triangles per cell as marching_cubes_sampled; the cells outside
+ * the band of the grid are never visited (see SparseGrid.hpp).
+ * @param samples The sparse samples
+ * @param axes Corner coordinates of the grid the samples were built on
+ * @param isoval Isovalue, normally samples.isovalue()
+ * @param[out] mesh Output mesh, replaced by the isosurface and its statistics
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+*/
+void marching_cubes_sparse(const SparseGrid& samples, const GridAxes& axes, float isoval, Mesh& mesh, unsigned threads = 0);
+
+/***
+ * @brief Run the Marching Cubes algorithm asynchronously.
+ * @param[out] vertices Output vertices
+ * @param[out] normals Output normals
+ * @param f Scalar field generating function
+ * @param isoval Isovalue
+ * @param minx Minimum x value
+ * @param maxx Maximum x value
+ * @param miny Minimum y value
+ * @param maxy Maximum y value
+ * @param minz Minimum z value
+ * @param maxz Maximum z value
+ * @param stepsize Step size for the algorithm
+ * @param progress Optional callback receiving the number of completed and total slabs
+ * @param engine The extraction algorithm
+ * @param[in,out] stats Optional statistics the appended triangles are added to
+ * @return bool Returns true if the algorithm executed successfully
+*/
+bool marching_cubes_async(std::vector<float>& vertices, std::vector<float>& normals, const ScalarField& f, float isoval, float minx, float maxx, float miny, float maxy, float minz, float maxz, float stepsize, const ProgressCallback& progress = nullptr, ExtractionEngine engine = ExtractionEngine::MarchingCubes, MeshStats* stats = nullptr);
+
+#endif // MARCHINGCUBES_HPP
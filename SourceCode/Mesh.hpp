@@ -0,0 +1,146 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Mesh.hpp
+ *
+ * @brief The mesh and grid types shared by the isosurface library.
+ *
+ * Types:
+ *
+ * Grid: The axis-aligned box sampled by the extraction and its step size
+ * CellBox: A box of cells of a grid, given by cell indices
+ * MeshStats: Surface area, enclosed volume and bounding box of a mesh,
+ * accumulated by the extraction kernels as they emit the triangles
+ * Mesh: A triangle soup, three (x, y, z) vertices per triangle with one
+ * normal per vertex, exactly as produced by the marching cubes algorithm
+ */
+
+#ifndef MESH_HPP
+#define MESH_HPP
+
+#include <float.h>
+#include <stddef.h>
+#include <cmath>
+#include <vector>
+
+/***
+ * Grid: the sampled box and its step size
+*/
+struct Grid {
+    float minx, maxx;
+    float miny, maxy;
+    float minz, maxz;
+    float stepsize;
+
+    /***
+     * @brief A cube spanning [min, max] along every axis.
+    */
+    static Grid cube(float min, float max, float stepsize) {
+        return {min, max, min, max, min, max, stepsize};
+    }
+};
+
+/***
+ * CellBox: the cells [i0, i1) x [j0, j1) x [k0, k1) of a grid
+*/
+struct CellBox {
+    size_t i0, i1;
+    size_t j0, j1;
+    size_t k0, k1;
+
+    size_t cellCount() const { return (i1 - i0) * (j1 - j0) * (k1 - k0); }
+};
+
+/***
+ * MeshStats: surface area, enclosed volume and bounding box of a triangle soup.
+ * The volume comes from the divergence theorem: every triangle adds the
+ * signed volume of the tetrahedron it forms with the origin. It is positive
+ * for the region below the isovalue, which the triangles face away from, and
+ * only meaningful for a closed surface; a surface cut open by the grid
+ * boundary does not enclose a volume.
+*/
+struct MeshStats {
+    size_t triangles = 0;
+    double area = 0.0;
+    double volume = 0.0;
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    /***
+     * @brief Add one triangle.
+     * @param v The nine coordinates of its three vertices
+    */
+    void addTriangle(const float* v) {
+        const double ax = v[0], ay = v[1], az = v[2];
+        const double e1x = v[3] - ax, e1y = v[4] - ay, e1z = v[5] - az;
+        const double e2x = v[6] - ax, e2y = v[7] - ay, e2z = v[8] - az;
+        const double cx = e1y * e2z - e1z * e2y;
+        const double cy = e1z * e2x - e1x * e2z;
+        const double cz = e1x * e2y - e1y * e2x;
+        ++triangles;
+        area += 0.5 * std::sqrt(cx * cx + cy * cy + cz * cz);
+        // a . (b x c) = a . ((b - a) x (c - a))
+        volume += (ax * cx + ay * cy + az * cz) / 6.0;
+        for (int n = 0; n < 9; n += 3) {
+            for (int a = 0; a < 3; ++a) {
+                if (v[n + a] < min[a]) min[a] = v[n + a];
+                if (v[n + a] > max[a]) max[a] = v[n + a];
+            }
+        }
+    }
+
+    /***
+     * @brief Add the triangles of a soup, for meshes that did not come from a kernel.
+     * @param vertices Vertex coordinates, nine per triangle
+     * @param floatCount Number of floats
+    */
+    void add(const float* vertices, size_t floatCount) {
+        for (size_t t = 0; t + 9 <= floatCount; t += 9) addTriangle(vertices + t);
+    }
+
+    /***
+     * @brief Add the statistics of another part of the same mesh.
+    */
+    void merge(const MeshStats& other) {
+        triangles += other.triangles;
+        area += other.area;
+        volume += other.volume;
+        for (int a = 0; a < 3; ++a) {
+            if (other.min[a] < min[a]) min[a] = other.min[a];
+            if (other.max[a] > max[a]) max[a] = other.max[a];
+        }
+    }
+};
+
+/***
+ * Mesh: a triangle soup with per-vertex normals
+*/
+struct Mesh {
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    MeshStats stats;    // Filled by the extraction kernels; only valid while stats.triangles == triangleCount()
+
+    size_t vertexCount() const { return vertices.size() / 3; }
+    size_t triangleCount() const { return vertices.size() / 9; }
+
+    /***
+     * @brief True if stats describes the triangles of the mesh.
+    */
+    bool hasStats() const { return stats.triangles == triangleCount(); }
+
+    void clear() {
+        vertices.clear();
+        normals.clear();
+        stats = MeshStats();
+    }
+};
+
+#endif // MESH_HPP
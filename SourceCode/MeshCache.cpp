@@ -0,0 +1,174 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MeshCache.cpp
+ *
+ * @brief Storage, lookup and eviction of cached meshes.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Constants.hpp"
+#include "MeshCache.hpp"
+
+
+void MappedMesh::release() {
+    if (data != nullptr) munmap(data, length);
+    data = nullptr;
+    length = count = payloadOffset = 0;
+}
+
+
+bool MappedMesh::map(const std::string& path, const std::string& key) {
+    release();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MeshCacheHeader)) {
+        close(fd);
+        return false;
+    }
+
+    length = st.st_size;
+    data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        length = 0;
+        return false;
+    }
+
+    // Validate the header and the stored key against the one we asked for
+    const MeshCacheHeader* header = (const MeshCacheHeader*) data;
+    payloadOffset = sizeof(MeshCacheHeader) + ((header->keyLength + 15) & ~15u);
+    bool valid = memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) == 0 &&
+                 header->format == MESH_CACHE_FORMAT &&
+                 header->keyLength == key.size() &&
+                 payloadOffset + header->floatCount * 2 * sizeof(float) == length &&
+                 memcmp((const char*) data + sizeof(MeshCacheHeader), key.data(), key.size()) == 0;
+    if (!valid) {
+        release();
+        return false;
+    }
+
+    count = header->floatCount;
+    madvise(data, length, MADV_SEQUENTIAL);
+    return true;
+}
+
+
+std::string meshCacheKey(const std::string& fieldId, float isoval, float minx, float maxx, float miny, float maxy, float minz, float maxz, float stepsize) {
+    char params[512];
+    snprintf(params, sizeof(params), "engine=%d iso=%a x=%a:%a y=%a:%a z=%a:%a step=%a",
+             ENGINE_VERSION, isoval, minx, maxx, miny, maxy, minz, maxz, stepsize);
+    return "field=" + fieldId + " " + params;
+}
+
+
+std::string meshCachePath(const std::string& directory, const std::string& key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.mesh", (unsigned long long) hash);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+
+bool meshCacheLookup(const std::string& directory, const std::string& key, MappedMesh& mesh) {
+    std::string path = meshCachePath(directory, key);
+    if (!mesh.map(path, key)) return false;
+
+    // Mark the entry as most recently used
+    utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+    return true;
+}
+
+
+void meshCacheEvict(const std::string& directory, unsigned long long maxBytes) {
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUse;
+        unsigned long long size;
+    };
+
+    std::error_code ec;
+    std::vector<Entry> entries;
+    unsigned long long total = 0;
+    for (const auto& file : std::filesystem::directory_iterator(directory, ec)) {
+        if (file.path().extension() != ".mesh") continue;
+        Entry entry = {file.path(), file.last_write_time(ec), file.file_size(ec)};
+        if (ec) continue;
+        total += entry.size;
+        entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUse < b.lastUse;
+    });
+
+    for (size_t i = 0; i < entries.size() && total > maxBytes; ++i) {
+        if (std::filesystem::remove(entries[i].path, ec)) total -= entries[i].size;
+    }
+}
+
+
+bool meshCacheStore(const std::string& directory, unsigned long long maxBytes, const std::string& key, const std::vector<float>& vertices, const std::vector<float>& normals) {
+    if (vertices.size() != normals.size()) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    std::string path = meshCachePath(directory, key);
+    std::string tempPath = path + ".tmp" + std::to_string(getpid());
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Failed to write mesh cache file %s\n", tempPath.c_str());
+        return false;
+    }
+
+    MeshCacheHeader header = {};
+    memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+    header.format = MESH_CACHE_FORMAT;
+    header.keyLength = key.size();
+    header.floatCount = vertices.size();
+
+    const char padding[16] = {};
+    size_t paddingLength = ((key.size() + 15) & ~15u) - key.size();
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(key.data(), 1, key.size(), file) == key.size() &&
+              fwrite(padding, 1, paddingLength, file) == paddingLength &&
+              fwrite(vertices.data(), sizeof(float), vertices.size(), file) == vertices.size() &&
+              fwrite(normals.data(), sizeof(float), normals.size(), file) == normals.size();
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    meshCacheEvict(directory, maxBytes);
+    return true;
+}
@@ -0,0 +1,141 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MeshCache.hpp
+ *
+ * @brief A persistent, content-addressed cache of extracted meshes.
+ * Every mesh is keyed by the identity of the scalar field, the grid bounds,
+ * the step size, the isovalue and the engine version. The key is hashed into
+ * a file name inside the cache directory, and the mesh is stored there in a
+ * small binary format that can be memory-mapped straight back on a hit, so
+ * an identical run skips the marching cubes extraction entirely. The cache
+ * is capped in size and evicts the least recently used meshes first (a hit
+ * refreshes the modification time of its file).
+ *
+ * File layout (native endianness):
+ *
+ * MeshCacheHeader: magic, format version, key length and float count
+ * key: the full key text, padded to a 16 byte boundary
+ * vertices: floatCount floats
+ * normals: floatCount floats
+ */
+
+#ifndef MESHCACHE_HPP
+#define MESHCACHE_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+const char MESH_CACHE_MAGIC[8] = {'I', 'S', 'O', 'M', 'E', 'S', 'H', '\0'};
+const uint32_t MESH_CACHE_FORMAT = 1;
+
+struct MeshCacheHeader {
+    char magic[8];
+    uint32_t format;
+    uint32_t keyLength;
+    uint64_t floatCount;
+    uint64_t reserved[5];
+};
+
+
+/***
+ * @brief A read-only memory mapping of a cached mesh file.
+ * The mapping is released when the object is destroyed or reassigned.
+*/
+class MappedMesh {
+
+private:
+
+    void* data = nullptr;
+    size_t length = 0;
+    size_t count = 0;
+    size_t payloadOffset = 0;
+
+    void release();
+
+public:
+
+    MappedMesh() {}
+    MappedMesh(const MappedMesh&) = delete;
+    MappedMesh& operator=(const MappedMesh&) = delete;
+    ~MappedMesh() { release(); }
+
+    /***
+     * @brief Map the given file, replacing any previous mapping.
+     * @param path Path of the cached mesh file
+     * @param key Key text the file has to be stored under
+     * @return bool True if the file is a valid mesh for this key
+    */
+    bool map(const std::string& path, const std::string& key);
+
+    const float* vertices() const { return (const float*) ((const char*) data + payloadOffset); }
+    const float* normals() const { return vertices() + count; }
+    size_t floatCount() const { return count; }
+};
+
+
+/***
+ * @brief Build the canonical cache key of an extraction.
+ * Floats are printed in hexadecimal so that the key is exact.
+ * @param fieldId Identity of the scalar field (its name or expression text)
+ * @param isoval Isovalue
+ * @param minx Minimum x value
+ * @param maxx Maximum x value
+ * @param miny Minimum y value
+ * @param maxy Maximum y value
+ * @param minz Minimum z value
+ * @param maxz Maximum z value
+ * @param stepsize Step size for the algorithm
+ * @return std::string The key text
+*/
+std::string meshCacheKey(const std::string& fieldId, float isoval, float minx, float maxx, float miny, float maxy, float minz, float maxz, float stepsize);
+
+/***
+ * @brief Compute the path of the cache file for a key (64 bit FNV-1a hash of the key).
+ * @param directory The cache directory
+ * @param key The key text
+ * @return std::string Path of the cache file
+*/
+std::string meshCachePath(const std::string& directory, const std::string& key);
+
+/***
+ * @brief Look up a mesh in the cache and map it into memory on a hit.
+ * @param directory The cache directory
+ * @param key The key text
+ * @param[out] mesh The mapped mesh
+ * @return bool True on a cache hit
+*/
+bool meshCacheLookup(const std::string& directory, const std::string& key, MappedMesh& mesh);
+
+/***
+ * @brief Evict least recently used meshes until the cache fits in maxBytes.
+ * @param directory The cache directory
+ * @param maxBytes Size cap of the cache
+*/
+void meshCacheEvict(const std::string& directory, unsigned long long maxBytes);
+
+/***
+ * @brief Store a mesh in the cache, then enforce the size cap.
+ * The file is written under a temporary name and renamed into place, so a
+ * concurrent lookup never maps a partially written mesh.
+ * @param directory The cache directory
+ * @param maxBytes Size cap of the cache
+ * @param key The key text
+ * @param vertices A list of vertices
+ * @param normals A list of normals
+ * @return bool True if the mesh was stored
+*/
+bool meshCacheStore(const std::string& directory, unsigned long long maxBytes, const std::string& key, const std::vector<float>& vertices, const std::vector<float>& normals);
+
+
+#endif // MESHCACHE_HPP
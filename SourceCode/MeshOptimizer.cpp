@@ -0,0 +1,231 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MeshOptimizer.cpp
+ *
+ * @brief Implementation of the vertex cache and vertex fetch reordering.
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "MeshOptimizer.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+// Entries of the LRU cache the reordering scores against
+const unsigned FORSYTH_CACHE_SIZE = 32;
+
+// Scoring parameters from Forsyth's article
+const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+// Remaining triangle counts with a tabulated valence score; higher ones share the last entry
+const unsigned FORSYTH_MAX_VALENCE = 32;
+
+// Triangles reordered together, a few dozen slabs' worth of surface at the default step
+const size_t OPTIMIZE_BLOCK_TRIANGLES = 1 << 16;
+
+/***
+ * ForsythScores: the cache position and valence terms of the vertex score
+*/
+struct ForsythScores {
+    float cache[FORSYTH_CACHE_SIZE];
+    float valence[FORSYTH_MAX_VALENCE];
+
+    ForsythScores() {
+        // The last triangle's vertices score the same whatever their order, so it is not re-picked
+        for (unsigned p = 0; p < FORSYTH_CACHE_SIZE; ++p) {
+            if (p < 3) cache[p] = FORSYTH_LAST_TRIANGLE_SCORE;
+            else cache[p] = std::pow(1.0f - (p - 3) / (float) (FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+        }
+        // Vertices with few triangles left are finished first, so they leave no stragglers
+        valence[0] = 0.0f;
+        for (unsigned v = 1; v < FORSYTH_MAX_VALENCE; ++v) {
+            valence[v] = FORSYTH_VALENCE_BOOST_SCALE * std::pow((float) v, -FORSYTH_VALENCE_BOOST_POWER);
+        }
+    }
+
+    float score(int cachePosition, uint32_t remaining) const {
+        if (remaining == 0) return -1.0f;
+        float s = valence[std::min(remaining, FORSYTH_MAX_VALENCE - 1)];
+        if (cachePosition >= 0) s += cache[cachePosition];
+        return s;
+    }
+};
+
+
+void optimizeVertexCacheRange(uint32_t* indices, size_t triangleCount) {
+    if (triangleCount == 0) return;
+    static const ForsythScores scores;
+    const size_t indexCount = 3 * triangleCount;
+
+    // Number the vertices of the block from zero
+    std::unordered_map<uint32_t, uint32_t> localOf;
+    localOf.reserve(indexCount);
+    std::vector<uint32_t> local(indexCount);
+    for (size_t i = 0; i < indexCount; ++i) {
+        local[i] = localOf.emplace(indices[i], (uint32_t) localOf.size()).first->second;
+    }
+    const size_t vertexCount = localOf.size();
+
+    // The triangles around every vertex; the first remaining[v] of them are not emitted yet
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < indexCount; ++i) remaining[local[i]]++;
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<uint32_t> adjacency(indexCount);
+    {
+        std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i) adjacency[next[local[i]]++] = i / 3;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = scores.score(-1, remaining[v]);
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<char> emitted(triangleCount, 0);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[local[3 * t]] + vertexScore[local[3 * t + 1]] + vertexScore[local[3 * t + 2]];
+    }
+    size_t best = std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin();
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t nextCache[FORSYTH_CACHE_SIZE + 3];
+    size_t cacheCount = 0;
+    size_t scan = 0;
+    std::vector<uint32_t> order;
+    order.reserve(triangleCount);
+
+    while (order.size() < triangleCount) {
+        // When no triangle touches the cache, restart from the first one not emitted
+        if (best == triangleCount) {
+            while (emitted[scan]) scan++;
+            best = scan;
+        }
+        const size_t t = best;
+        order.push_back(t);
+        emitted[t] = 1;
+
+        // The triangle's vertices move to the front of the cache, the others shift back
+        size_t nextCount = 0;
+        for (int c = 0; c < 3; ++c) {
+            uint32_t v = local[3 * t + c];
+            nextCache[nextCount++] = v;
+            uint32_t* around = &adjacency[offsets[v]];
+            uint32_t* found = std::find(around, around + remaining[v], (uint32_t) t);
+            std::swap(*found, around[--remaining[v]]);
+        }
+        for (size_t c = 0; c < cacheCount; ++c) {
+            uint32_t v = cache[c];
+            if (v != nextCache[0] && v != nextCache[1] && v != nextCache[2]) nextCache[nextCount++] = v;
+        }
+
+        // Rescore the cached and evicted vertices, then the triangles around them
+        for (size_t c = 0; c < nextCount; ++c) {
+            uint32_t v = nextCache[c];
+            cachePosition[v] = c < FORSYTH_CACHE_SIZE ? (int) c : -1;
+            vertexScore[v] = scores.score(cachePosition[v], remaining[v]);
+        }
+        best = triangleCount;
+        float bestScore = -1.0f;
+        for (size_t c = 0; c < nextCount; ++c) {
+            uint32_t v = nextCache[c];
+            for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a) {
+                uint32_t other = adjacency[a];
+                float s = vertexScore[local[3 * other]] + vertexScore[local[3 * other + 1]] + vertexScore[local[3 * other + 2]];
+                triangleScore[other] = s;
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = other;
+                }
+            }
+        }
+
+        cacheCount = std::min<size_t>(nextCount, FORSYTH_CACHE_SIZE);
+        memcpy(cache, nextCache, cacheCount * sizeof(uint32_t));
+    }
+
+    std::vector<uint32_t> reordered(indexCount);
+    for (size_t i = 0; i < triangleCount; ++i) memcpy(&reordered[3 * i], &indices[3 * order[i]], 3 * sizeof(uint32_t));
+    memcpy(indices, reordered.data(), indexCount * sizeof(uint32_t));
+}
+
+
+VertexCacheStats simulateVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, unsigned cacheSize) {
+    VertexCacheStats stats;
+    stats.triangles = indices.size() / 3;
+
+    // A vertex is cached while fewer than cacheSize misses have happened since it was loaded
+    std::vector<size_t> loadedAt(vertexCount, 0);
+    for (uint32_t v : indices) {
+        if (loadedAt[v] == 0) stats.vertices++;
+        if (loadedAt[v] == 0 || loadedAt[v] + cacheSize <= stats.transformed) {
+            stats.transformed++;
+            loadedAt[v] = stats.transformed;
+        }
+    }
+
+    if (stats.triangles > 0) stats.acmr = (double) stats.transformed / stats.triangles;
+    if (stats.vertices > 0) stats.atvr = (double) stats.transformed / stats.vertices;
+    return stats;
+}
+
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, unsigned threads) {
+    TRACE_SCOPE("optimize_vertex_cache");
+    const size_t triangleCount = indices.size() / 3;
+    const size_t blocks = (triangleCount + OPTIMIZE_BLOCK_TRIANGLES - 1) / OPTIMIZE_BLOCK_TRIANGLES;
+    ThreadPool::shared().parallelFor(blocks, [&](size_t b) {
+        size_t first = b * OPTIMIZE_BLOCK_TRIANGLES;
+        optimizeVertexCacheRange(&indices[3 * first], std::min(OPTIMIZE_BLOCK_TRIANGLES, triangleCount - first));
+    }, threads);
+}
+
+
+void optimizeVertexFetch(IndexedMesh& mesh) {
+    TRACE_SCOPE("optimize_vertex_fetch");
+    const uint32_t unused = UINT32_MAX;
+    std::vector<uint32_t> remap(mesh.vertexCount(), unused);
+    uint32_t next = 0;
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == unused) remap[index] = next++;
+        index = remap[index];
+    }
+
+    const bool hasNormals = !mesh.normals.empty();
+    std::vector<float> positions(3 * next);
+    std::vector<float> normals(hasNormals ? 3 * next : 0);
+    for (size_t v = 0; v < remap.size(); ++v) {
+        if (remap[v] == unused) continue;
+        memcpy(&positions[3 * remap[v]], &mesh.positions[3 * v], 3 * sizeof(float));
+        if (hasNormals) memcpy(&normals[3 * remap[v]], &mesh.normals[3 * v], 3 * sizeof(float));
+    }
+    mesh.positions.swap(positions);
+    mesh.normals.swap(normals);
+}
+
+
+IndexedMesh optimizeMesh(const Mesh& mesh, VertexCacheStats* before, VertexCacheStats* after, unsigned threads) {
+    IndexedMesh indexed = weldMesh(mesh, threads);
+    computeVertexNormals(indexed);
+    if (before != nullptr) *before = simulateVertexCache(indexed.indices, indexed.vertexCount());
+
+    optimizeVertexCache(indexed.indices, threads);
+    optimizeVertexFetch(indexed);
+
+    if (after != nullptr) *after = simulateVertexCache(indexed.indices, indexed.vertexCount());
+    return indexed;
+}
@@ -0,0 +1,103 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MeshOptimizer.hpp
+ *
+ * @brief Reordering of indexed meshes for the GPU vertex caches.
+ * Marching cubes emits triangles in scan order, so a vertex shared by the
+ * triangles of neighbouring rows is transformed again long after it has
+ * left the post-transform cache. optimizeVertexCache reorders the triangles
+ * with Tom Forsyth's linear-speed algorithm ("Linear-Speed Vertex Cache
+ * Optimisation", 2006): every vertex is scored from its position in a
+ * simulated LRU cache and its number of remaining triangles, and the next
+ * triangle emitted is the best scored one touching the cache.
+ * optimizeVertexFetch then renumbers the vertices in the order the triangles
+ * first use them, so that vertex fetches walk memory forwards.
+ *
+ * The triangles are reordered in independent blocks on the shared thread
+ * pool. The blocks follow the scan order, so they are compact regions of the
+ * surface and little reuse is lost at their borders; their size is fixed,
+ * so the result does not depend on the thread count.
+ *
+ * simulateVertexCache measures the gain without a GPU:
+ * ACMR: average cache miss ratio, vertices transformed per triangle
+ * (3 without any reuse, about 0.5 at best on a closed surface)
+ * ATVR: average transform to vertex ratio, vertices transformed per unique
+ * vertex (1 is ideal)
+ */
+
+#ifndef MESHOPTIMIZER_HPP
+#define MESHOPTIMIZER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "IndexedMesh.hpp"
+
+// Entries of the FIFO cache simulated by default, a typical post-transform cache
+const unsigned VERTEX_CACHE_SIZE = 16;
+
+/***
+ * VertexCacheStats: the vertex transforms of an index buffer through a simulated cache
+*/
+struct VertexCacheStats {
+    size_t triangles = 0;
+    size_t vertices = 0;    // Unique vertices referenced
+    size_t transformed = 0; // Cache misses
+    double acmr = 0.0;      // transformed / triangles
+    double atvr = 0.0;      // transformed / vertices
+};
+
+/***
+ * @brief Simulate a FIFO post-transform vertex cache over an index buffer.
+ * @param indices Three vertex indices per triangle
+ * @param vertexCount Number of vertices the indices refer to
+ * @param cacheSize Entries of the simulated cache
+ * @return VertexCacheStats Misses and ratios
+*/
+VertexCacheStats simulateVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, unsigned cacheSize = VERTEX_CACHE_SIZE);
+
+/***
+ * @brief Reorder the triangles of an index buffer for vertex cache reuse.
+ * The triangles keep their winding; only their order changes.
+ * @param[in,out] indices Three vertex indices per triangle
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+*/
+void optimizeVertexCache(std::vector<uint32_t>& indices, unsigned threads = 0);
+
+/***
+ * @brief Reorder a range of triangles for vertex cache reuse on the calling thread.
+ * @param[in,out] indices The three vertex indices of each triangle of the range
+ * @param triangleCount Triangles in the range
+*/
+void optimizeVertexCacheRange(uint32_t* indices, size_t triangleCount);
+
+/***
+ * @brief Renumber the vertices in the order the index buffer first uses them.
+ * Positions and, if present, normals are moved to match; vertices no triangle
+ * uses are dropped.
+ * @param[in,out] mesh The mesh to renumber
+*/
+void optimizeVertexFetch(IndexedMesh& mesh);
+
+/***
+ * @brief Weld a triangle soup and prepare it for indexed drawing: smooth
+ * vertex normals, then the triangle and vertex reordering above.
+ * @param mesh The triangle soup
+ * @param[out] before Optional, the cache statistics of the welded mesh in scan order
+ * @param[out] after Optional, the cache statistics of the optimized mesh
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @return IndexedMesh The optimized mesh, with normals
+*/
+IndexedMesh optimizeMesh(const Mesh& mesh, VertexCacheStats* before = nullptr, VertexCacheStats* after = nullptr, unsigned threads = 0);
+
+#endif // MESHOPTIMIZER_HPP
@@ -0,0 +1,119 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MeshStream.cpp
+ *
+ * @brief Implementation of the binary mesh stream.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "MeshStream.hpp"
+
+// Largest chunk a reader accepts, so a corrupt count cannot exhaust memory
+const uint64_t MESH_STREAM_MAX_CHUNK = 1ULL << 28;
+
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = (const char*) data;
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+
+bool readAll(int fd, void* data, size_t size) {
+    char* bytes = (char*) data;
+    while (size > 0) {
+        ssize_t got = ::read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        bytes += got;
+        size -= got;
+    }
+    return true;
+}
+
+
+MeshStreamWriter::MeshStreamWriter(int fd, uint32_t status) : fd(fd) {
+    MeshStreamHeader header;
+    memcpy(header.magic, MESH_STREAM_MAGIC, sizeof(header.magic));
+    header.format = MESH_STREAM_FORMAT;
+    header.status = status;
+    ok = writeAll(fd, &header, sizeof(header));
+}
+
+
+void MeshStreamWriter::write(const float* vertices, const float* normals, size_t count) {
+    if (!ok || count == 0) return;
+    uint64_t floatCount = count;
+    ok = writeAll(fd, &floatCount, sizeof(floatCount)) &&
+         writeAll(fd, vertices, count * sizeof(float)) &&
+         writeAll(fd, normals, count * sizeof(float));
+    total += count;
+}
+
+
+bool MeshStreamWriter::finish() {
+    uint64_t end = 0;
+    ok = ok && writeAll(fd, &end, sizeof(end)) && writeAll(fd, &total, sizeof(total));
+    return ok;
+}
+
+
+bool readMeshStream(int fd, const ChunkCallback& onChunk, uint32_t* status) {
+    MeshStreamHeader header;
+    if (!readAll(fd, &header, sizeof(header)) ||
+        memcmp(header.magic, MESH_STREAM_MAGIC, sizeof(header.magic)) != 0 ||
+        header.format != MESH_STREAM_FORMAT) {
+        return false;
+    }
+    if (status != nullptr) *status = header.status;
+
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    uint64_t total = 0;
+    for (;;) {
+        uint64_t count;
+        if (!readAll(fd, &count, sizeof(count))) return false;
+        if (count == 0) break;
+        if (count > MESH_STREAM_MAX_CHUNK) return false;
+
+        vertices.resize(count);
+        normals.resize(count);
+        if (!readAll(fd, vertices.data(), count * sizeof(float)) ||
+            !readAll(fd, normals.data(), count * sizeof(float))) {
+            return false;
+        }
+        onChunk(vertices.data(), normals.data(), count);
+        total += count;
+    }
+
+    // A failed stream still ends normally, so the connection stays usable for the next one
+    uint64_t expected;
+    return readAll(fd, &expected, sizeof(expected)) && expected == total && header.status == 0;
+}
+
+
+bool readMeshStream(int fd, Mesh& mesh, uint32_t* status) {
+    return readMeshStream(fd, [&](const float* vertices, const float* normals, size_t count) {
+        mesh.vertices.insert(mesh.vertices.end(), vertices, vertices + count);
+        mesh.normals.insert(mesh.normals.end(), normals, normals + count);
+    }, status);
+}
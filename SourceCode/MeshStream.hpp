@@ -0,0 +1,102 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file MeshStream.hpp
+ *
+ * @brief A binary stream of mesh chunks over a pipe, file or socket.
+ * The stream is how other processes hand meshes to each other: the sender
+ * writes the triangles in chunks as they are extracted, so neither side
+ * has to hold a whole mesh before the transfer starts.
+ *
+ * Stream layout (native endianness):
+ *
+ * MeshStreamHeader: magic, format version and status (0 for success)
+ * chunks: floatCount (uint64_t), then floatCount vertex floats and floatCount normal floats
+ * end: a floatCount of 0, then the total float count (uint64_t) as a check
+ */
+
+#ifndef MESHSTREAM_HPP
+#define MESHSTREAM_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+
+const char MESH_STREAM_MAGIC[8] = {'I', 'S', 'O', 'S', 'T', 'R', 'M', '\0'};
+const uint32_t MESH_STREAM_FORMAT = 1;
+
+struct MeshStreamHeader {
+    char magic[8];
+    uint32_t format;
+    uint32_t status;
+};
+
+/***
+ * @brief Write a whole buffer to a file descriptor, retrying short and interrupted writes.
+ * @return bool True if every byte was written
+*/
+bool writeAll(int fd, const void* data, size_t size);
+
+/***
+ * @brief Read a whole buffer from a file descriptor, retrying short and interrupted reads.
+ * @return bool True if every byte was read before the end of the stream
+*/
+bool readAll(int fd, void* data, size_t size);
+
+/***
+ * MeshStreamWriter: writes the chunks of one mesh to a file descriptor
+*/
+class MeshStreamWriter {
+
+private:
+
+    int fd;
+    uint64_t total = 0;
+    bool ok = true;
+
+public:
+
+    /***
+     * @brief Write the stream header.
+     * @param fd Destination file descriptor, left open
+     * @param status 0 if a mesh follows, anything else to report a failure
+    */
+    MeshStreamWriter(int fd, uint32_t status = 0);
+
+    /***
+     * @brief Write one chunk of triangles; matches ChunkCallback.
+    */
+    void write(const float* vertices, const float* normals, size_t count);
+
+    /***
+     * @brief Write the end of the stream.
+     * @return bool True if the whole stream was written
+    */
+    bool finish();
+};
+
+/***
+ * @brief Read a mesh stream, delivering every chunk as it arrives.
+ * @param fd Source file descriptor
+ * @param onChunk Callback receiving every chunk, in order
+ * @param[out] status Optional, receives the status of the sender
+ * @return bool True if a complete, successful stream was read
+*/
+bool readMeshStream(int fd, const ChunkCallback& onChunk, uint32_t* status = nullptr);
+
+/***
+ * @brief Read a mesh stream and append its triangles to a mesh.
+*/
+bool readMeshStream(int fd, Mesh& mesh, uint32_t* status = nullptr);
+
+#endif // MESHSTREAM_HPP
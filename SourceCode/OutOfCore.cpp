@@ -0,0 +1,180 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file OutOfCore.cpp
+ *
+ * @brief Implementation of the out-of-core brick extraction.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include "OutOfCore.hpp"
+#include "PLYWriter.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+// Smallest share of the budget a brick runs with: 8x8 cells and a few hundred triangles
+const unsigned long long MIN_BRICK_BYTES = 64ULL << 10;
+
+
+/***
+ * @brief Path of the file holding one brick.
+*/
+static std::string brickPath(const std::string& directory, size_t brick) {
+    char name[32];
+    snprintf(name, sizeof(name), "brick_%06zu.bin", brick);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+
+OutOfCorePlan planOutOfCore(const GridAxes& axes, const OutOfCoreOptions& options) {
+    const size_t nx = axes.nx(), ny = axes.ny(), nz = axes.nz();
+    unsigned long long axesBytes = (axes.xs.size() + axes.ys.size() + axes.zs.size()) * sizeof(float);
+    unsigned long long budget = options.memoryBudget > axesBytes ? options.memoryBudget - axesBytes : 0;
+
+    OutOfCorePlan plan;
+    plan.threads = options.threads > 0 ? options.threads : ThreadPool::shared().size() + 1;
+    plan.threads = std::max<unsigned>(1, std::min<unsigned long long>(plan.threads, budget / MIN_BRICK_BYTES));
+    unsigned long long share = std::max(MIN_BRICK_BYTES, budget / plan.threads);
+    if (budget < MIN_BRICK_BYTES) {
+        fprintf(stderr, "Memory budget of %llu bytes is too small, using %llu bytes\n",
+                options.memoryBudget, axesBytes + MIN_BRICK_BYTES);
+    }
+
+    // Two planes of (b + 1)^2 samples in half of the share
+    size_t side = (size_t) sqrt((double) share / (4 * sizeof(float)));
+    plan.brickCells = std::max<size_t>(1, side > 1 ? side - 1 : 1);
+    plan.brickCells = std::min(plan.brickCells, std::max<size_t>(1, std::max(nx, std::max(ny, nz))));
+
+    // Vertices and normals in the other half, whole triangles only
+    plan.chunkFloats = std::max<size_t>(45, share / (4 * sizeof(float)) / 9 * 9);
+
+    const size_t b = plan.brickCells;
+    for (size_t i = 0; i < nx; i += b) {
+        for (size_t j = 0; j < ny; j += b) {
+            for (size_t k = 0; k < nz; k += b) {
+                plan.bricks.push_back({i, std::min(nx, i + b), j, std::min(ny, j + b), k, std::min(nz, k + b)});
+            }
+        }
+    }
+    plan.threads = std::max<unsigned>(1, std::min<size_t>(plan.threads, plan.bricks.size()));
+    return plan;
+}
+
+
+bool extractOutOfCore(const ScalarField& f, const Grid& grid, float isoval, const std::string& plyPath, const OutOfCoreOptions& options, size_t* triangles) {
+    const GridAxes axes = gridAxes(grid);
+    const OutOfCorePlan plan = planOutOfCore(axes, options);
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.scratchDirectory, ec);
+    if (ec) {
+        fprintf(stderr, "Failed to create scratch directory %s\n", options.scratchDirectory.c_str());
+        return false;
+    }
+
+    printf("Out-of-core extraction : %zu bricks of %zu cells per side, %u at once\n",
+           plan.bricks.size(), plan.brickCells, plan.threads);
+
+    // Extract every brick into its own file
+    std::vector<size_t> brickFloats(plan.bricks.size(), 0);
+    std::vector<MeshStats> brickStats(plan.bricks.size());
+    std::atomic<bool> failed(false);
+    std::atomic<size_t> completed(0);
+
+    ThreadPool::shared().parallelFor(plan.bricks.size(), [&](size_t b) {
+        if (failed.load()) return;
+        TRACE_SLAB_SCOPE("brick", b);
+
+        std::string path = brickPath(options.scratchDirectory, b);
+        FILE* out = fopen(path.c_str(), "wb");
+        if (out == NULL) {
+            fprintf(stderr, "Failed to write brick file %s\n", path.c_str());
+            failed = true;
+            return;
+        }
+
+        bool written = true;
+        bool ok = marching_cubes_brick(f, axes, plan.bricks[b], isoval, plan.chunkFloats, [&](const float* vertices, const float* normals, size_t count) {
+            TRACE_SLAB_SCOPE("brick_write", b);
+            uint64_t floatCount = count;
+            written = written && fwrite(&floatCount, sizeof(floatCount), 1, out) == 1;
+            written = written && fwrite(vertices, sizeof(float), count, out) == count;
+            written = written && fwrite(normals, sizeof(float), count, out) == count;
+            brickFloats[b] += count;
+        }, CancellationToken(), &brickStats[b]);
+        if (fclose(out) != 0 || !ok || !written) {
+            fprintf(stderr, "Failed to write brick file %s\n", path.c_str());
+            failed = true;
+        }
+
+        if (options.progress) options.progress(++completed, plan.bricks.size());
+    }, plan.threads);
+
+    // Stream the bricks into the PLY file
+    size_t totalFloats = 0;
+    for (size_t floats : brickFloats) totalFloats += floats;
+    MeshStats stats;
+    for (const MeshStats& part : brickStats) stats.merge(part);
+
+    if (!failed) {
+        TRACE_SCOPE("writePLY");
+        printf("Writing to PLY file : %s\n", plyPath.c_str());
+        std::ofstream ply(plyPath);
+        if (!ply.is_open()) {
+            fprintf(stderr, "Failed to open PLY file %s\n", plyPath.c_str());
+            failed = true;
+        } else {
+            writePLYHeader(ply, totalFloats / 3, &stats);
+            std::vector<float> vertices(plan.chunkFloats);
+            std::vector<float> normals(plan.chunkFloats);
+            for (size_t b = 0; b < plan.bricks.size() && !failed; ++b) {
+                std::string path = brickPath(options.scratchDirectory, b);
+                FILE* in = fopen(path.c_str(), "rb");
+                if (in == NULL) {
+                    fprintf(stderr, "Failed to read brick file %s\n", path.c_str());
+                    failed = true;
+                    break;
+                }
+                uint64_t count = 0;
+                while (fread(&count, sizeof(count), 1, in) == 1) {
+                    if (count > plan.chunkFloats ||
+                        fread(vertices.data(), sizeof(float), count, in) != count ||
+                        fread(normals.data(), sizeof(float), count, in) != count) {
+                        fprintf(stderr, "Corrupt brick file %s\n", path.c_str());
+                        failed = true;
+                        break;
+                    }
+                    writePLYVertices(ply, vertices.data(), normals.data(), count);
+                }
+                fclose(in);
+            }
+            writePLYFaces(ply, totalFloats / 3);
+            ply.close();
+            if (ply.fail()) failed = true;
+            else printf("Finished : %s\n", plyPath.c_str());
+        }
+    }
+
+    if (!options.keepBricks) {
+        for (size_t b = 0; b < plan.bricks.size(); ++b) std::filesystem::remove(brickPath(options.scratchDirectory, b), ec);
+        std::filesystem::remove(options.scratchDirectory, ec); // only succeeds once it is empty
+    }
+
+    if (triangles != nullptr) *triangles = totalFloats / 9;
+    return !failed;
+}
@@ -0,0 +1,90 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file OutOfCore.hpp
+ *
+ * @brief Out-of-core extraction of grids whose samples or mesh do not fit in memory.
+ * The grid is cut into cubic bricks of cells. Adjacent bricks overlap by one
+ * layer of corner samples: both sample their shared face at the coordinates
+ * of the whole grid, so they classify the border cells identically and the
+ * vertices on the seam are bit-identical in both bricks. Every cell belongs
+ * to exactly one brick, so the bricks together hold exactly the triangles of
+ * marching_cubes_async (in brick order instead of slab order).
+ *
+ * Bricks are extracted in parallel, each streaming its triangles into its
+ * own file in the scratch directory. Once every brick is done the files are
+ * streamed into the output PLY file and removed. The brick size and the
+ * size of the triangle buffers are derived from the memory budget, so peak
+ * memory depends on the budget and not on the size of the grid.
+ *
+ * Brick file layout (native endianness), repeated until the end of the file:
+ *
+ * floatCount: uint64_t
+ * vertices: floatCount floats
+ * normals: floatCount floats
+ */
+
+#ifndef OUTOFCORE_HPP
+#define OUTOFCORE_HPP
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "Fields.hpp"
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+
+/***
+ * OutOfCoreOptions: memory budget and scratch space of an out-of-core extraction
+*/
+struct OutOfCoreOptions {
+    unsigned long long memoryBudget = 256ULL << 20;    // Bytes of samples and triangle buffers held at once
+    std::string scratchDirectory = "OutOfCoreBricks";  // Where the brick meshes are written
+    unsigned threads = 0;                              // Bricks extracted at once, 0 for the whole shared pool
+    bool keepBricks = false;                           // Keep the brick files after the PLY file is written
+    ProgressCallback progress;                         // Receives the completed and total bricks
+};
+
+/***
+ * OutOfCorePlan: how a grid is cut into bricks for a memory budget
+*/
+struct OutOfCorePlan {
+    size_t brickCells;          // Cells along each side of a brick
+    size_t chunkFloats;         // Floats of vertices buffered per brick before they go to disk
+    unsigned threads;           // Bricks extracted at once
+    std::vector<CellBox> bricks;
+};
+
+/***
+ * @brief Cut a grid into bricks that fit a memory budget.
+ * Each concurrently extracted brick gets an equal share of the budget (after
+ * the grid coordinates), half of it for its two planes of samples and half
+ * for its vertex and normal buffers.
+ * @param axes Corner coordinates of the grid
+ * @param options The memory budget and thread count
+ * @return OutOfCorePlan The bricks in x, y, z order
+*/
+OutOfCorePlan planOutOfCore(const GridAxes& axes, const OutOfCoreOptions& options);
+
+/***
+ * @brief Extract an isosurface brick by brick and write it to a PLY file.
+ * @param f Scalar field, called concurrently from several threads
+ * @param grid The sampled box and step size
+ * @param isoval Isovalue
+ * @param plyPath The output PLY file path
+ * @param options The memory budget and scratch directory
+ * @param[out] triangles Optional, receives the number of triangles written
+ * @return bool True if every brick and the PLY file were written
+*/
+bool extractOutOfCore(const ScalarField& f, const Grid& grid, float isoval, const std::string& plyPath, const OutOfCoreOptions& options = OutOfCoreOptions(), size_t* triangles = nullptr);
+
+#endif // OUTOFCORE_HPP
@@ -0,0 +1,213 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file PLYWriter.cpp
+ *
+ * @brief Implementation of the PLY output of extracted meshes.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <functional>
+
+#include "PLYWriter.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+// Lines formatted by one task, about 1 MB of vertex text
+static const size_t PLY_CHUNK_LINES = 16384;
+
+// Upper bounds on the text of one line: six floats of at most 15 characters
+// ("-1.23456789e-38") and their separators, or "3 " and three integers
+static const size_t PLY_VERTEX_LINE_BYTES = 6 * 16;
+static const size_t PLY_FACE_LINE_BYTES = 2 + 3 * 21;
+
+
+/***
+ * @brief Format a float as printf's %.*g would, or as the shortest text that reads back as the same float.
+ * @param p Where to write, with room for 16 characters
+ * @param value The float
+ * @param precision Significant digits, 0 for the shortest round-trip text
+ * @return char* The end of the text
+*/
+static char* appendFloat(char* p, float value, int precision) {
+    if (precision <= 0) return std::to_chars(p, p + 16, value).ptr;
+    return std::to_chars(p, p + 16, value, std::chars_format::general, std::min(precision, 9)).ptr;
+}
+
+
+template <typename T>
+static char* appendInteger(char* p, T value) {
+    return std::to_chars(p, p + 20, value).ptr;
+}
+
+
+/***
+ * @brief Format lines in chunks on the shared thread pool and write the chunks in order.
+ * A few chunks per thread are formatted at a time, so the text held in
+ * memory stays bounded however large the mesh is.
+ * @param out The output stream
+ * @param lines Number of lines
+ * @param lineBytes Upper bound on the length of one line
+ * @param format Formats lines [begin, end) into a buffer and returns the end of the text
+*/
+static void writeLines(std::ostream& out, size_t lines, size_t lineBytes,
+                       const std::function<char*(char*, size_t, size_t)>& format) {
+    ThreadPool& pool = ThreadPool::shared();
+    size_t chunks = (lines + PLY_CHUNK_LINES - 1) / PLY_CHUNK_LINES;
+    size_t window = std::min(chunks, std::max<size_t>(2, 2 * pool.size()));
+    std::vector<std::vector<char>> buffers(window);
+    std::vector<size_t> lengths(window);
+
+    for (size_t first = 0; first < chunks; first += window) {
+        size_t count = std::min(window, chunks - first);
+        pool.parallelFor(count, [&](size_t c) {
+            size_t begin = (first + c) * PLY_CHUNK_LINES;
+            size_t end = std::min(lines, begin + PLY_CHUNK_LINES);
+            buffers[c].resize(PLY_CHUNK_LINES * lineBytes);
+            lengths[c] = format(buffers[c].data(), begin, end) - buffers[c].data();
+        });
+        for (size_t c = 0; c < count && out; ++c) out.write(buffers[c].data(), lengths[c]);
+    }
+}
+
+
+void writePLYHeader(std::ostream& out, size_t vertexCount, const MeshStats* stats) {
+    writePLYHeader(out, vertexCount, vertexCount / 3, stats);
+}
+
+
+void writePLYHeader(std::ostream& out, size_t vertexCount, size_t faceCount, const MeshStats* stats) {
+    out << "ply\n";
+    out << "format ascii 1.0\n";
+    if (stats != nullptr && stats->triangles > 0) {
+        char comments[256];
+        snprintf(comments, sizeof(comments), "comment area %.9g\ncomment volume %.9g\ncomment bounds %.9g %.9g %.9g %.9g %.9g %.9g\n",
+                 stats->area, stats->volume, stats->min[0], stats->min[1], stats->min[2], stats->max[0], stats->max[1], stats->max[2]);
+        out << comments;
+    }
+    out << "element vertex " << vertexCount << "\n";
+    out << "property float x\n";
+    out << "property float y\n";
+    out << "property float z\n";
+    out << "property float nx\n";
+    out << "property float ny\n";
+    out << "property float nz\n";
+    out << "element face " << faceCount << "\n";
+    out << "property list uchar int vertex_indices\n";
+    out << "end_header\n";
+}
+
+
+void writePLYVertices(std::ostream& out, const float* vertices, const float* normals, size_t floatCount, int precision) {
+    writeLines(out, floatCount / 3, PLY_VERTEX_LINE_BYTES, [&](char* p, size_t begin, size_t end) {
+        for (size_t i = 3 * begin; i < 3 * end; i += 3) {
+            p = appendFloat(p, vertices[i], precision);
+            *p++ = ' ';
+            p = appendFloat(p, vertices[i + 1], precision);
+            *p++ = ' ';
+            p = appendFloat(p, vertices[i + 2], precision);
+            *p++ = ' ';
+            p = appendFloat(p, normals[i], precision);
+            *p++ = ' ';
+            p = appendFloat(p, normals[i + 1], precision);
+            *p++ = ' ';
+            p = appendFloat(p, normals[i + 2], precision);
+            *p++ = '\n';
+        }
+        return p;
+    });
+}
+
+
+void writePLYFaces(std::ostream& out, size_t vertexCount) {
+    writeLines(out, vertexCount / 3, PLY_FACE_LINE_BYTES, [&](char* p, size_t begin, size_t end) {
+        for (size_t i = 3 * begin; i < 3 * end; i += 3) {
+            *p++ = '3';
+            *p++ = ' ';
+            p = appendInteger(p, i);
+            *p++ = ' ';
+            p = appendInteger(p, i + 1);
+            *p++ = ' ';
+            p = appendInteger(p, i + 2);
+            *p++ = '\n';
+        }
+        return p;
+    });
+}
+
+
+void writePLYFaces(std::ostream& out, const std::vector<uint32_t>& indices) {
+    writeLines(out, indices.size() / 3, PLY_FACE_LINE_BYTES, [&](char* p, size_t begin, size_t end) {
+        for (size_t i = 3 * begin; i < 3 * end; i += 3) {
+            *p++ = '3';
+            *p++ = ' ';
+            p = appendInteger(p, indices[i]);
+            *p++ = ' ';
+            p = appendInteger(p, indices[i + 1]);
+            *p++ = ' ';
+            p = appendInteger(p, indices[i + 2]);
+            *p++ = '\n';
+        }
+        return p;
+    });
+}
+
+
+bool writePLY(const std::vector<float>& vertices, const std::vector<float>& normals, const std::string& outputPath, int precision, const MeshStats* stats) {
+    assert(vertices.size() == normals.size());
+    assert(vertices.size() % 9 == 0); // Ensure that vertices can form complete triangles
+
+    printf("Writing to PLY file : %s\n", outputPath.c_str());
+
+    TRACE_SCOPE("writePLY");
+    std::ofstream outputFile(outputPath);
+    if (!outputFile.is_open()) {
+        fprintf(stderr, "Failed to open PLY file %s\n", outputPath.c_str());
+        return false;
+    }
+
+    writePLYHeader(outputFile, vertices.size() / 3, stats);
+    writePLYVertices(outputFile, vertices.data(), normals.data(), vertices.size(), precision);
+    writePLYFaces(outputFile, vertices.size() / 3);
+
+	printf("Finished : %s\n", outputPath.c_str());
+
+    outputFile.close();
+    return !outputFile.fail();
+}
+
+
+bool writePLY(const IndexedMesh& mesh, const std::string& outputPath, int precision, const MeshStats* stats) {
+    assert(mesh.positions.size() == mesh.normals.size());
+    assert(mesh.indices.size() % 3 == 0);
+
+    printf("Writing to PLY file : %s\n", outputPath.c_str());
+
+    TRACE_SCOPE("writePLY");
+    std::ofstream outputFile(outputPath);
+    if (!outputFile.is_open()) {
+        fprintf(stderr, "Failed to open PLY file %s\n", outputPath.c_str());
+        return false;
+    }
+
+    writePLYHeader(outputFile, mesh.vertexCount(), mesh.triangleCount(), stats);
+    writePLYVertices(outputFile, mesh.positions.data(), mesh.normals.data(), mesh.positions.size(), precision);
+    writePLYFaces(outputFile, mesh.indices);
+
+    printf("Finished : %s\n", outputPath.c_str());
+
+    outputFile.close();
+    return !outputFile.fail();
+}
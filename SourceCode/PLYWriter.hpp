@@ -0,0 +1,113 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file PLYWriter.hpp
+ *
+ * @brief PLY output of extracted meshes.
+ * The files are ASCII PLY. The vertex and face lines are formatted with
+ * std::to_chars into large buffers, a chunk of lines per task on the shared
+ * thread pool, and the buffers are written in order, so the text is exactly
+ * what a sequential writer would produce. Floats are written with 6
+ * significant digits like the default of a C++ stream (the triangle-soup
+ * files of earlier versions are reproduced byte for byte), or with the
+ * shortest digits that read back as the same float when the precision is 0.
+ *
+ * When the statistics of the mesh are known (see MeshStats) they are written
+ * as comments after the format line, which PLY readers skip:
+ *
+ * comment area 314.159
+ * comment volume 523.598
+ * comment bounds -5 -5 -5 5 5 5
+ */
+
+#ifndef PLYWRITER_HPP
+#define PLYWRITER_HPP
+
+#include <stddef.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "IndexedMesh.hpp"
+#include "Mesh.hpp"
+
+// Significant digits of the written floats; 0 writes the shortest round-trip digits
+const int PLY_DEFAULT_PRECISION = 6;
+
+/***
+ * @brief Write the ASCII PLY header of a triangle soup.
+ * @param out The output stream
+ * @param vertexCount Number of vertices, three per face
+ * @param stats Optional area, volume and bounds, written as comments
+*/
+void writePLYHeader(std::ostream& out, size_t vertexCount, const MeshStats* stats = nullptr);
+
+/***
+ * @brief Write the ASCII PLY header of a mesh with shared vertices.
+ * @param out The output stream
+ * @param vertexCount Number of vertices
+ * @param faceCount Number of triangles
+ * @param stats Optional area, volume and bounds, written as comments
+*/
+void writePLYHeader(std::ostream& out, size_t vertexCount, size_t faceCount, const MeshStats* stats = nullptr);
+
+/***
+ * @brief Write vertex lines (position and normal) of a triangle soup.
+ * Writers that stream a mesh call this once per chunk, between the header and the faces.
+ * @param out The output stream
+ * @param vertices Vertex coordinates
+ * @param normals Normal coordinates
+ * @param floatCount Number of floats in each of vertices and normals
+ * @param precision Significant digits (at most 9), 0 for the shortest round-trip digits
+*/
+void writePLYVertices(std::ostream& out, const float* vertices, const float* normals, size_t floatCount,
+                      int precision = PLY_DEFAULT_PRECISION);
+
+/***
+ * @brief Write the face lines of a triangle soup (3 i i+1 i+2 per triangle).
+ * @param out The output stream
+ * @param vertexCount Number of vertices written
+*/
+void writePLYFaces(std::ostream& out, size_t vertexCount);
+
+/***
+ * @brief Write the face lines of an index buffer (three indices per triangle).
+ * @param out The output stream
+ * @param indices The index buffer
+*/
+void writePLYFaces(std::ostream& out, const std::vector<uint32_t>& indices);
+
+/***
+ * @brief Write the vertices and normals to a PLY file.
+ * @param vertices A list of vertices
+ * @param normals A list of normals
+ * @param outputPath The output PLY file path
+ * @param precision Significant digits of the floats, 0 for the shortest round-trip digits
+ * @param stats Optional statistics of the mesh, written as comments
+ * @return bool True if the file was written
+*/
+bool writePLY(const std::vector<float>& vertices, const std::vector<float>& normals, const std::string& outputPath,
+              int precision = PLY_DEFAULT_PRECISION, const MeshStats* stats = nullptr);
+
+/***
+ * @brief Write an indexed mesh with its vertex normals to a PLY file.
+ * Shared vertices are written once, so the file is about a third of the size
+ * of the triangle soup's.
+ * @param mesh The mesh, with normals (see computeVertexNormals)
+ * @param outputPath The output PLY file path
+ * @param precision Significant digits of the floats, 0 for the shortest round-trip digits
+ * @param stats Optional statistics of the mesh (those of the soup it was welded from), written as comments
+ * @return bool True if the file was written
+*/
+bool writePLY(const IndexedMesh& mesh, const std::string& outputPath, int precision = PLY_DEFAULT_PRECISION,
+              const MeshStats* stats = nullptr);
+
+#endif // PLYWRITER_HPP
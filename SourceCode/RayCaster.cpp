@@ -0,0 +1,343 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file RayCaster.cpp
+ *
+ * @brief Implementation of the mesh-free isosurface ray caster.
+ */
+
+#include <float.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "HelperFunctions.hpp"
+#include "RayCaster.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+// Largest distance, in macro cells, kept from a cell to the nearest cell holding the isovalue
+const unsigned MAX_CLEARANCE = 16;
+
+// Width of a bracket, in smallest steps, below which its crossing is not refined further
+const float REFINE_TOLERANCE = 1e-3f;
+
+
+/***
+ * @brief Chebyshev distances along one more axis, from those along the axes before.
+ * @param[in,out] distance One value per macro cell, MAX_CLEARANCE at most
+ * @param stride Distance between neighbouring cells along the axis
+ * @param count Cells along the axis
+*/
+static void clearanceAxis(std::vector<uint8_t>& distance, size_t stride, size_t count) {
+    std::vector<uint8_t> along(distance.size());
+    for (size_t c = 0; c < distance.size(); ++c) {
+        const int64_t at = c / stride % count;
+        unsigned nearest = MAX_CLEARANCE;
+        for (int64_t o = -(int64_t) MAX_CLEARANCE + 1; o < (int64_t) MAX_CLEARANCE; ++o) {
+            if (at + o < 0 || at + o >= (int64_t) count) continue;
+            nearest = std::min<unsigned>(nearest, std::max<unsigned>(std::abs(o), distance[c + o * stride]));
+        }
+        along[c] = nearest;
+    }
+    distance.swap(along);
+}
+
+
+RayCaster::RayCaster(const ScalarField& f, const Grid& box, float isovalue, const RayCastOptions& options)
+    : field(f), iso(isovalue), cast(options) {
+    TRACE_SCOPE("raycast_build");
+    min[0] = box.minx;
+    min[1] = box.miny;
+    min[2] = box.minz;
+    max[0] = box.maxx;
+    max[1] = box.maxy;
+    max[2] = box.maxz;
+    const float longest = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2]});
+    for (int a = 0; a < 3; ++a) {
+        const float extent = max[a] - min[a];
+        cells[a] = longest > 0.0f ? std::max<size_t>(1, std::lround(std::max(1u, cast.macroCells) * extent / longest)) : 1;
+        cellSize[a] = std::max(0.0f, extent) / cells[a];
+    }
+    const float side = std::min({cellSize[0], cellSize[1], cellSize[2]});
+    stepLength = cast.minStep * side;
+    stepScale.assign(cells[0] * cells[1] * cells[2], 0.0f);
+    if (!(side > 0.0f)) return;
+
+    // The value and, without a given bound, the gradient magnitude at every corner of the macro cells
+    const size_t cx = cells[0] + 1, cy = cells[1] + 1, cz = cells[2] + 1;
+    std::vector<float> values(cx * cy * cz), slopes(cx * cy * cz, 0.0f);
+    const float h = 0.5f * stepLength;
+    ThreadPool::shared().parallelFor(cx, [&](size_t i) {
+        const float x = i == cells[0] ? max[0] : min[0] + i * cellSize[0];
+        for (size_t j = 0; j < cy; ++j) {
+            const float y = j == cells[1] ? max[1] : min[1] + j * cellSize[1];
+            for (size_t k = 0; k < cz; ++k) {
+                const float z = k == cells[2] ? max[2] : min[2] + k * cellSize[2];
+                const size_t c = (i * cy + j) * cz + k;
+                values[c] = field(x, y, z);
+                if (cast.lipschitz > 0.0f) continue;
+                const float gx = field(x + h, y, z) - field(x - h, y, z);
+                const float gy = field(x, y + h, z) - field(x, y - h, z);
+                const float gz = field(x, y, z + h) - field(x, y, z - h);
+                slopes[c] = std::sqrt(gx * gx + gy * gy + gz * gz) / (2.0f * h);
+            }
+        }
+    }, cast.threads);
+
+    // Every point of a cell is within half a diagonal of one of its corners
+    const float halfDiagonal = 0.5f * std::sqrt(cellSize[0] * cellSize[0] + cellSize[1] * cellSize[1] + cellSize[2] * cellSize[2]);
+    size_t active = 0;
+    for (size_t i = 0; i < cells[0]; ++i) {
+        for (size_t j = 0; j < cells[1]; ++j) {
+            for (size_t k = 0; k < cells[2]; ++k) {
+                float lo = FLT_MAX, hi = -FLT_MAX, slope = 0.0f;
+                for (int n = 0; n < 8; ++n) {
+                    const size_t c = ((i + (n & 1)) * cy + j + (n >> 1 & 1)) * cz + k + (n >> 2 & 1);
+                    lo = std::min(lo, values[c]);
+                    hi = std::max(hi, values[c]);
+                    slope = std::max(slope, slopes[c]);
+                }
+
+                // Corners at least a side apart bound the slope from below as well as the gradients
+                float lipschitz = cast.lipschitz;
+                if (!(lipschitz > 0.0f)) lipschitz = cast.lipschitzScale * std::max(slope, (hi - lo) / side);
+                if (lo - lipschitz * halfDiagonal <= iso && hi + lipschitz * halfDiagonal >= iso) {
+                    stepScale[(i * cells[1] + j) * cells[2] + k] = 1.0f / std::max(lipschitz, FLT_MIN);
+                    active++;
+                }
+            }
+        }
+    }
+    activeCells = active;
+
+    // How far rays can skip from every cell without the isovalue
+    clearance.assign(stepScale.size(), 0);
+    for (size_t c = 0; c < stepScale.size(); ++c) clearance[c] = stepScale[c] > 0.0f ? 0 : MAX_CLEARANCE;
+    clearanceAxis(clearance, cells[1] * cells[2], cells[0]);
+    clearanceAxis(clearance, cells[2], cells[1]);
+    clearanceAxis(clearance, 1, cells[2]);
+    TRACE_COUNT("raycast_active_cells", active);
+}
+
+
+float RayCaster::refine(const float* origin, const float* direction, float a, float va, float b, float vb, RayCastStats& stats) const {
+    // The Illinois variant of false position: an end kept twice in a row has its value halved
+    int side = 0;
+    for (unsigned r = 0; r < cast.refineSteps && b - a > REFINE_TOLERANCE * stepLength; ++r) {
+        const float m = (a * vb - b * va) / (vb - va);
+        stats.evaluations++;
+        const float vm = field(origin[0] + direction[0] * m, origin[1] + direction[1] * m, origin[2] + direction[2] * m) - iso;
+        if (vm == 0.0f) return m;
+        if ((vm < 0.0f) == (va < 0.0f)) {
+            a = m;
+            va = vm;
+            if (side == -1) vb *= 0.5f;
+            side = -1;
+        } else {
+            b = m;
+            vb = vm;
+            if (side == 1) va *= 0.5f;
+            side = 1;
+        }
+    }
+    return (a * vb - b * va) / (vb - va);
+}
+
+
+bool RayCaster::traceRay(const float* origin, const float* direction, float& hit, RayCastStats& stats) const {
+    // Clip the ray to the box
+    float t0 = 0.0f, t1 = FLT_MAX;
+    for (int a = 0; a < 3; ++a) {
+        if (direction[a] == 0.0f) {
+            if (origin[a] < min[a] || origin[a] > max[a]) return false;
+            continue;
+        }
+        float enter = (min[a] - origin[a]) / direction[a];
+        float leave = (max[a] - origin[a]) / direction[a];
+        if (enter > leave) std::swap(enter, leave);
+        t0 = std::max(t0, enter);
+        t1 = std::min(t1, leave);
+    }
+    if (!(t0 < t1) || !(stepLength > 0.0f)) return false;
+
+    // The macro cell the ray enters first, and where it next leaves a slab of cells along each axis
+    int64_t cell[3], step[3];
+    float next[3], delta[3];
+    for (int a = 0; a < 3; ++a) {
+        const float p = origin[a] + direction[a] * t0;
+        cell[a] = std::min<int64_t>((int64_t) cells[a] - 1, std::max<int64_t>(0, (int64_t) std::floor((p - min[a]) / cellSize[a])));
+        step[a] = direction[a] > 0.0f ? 1 : direction[a] < 0.0f ? -1 : 0;
+        if (step[a] == 0) {
+            next[a] = FLT_MAX;
+            delta[a] = FLT_MAX;
+            continue;
+        }
+        const float boundary = min[a] + (cell[a] + (step[a] > 0)) * cellSize[a];
+        next[a] = (boundary - origin[a]) / direction[a];
+        delta[a] = cellSize[a] / std::fabs(direction[a]);
+    }
+
+    auto value = [&](float t) {
+        stats.evaluations++;
+        return field(origin[0] + direction[0] * t, origin[1] + direction[1] * t, origin[2] + direction[2] * t) - iso;
+    };
+
+    // The last sample is carried across adjacent cells that hold the isovalue
+    bool sampled = false;
+    float ts = t0, vs = 0.0f;
+    unsigned steps = 0;
+    float t = t0;
+    while (true) {
+        const size_t index = ((size_t) cell[0] * cells[1] + cell[1]) * cells[2] + cell[2];
+        const float scale = stepScale[index];
+        if (scale == 0.0f) {
+            stats.skips++;
+            sampled = false;
+
+            // No cell within clearance - 1 cells of this one holds the isovalue, so the ray
+            // leaves that whole cube of cells at once, crossing as many slabs of each axis as it spans
+            const int64_t radius = clearance[index] - 1;
+            const int axis = next[0] + radius * delta[0] < next[1] + radius * delta[1]
+                ? (next[0] + radius * delta[0] < next[2] + radius * delta[2] ? 0 : 2)
+                : (next[1] + radius * delta[1] < next[2] + radius * delta[2] ? 1 : 2);
+            const float leave = next[axis] + radius * delta[axis];
+            if (leave >= t1) return false;
+            for (int a = 0; a < 3; ++a) {
+                if (!(next[a] <= leave)) continue;
+                const int64_t crossed = a == axis ? radius + 1 : (int64_t) ((leave - next[a]) / delta[a]) + 1;
+                cell[a] += step[a] * crossed;
+                next[a] += crossed * delta[a];
+                if (cell[a] < 0 || cell[a] >= (int64_t) cells[a]) return false;
+            }
+            t = leave;
+            continue;
+        }
+
+        stats.steppedCells++;
+        const int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+        const float exit = std::min(next[axis], t1);
+        if (!sampled) {
+            ts = t;
+            vs = value(ts);
+            sampled = true;
+        }
+        while (ts < exit) {
+            if (vs == 0.0f) {
+                hit = ts;
+                return true;
+            }
+            if (++steps > cast.maxSteps) return false;
+
+            // The field cannot reach the isovalue within |f - iso| / L of a sample
+            const float tn = std::min(exit, ts + std::max(std::fabs(vs) * scale, stepLength));
+            const float vn = value(tn);
+            if (vn == 0.0f || (vn < 0.0f) != (vs < 0.0f)) {
+                hit = vn == 0.0f ? tn : refine(origin, direction, ts, vs, tn, vn, stats);
+                return true;
+            }
+            ts = tn;
+            vs = vn;
+        }
+
+        if (exit >= t1) return false;
+        t = exit;
+        cell[axis] += step[axis];
+        if (cell[axis] < 0 || cell[axis] >= (int64_t) cells[axis]) return false;
+        next[axis] += delta[axis];
+    }
+}
+
+
+Image RayCaster::render(const RenderOptions& options, RayCastStats* stats) const {
+    TRACE_SCOPE("raycast_render");
+    auto start = std::chrono::steady_clock::now();
+    const unsigned samples = std::max(1u, options.supersample);
+    const unsigned width = options.width * samples;
+    const unsigned height = options.height * samples;
+    const unsigned tileSize = std::max(1u, options.tileSize / samples);
+    const unsigned tilesX = (options.width + tileSize - 1) / tileSize;
+    const unsigned tilesY = (options.height + tileSize - 1) / tileSize;
+    const size_t tileCount = (size_t) tilesX * tilesY;
+
+    // The viewer's camera: orbiting the origin, light at the eye. Shading happens in world
+    // space translated to the eye, where the Phong model gives the same as in camera space.
+    const glm::vec3 eye = sphericalToCartesian(options.r, options.theta, options.phi);
+    const glm::vec3 forward = glm::normalize(-eye);
+    const glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+    const glm::vec3 up = glm::cross(right, forward);
+    const float tanHalf = std::tan(glm::radians(options.fieldOfView) * 0.5f);
+    const float aspect = (float) width / height;
+    const float origin[3] = {eye.x, eye.y, eye.z};
+    const float light[3] = {0.0f, 0.0f, 0.0f};
+    const float h = 0.5f * stepLength;
+
+    Image image;
+    image.width = options.width;
+    image.height = options.height;
+    image.rgb.resize(3 * (size_t) image.width * image.height);
+    std::vector<RayCastStats> tileStats(tileCount);
+    ThreadPool::shared().parallelFor(tileCount, [&](size_t i) {
+        TRACE_SCOPE("raycast_tile");
+        RayCastStats& counted = tileStats[i];
+        const unsigned x0 = (i % tilesX) * tileSize, y0 = (i / tilesX) * tileSize;
+        for (unsigned y = y0; y < std::min(options.height, y0 + tileSize); ++y) {
+            for (unsigned x = x0; x < std::min(options.width, x0 + tileSize); ++x) {
+                float sum[3] = {0.0f, 0.0f, 0.0f};
+                for (unsigned sy = 0; sy < samples; ++sy) {
+                    for (unsigned sx = 0; sx < samples; ++sx) {
+                        // Through the centre of the sample, like the rasterizer
+                        const float u = (2.0f * (x * samples + sx + 0.5f) / width - 1.0f) * tanHalf * aspect;
+                        const float v = (1.0f - 2.0f * (y * samples + sy + 0.5f) / height) * tanHalf;
+                        const glm::vec3 ray = glm::normalize(forward + u * right + v * up);
+                        const float direction[3] = {ray.x, ray.y, ray.z};
+                        float color[3] = {options.background[0], options.background[1], options.background[2]};
+                        float t = 0.0f;
+                        counted.rays++;
+                        if (traceRay(origin, direction, t, counted)) {
+                            counted.hits++;
+                            counted.evaluations += 6;
+
+                            // The gradient points towards higher values, like the normals of the extracted meshes
+                            const float px = origin[0] + direction[0] * t, py = origin[1] + direction[1] * t, pz = origin[2] + direction[2] * t;
+                            const float normal[3] = {field(px + h, py, pz) - field(px - h, py, pz),
+                                                     field(px, py + h, pz) - field(px, py - h, pz),
+                                                     field(px, py, pz + h) - field(px, py, pz - h)};
+                            const float position[3] = {direction[0] * t, direction[1] * t, direction[2] * t};
+                            shadePhong(color, position, normal, light, options);
+                        }
+                        for (int c = 0; c < 3; ++c) sum[c] += color[c];
+                    }
+                }
+
+                // Average the samples of the pixel and convert to 8 bits like a unorm framebuffer
+                uint8_t* pixel = &image.rgb[3 * ((size_t) y * image.width + x)];
+                for (int c = 0; c < 3; ++c) pixel[c] = (uint8_t) std::lround(std::min(1.0f, std::max(0.0f, sum[c] / (samples * samples))) * 255.0f);
+            }
+        }
+    }, options.threads);
+
+    RayCastStats counted;
+    for (const RayCastStats& tile : tileStats) {
+        counted.rays += tile.rays;
+        counted.hits += tile.hits;
+        counted.evaluations += tile.evaluations;
+        counted.skips += tile.skips;
+        counted.steppedCells += tile.steppedCells;
+    }
+    counted.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TRACE_COUNT("raycast_evaluations", counted.evaluations);
+    if (stats != nullptr) *stats = counted;
+    return image;
+}
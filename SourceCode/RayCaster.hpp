@@ -0,0 +1,140 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file RayCaster.hpp
+ *
+ * @brief Previews of an isosurface ray cast straight from the field, without a mesh.
+ * Every pixel casts a ray from the viewer's camera through the box of the
+ * extraction grid and stops at the first point where the field crosses the
+ * isovalue, which is shaded with the same Phong model as renderMesh. The
+ * step size of the grid plays no part: the cost of an image depends on its
+ * size and on the field, and no triangle is ever stored.
+ *
+ * A ray does not sample the field at fixed intervals. The box is covered by a
+ * coarse grid of macro cells, each holding an interval of the values of the
+ * field inside it and a Lipschitz bound, a bound on the magnitude of its
+ * gradient there, both computed once from the corners of the cell. A ray
+ * walks the macro cells in order and skips every cell whose interval does
+ * not hold the isovalue, together with the cube of cells around it that
+ * are as far from any cell holding it; in the others it steps by |f - isovalue| / L, a
+ * distance over which the field cannot reach the isovalue, until two
+ * samples bracket a crossing, which false position then refines.
+ *
+ * The bounds are estimated from the gradients and differences at the
+ * corners, scaled by a safety factor, so a feature much smaller than a
+ * macro cell can be missed; a field with a known bound (1 for a signed
+ * distance such as a CSGScene) can give it instead, which makes every step
+ * safe. As with the meshes, a surface that only touches the isovalue
+ * without crossing it is not drawn.
+ *
+ * Example:
+ *
+ * RayCaster caster(f4, Grid::cube(-5, 5, 0.1f), 0.0f);
+ * Image image = caster.render(RenderOptions());
+ */
+
+#ifndef RAYCASTER_HPP
+#define RAYCASTER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "Fields.hpp"
+#include "ImageWriter.hpp"
+#include "Mesh.hpp"
+#include "SoftwareRenderer.hpp"
+
+/***
+ * RayCastOptions: how rays march through the field
+*/
+struct RayCastOptions {
+    unsigned macroCells = 64;     // Macro cells along the longest side of the box
+    float lipschitz = 0.0f;       // A bound on the gradient magnitude of the field, 0 to estimate one per macro cell
+    float lipschitzScale = 1.5f;  // Safety factor on the estimated bounds
+    float minStep = 0.125f;       // Smallest step along a ray, in macro cells
+    unsigned refineSteps = 16;    // Most refinement steps on a bracketed crossing
+    unsigned maxSteps = 4096;     // Steps of one ray, after which it counts as a miss
+    unsigned threads = 0;         // Building the macro cells, 0 for the whole shared pool
+};
+
+/***
+ * RayCastStats: the work of one render
+*/
+struct RayCastStats {
+    size_t rays = 0;
+    size_t hits = 0;
+    size_t evaluations = 0;   // Field evaluations along the rays, including the normals
+    size_t skips = 0;         // Jumps of rays over cubes of macro cells without the isovalue
+    size_t steppedCells = 0;  // Macro cells rays sampled
+    double seconds = 0.0;
+};
+
+/***
+ * RayCaster: an isosurface of a field, ready to be ray cast from any camera
+*/
+class RayCaster {
+
+private:
+
+    ScalarField field;
+    float iso;
+    RayCastOptions cast;
+    float min[3];
+    float max[3];
+    size_t cells[3];
+    float cellSize[3];
+    float stepLength;
+    std::vector<float> stepScale;     // 1 / the Lipschitz bound of each macro cell, 0 for a cell without the isovalue
+    std::vector<uint8_t> clearance;   // Chebyshev distance in cells to the nearest cell with the isovalue
+    size_t activeCells = 0;
+
+    /***
+     * @brief March one ray from the camera to the first crossing of the isovalue in the box.
+     * @param direction Unit direction, so that distances along the ray are lengths
+     * @param[out] hit Distance from the origin to the crossing
+     * @return bool False if the ray leaves the box without crossing
+    */
+    bool traceRay(const float* origin, const float* direction, float& hit, RayCastStats& stats) const;
+
+    /***
+     * @brief The crossing between two samples of a ray on either side of the isovalue.
+     * @param a, va Distance and value less the isovalue of the nearer sample
+     * @param b, vb The same for the farther sample, vb != 0
+     * @return float Distance to the crossing
+    */
+    float refine(const float* origin, const float* direction, float a, float va, float b, float vb, RayCastStats& stats) const;
+
+public:
+
+    /***
+     * @brief Evaluate the macro cells of a field around an isovalue.
+     * @param f The field, called concurrently from several threads
+     * @param box The box rays are clipped to; its step size is not used
+     * @param isovalue Isovalue of the surface
+     * @param options How rays march
+    */
+    RayCaster(const ScalarField& f, const Grid& box, float isovalue, const RayCastOptions& options = RayCastOptions());
+
+    /***
+     * @brief Ray cast the surface into an image.
+     * @param options Image, camera and material, as for renderMesh; tileSize
+     * pixels of each side make up one task
+     * @param[out] stats Optional, receives what the render did
+     * @return Image The rendered image
+    */
+    Image render(const RenderOptions& options = RenderOptions(), RayCastStats* stats = nullptr) const;
+
+    size_t macroCellCount() const { return stepScale.size(); }
+    size_t activeCellCount() const { return activeCells; }
+};
+
+#endif // RAYCASTER_HPP
@@ -0,0 +1,381 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file RegionOfInterest.cpp
+ *
+ * @brief Implementation of the region-of-interest refinement.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include "RegionOfInterest.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+
+/***
+ * @brief Index of the cell of an axis containing a coordinate, or -1 / n outside it.
+*/
+static long cellOf(const std::vector<float>& corners, float v) {
+    return (long) (std::upper_bound(corners.begin(), corners.end(), v) - corners.begin()) - 1;
+}
+
+
+/***
+ * @brief The cells [first, last) of an axis covering [min, max].
+*/
+static void coverCells(const std::vector<float>& corners, float min, float max, size_t& first, size_t& last) {
+    const long n = corners.size() - 1;
+    long lo = std::max(0L, cellOf(corners, min));
+    long hi = std::min(n, (long) (std::lower_bound(corners.begin(), corners.end(), max) - corners.begin()));
+    first = std::min(lo, n);
+    last = std::max(hi, (long) first);
+}
+
+
+CellBox regionCells(const GridAxes& axes, const RegionOfInterest& roi) {
+    CellBox box;
+    coverCells(axes.xs, roi.minx, roi.maxx, box.i0, box.i1);
+    coverCells(axes.ys, roi.miny, roi.maxy, box.j0, box.j1);
+    coverCells(axes.zs, roi.minz, roi.maxz, box.k0, box.k1);
+    return box;
+}
+
+
+/***
+ * @brief Split the cells [first, last) of an axis into refinement cells each.
+*/
+static std::vector<float> refineAxis(const std::vector<float>& corners, size_t first, size_t last, unsigned refinement) {
+    std::vector<float> fine;
+    for (size_t i = first; i < last; ++i) {
+        fine.push_back(corners[i]);
+        for (unsigned s = 1; s < refinement; ++s) {
+            fine.push_back(corners[i] + (corners[i + 1] - corners[i]) * s / refinement);
+        }
+    }
+    fine.push_back(corners[last]);
+    return fine;
+}
+
+
+GridAxes refineAxes(const GridAxes& axes, const CellBox& box, unsigned refinement) {
+    GridAxes fine;
+    fine.xs = refineAxis(axes.xs, box.i0, box.i1, refinement);
+    fine.ys = refineAxis(axes.ys, box.j0, box.j1, refinement);
+    fine.zs = refineAxis(axes.zs, box.k0, box.k1, refinement);
+    fine.stepsize = axes.stepsize / refinement;
+    return fine;
+}
+
+
+/***
+ * SeamPlane: one face of the region with coarse cells on its outer side
+*/
+struct SeamPlane {
+    int axis;            // Axis the face is perpendicular to
+    float coordinate;    // Corner coordinate of the face along it
+};
+
+/***
+ * SeamSegment: a triangle edge lying in a face of the region
+*/
+struct SeamSegment {
+    size_t plane;
+    long cu, cv;          // Coarse cell of the face holding the edge, along the two other axes
+    float a[2], b[2];     // Endpoints in the two other axes
+    float normal;         // Normal of the triangle along the axis of the face
+};
+
+/***
+ * SeamPoint: an endpoint of the segments of one cell face and the points it is joined to
+*/
+struct SeamPoint {
+    float u, v;
+    std::vector<size_t> links;
+};
+
+
+/***
+ * @brief Add the edges of a triangle that lie in a face of the region to the seam.
+ * @param v The nine coordinates of the triangle
+ * @param normal Its normal
+*/
+static void collectSeam(const float* v, const float* normal, const GridAxes& axes, const CellBox& box, const std::vector<SeamPlane>& planes, std::vector<SeamSegment>& seam) {
+    const std::vector<float>* corners[3] = {&axes.xs, &axes.ys, &axes.zs};
+    const size_t first[3] = {box.i0, box.j0, box.k0};
+    const size_t last[3] = {box.i1, box.j1, box.k1};
+
+    for (size_t p = 0; p < planes.size(); ++p) {
+        const int a = planes[p].axis;
+        const int u = (a + 1) % 3;
+        const int w = (a + 2) % 3;
+        for (int e = 0; e < 3; ++e) {
+            const float* from = v + 3 * e;
+            const float* to = v + 3 * ((e + 1) % 3);
+            if (from[a] != planes[p].coordinate || to[a] != planes[p].coordinate) continue;
+
+            SeamSegment segment = {p, cellOf(*corners[u], 0.5f * (from[u] + to[u])), cellOf(*corners[w], 0.5f * (from[w] + to[w])),
+                                   {from[u], from[w]}, {to[u], to[w]}, normal[a]};
+            if (segment.cu < (long) first[u] || segment.cu >= (long) last[u] ||
+                segment.cv < (long) first[w] || segment.cv >= (long) last[w]) continue;
+            seam.push_back(segment);
+        }
+    }
+}
+
+
+/***
+ * @brief Index of a point of a cell face, added if it is new.
+*/
+static size_t seamPoint(std::vector<SeamPoint>& points, float u, float v) {
+    for (size_t p = 0; p < points.size(); ++p) {
+        if (points[p].u == u && points[p].v == v) return p;
+    }
+    points.push_back({u, v, {}});
+    return points.size() - 1;
+}
+
+
+/***
+ * @brief Close the seam on one coarse cell face of the region.
+ * The coarse contour of the face runs between the midpoints of its edges and
+ * the fine contour between midpoints of the fine edges along them, so where
+ * they differ the two contours, joined along the cell edges from each end of
+ * one to the nearest end of the other, bound flat loops in the face. Every
+ * loop is filled with a fan. The ends on one cell edge are joined in pairs
+ * from either corner, since both contours cross the edge an odd number of
+ * times when its corners are on opposite sides of the isovalue and an even
+ * number when not.
+ * @param segments The boundary edges of the triangles in the face, coarse and fine
+ * @param u0, u1, v0, v1 Corners of the face along the two other axes
+ * @param[out] mesh Mesh the fans are appended to, and added to mesh.stats
+ * @return bool False if the contours did not close into loops, leaving the face open
+*/
+static bool stitchFace(const std::vector<SeamSegment>& segments, const SeamPlane& plane, float u0, float u1, float v0, float v1, Mesh& mesh) {
+    std::vector<SeamPoint> points;
+    float normal = 0.0f;
+    for (const SeamSegment& segment : segments) {
+        size_t a = seamPoint(points, segment.a[0], segment.a[1]);
+        size_t b = seamPoint(points, segment.b[0], segment.b[1]);
+        points[a].links.push_back(b);
+        points[b].links.push_back(a);
+        normal += segment.normal;
+    }
+
+    // Join the ends of the contours on each cell edge in pairs, in order along the edge
+    for (int side = 0; side < 4; ++side) {
+        std::vector<std::pair<float, size_t>> ends;
+        for (size_t p = 0; p < points.size(); ++p) {
+            const SeamPoint& point = points[p];
+            bool on = side == 0 ? point.v == v0 : side == 1 ? point.v == v1 : side == 2 ? point.u == u0 : point.u == u1;
+            if (!on) continue;
+            for (size_t l = 0; l < point.links.size(); ++l) ends.push_back({side < 2 ? point.u : point.v, p});
+        }
+        std::sort(ends.begin(), ends.end());
+
+        // A coarse and a fine end at the same point are already joined
+        std::vector<size_t> open;
+        for (const auto& end : ends) {
+            if (!open.empty() && open.back() == end.second) open.pop_back();
+            else open.push_back(end.second);
+        }
+        if (open.size() % 2 != 0) return false;
+        for (size_t e = 0; e < open.size(); e += 2) {
+            points[open[e]].links.push_back(open[e + 1]);
+            points[open[e + 1]].links.push_back(open[e]);
+        }
+    }
+
+    for (const SeamPoint& point : points) {
+        if (point.links.size() != 2) return false;
+    }
+
+    const int a = plane.axis;
+    const int u = (a + 1) % 3;
+    const int w = (a + 2) % 3;
+    float facing[3] = {0.0f, 0.0f, 0.0f};
+    facing[a] = normal < 0.0f ? -1.0f : 1.0f;
+
+    std::vector<bool> visited(points.size(), false);
+    std::vector<size_t> loop;
+    for (size_t start = 0; start < points.size(); ++start) {
+        if (visited[start]) continue;
+        loop.clear();
+        size_t previous = points[start].links[1];
+        size_t current = start;
+        while (!visited[current]) {
+            visited[current] = true;
+            loop.push_back(current);
+            size_t next = points[current].links[0] == previous ? points[current].links[1] : points[current].links[0];
+            previous = current;
+            current = next;
+        }
+
+        // Fan from the first point, wound to face the side the neighbouring triangles face
+        for (size_t n = 1; n + 1 < loop.size(); ++n) {
+            const SeamPoint* corners[3] = {&points[loop[0]], &points[loop[n]], &points[loop[n + 1]]};
+            float cross = (corners[0]->u - corners[1]->u) * (corners[0]->v - corners[2]->v) -
+                          (corners[0]->v - corners[1]->v) * (corners[0]->u - corners[2]->u);
+            if ((cross < 0.0f) != (facing[a] < 0.0f)) std::swap(corners[1], corners[2]);
+
+            float v[9];
+            for (int c = 0; c < 3; ++c) {
+                v[3 * c + a] = plane.coordinate;
+                v[3 * c + u] = corners[c]->u;
+                v[3 * c + w] = corners[c]->v;
+                mesh.normals.insert(mesh.normals.end(), facing, facing + 3);
+            }
+            mesh.vertices.insert(mesh.vertices.end(), v, v + 9);
+            mesh.stats.addTriangle(v);
+        }
+    }
+    return true;
+}
+
+
+/***
+ * @brief Close the seam between the kept coarse triangles and the fine ones.
+ * @param seam The triangle edges lying in the faces of the region
+ * @param[out] mesh Mesh the stitching triangles are appended to, and added to mesh.stats
+*/
+static void stitchSeam(std::vector<SeamSegment>& seam, const GridAxes& axes, const std::vector<SeamPlane>& planes, Mesh& mesh) {
+    TRACE_SCOPE("region_stitch");
+    const std::vector<float>* corners[3] = {&axes.xs, &axes.ys, &axes.zs};
+    auto order = [](const SeamSegment& l, const SeamSegment& r) {
+        if (l.plane != r.plane) return l.plane < r.plane;
+        if (l.cu != r.cu) return l.cu < r.cu;
+        return l.cv < r.cv;
+    };
+    std::sort(seam.begin(), seam.end(), order);
+
+    size_t before = mesh.vertices.size();
+    size_t open = 0;
+    std::vector<SeamSegment> face;
+    for (size_t s = 0; s < seam.size();) {
+        size_t e = s;
+        while (e < seam.size() && !order(seam[s], seam[e])) ++e;
+
+        // An edge shared by two triangles of one side is inside that side's surface, not on its border
+        face.clear();
+        for (size_t n = s; n < e; ++n) {
+            bool shared = false;
+            for (size_t m = s; m < e && !shared; ++m) {
+                shared = m != n && ((seam[m].a[0] == seam[n].a[0] && seam[m].a[1] == seam[n].a[1] && seam[m].b[0] == seam[n].b[0] && seam[m].b[1] == seam[n].b[1]) ||
+                                    (seam[m].a[0] == seam[n].b[0] && seam[m].a[1] == seam[n].b[1] && seam[m].b[0] == seam[n].a[0] && seam[m].b[1] == seam[n].a[1]));
+            }
+            if (!shared) face.push_back(seam[n]);
+        }
+
+        const SeamPlane& plane = planes[seam[s].plane];
+        const std::vector<float>& us = *corners[(plane.axis + 1) % 3];
+        const std::vector<float>& vs = *corners[(plane.axis + 2) % 3];
+        if (!stitchFace(face, plane, us[seam[s].cu], us[seam[s].cu + 1], vs[seam[s].cv], vs[seam[s].cv + 1], mesh)) ++open;
+        s = e;
+    }
+    TRACE_COUNT("region_seam_triangles", (mesh.vertices.size() - before) / 9);
+    TRACE_COUNT("region_seam_open_faces", open);
+}
+
+
+bool refineRegion(const ScalarField& f, const Grid& grid, float isoval, const RegionOfInterest& roi, unsigned refinement, Mesh& mesh, unsigned threads) {
+    TRACE_SCOPE("refine_region");
+    if (refinement < 2) {
+        fprintf(stderr, "Region refinement must split cells at least in two, got %u\n", refinement);
+        return false;
+    }
+
+    const GridAxes axes = gridAxes(grid);
+    const CellBox box = regionCells(axes, roi);
+    if (box.cellCount() == 0) {
+        fprintf(stderr, "Region of interest does not overlap the grid\n");
+        return false;
+    }
+
+    // The faces of the region with coarse cells outside them, where the fine surface meets the coarse one
+    std::vector<SeamPlane> planes;
+    if (box.i0 > 0) planes.push_back({0, axes.xs[box.i0]});
+    if (box.i1 < axes.nx()) planes.push_back({0, axes.xs[box.i1]});
+    if (box.j0 > 0) planes.push_back({1, axes.ys[box.j0]});
+    if (box.j1 < axes.ny()) planes.push_back({1, axes.ys[box.j1]});
+    if (box.k0 > 0) planes.push_back({2, axes.zs[box.k0]});
+    if (box.k1 < axes.nz()) planes.push_back({2, axes.zs[box.k1]});
+    std::vector<SeamSegment> seam;
+
+    // Cut away the coarse triangles emitted by cells of the region
+    size_t kept = 0;
+    MeshStats stats;
+    {
+        TRACE_SCOPE("region_cut");
+        for (size_t t = 0; t < mesh.vertices.size(); t += 9) {
+            const float* v = &mesh.vertices[t];
+            long i = cellOf(axes.xs, (v[0] + v[3] + v[6]) / 3.0f);
+            long j = cellOf(axes.ys, (v[1] + v[4] + v[7]) / 3.0f);
+            long k = cellOf(axes.zs, (v[2] + v[5] + v[8]) / 3.0f);
+            bool inside = i >= (long) box.i0 && i < (long) box.i1 &&
+                          j >= (long) box.j0 && j < (long) box.j1 &&
+                          k >= (long) box.k0 && k < (long) box.k1;
+            if (inside) continue;
+
+            if (kept != t) {
+                std::copy(mesh.vertices.begin() + t, mesh.vertices.begin() + t + 9, mesh.vertices.begin() + kept);
+                std::copy(mesh.normals.begin() + t, mesh.normals.begin() + t + 9, mesh.normals.begin() + kept);
+            }
+            stats.addTriangle(&mesh.vertices[kept]);
+
+            bool bordering = i + 1 >= (long) box.i0 && i <= (long) box.i1 &&
+                             j + 1 >= (long) box.j0 && j <= (long) box.j1 &&
+                             k + 1 >= (long) box.k0 && k <= (long) box.k1;
+            if (bordering) collectSeam(&mesh.vertices[kept], &mesh.normals[kept], axes, box, planes, seam);
+            kept += 9;
+        }
+        TRACE_COUNT("region_triangles_removed", (mesh.vertices.size() - kept) / 9);
+        mesh.vertices.resize(kept);
+        mesh.normals.resize(kept);
+    }
+
+    // Extract the region on the fine corners, in parallel slabs of fine cells
+    const GridAxes fine = refineAxes(axes, box, refinement);
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(fine.nx(), 4 * threads));
+    std::vector<Mesh> partMeshes(parts);
+    {
+        TRACE_SCOPE("region_extract");
+        pool.parallelFor(parts, [&](size_t p) {
+            CellBox slab = {fine.nx() * p / parts, fine.nx() * (p + 1) / parts, 0, fine.ny(), 0, fine.nz()};
+            Mesh& part = partMeshes[p];
+            marching_cubes_brick(f, fine, slab, isoval, 1 << 16, [&](const float* vertices, const float* normals, size_t count) {
+                part.vertices.insert(part.vertices.end(), vertices, vertices + count);
+                part.normals.insert(part.normals.end(), normals, normals + count);
+            }, CancellationToken(), &part.stats);
+        }, threads);
+    }
+
+    size_t floats = kept;
+    for (const Mesh& part : partMeshes) floats += part.vertices.size();
+    mesh.vertices.reserve(floats);
+    mesh.normals.reserve(floats);
+    for (const Mesh& part : partMeshes) {
+        mesh.vertices.insert(mesh.vertices.end(), part.vertices.begin(), part.vertices.end());
+        mesh.normals.insert(mesh.normals.end(), part.normals.begin(), part.normals.end());
+        stats.merge(part.stats);
+        for (size_t t = 0; t < part.vertices.size(); t += 9) {
+            collectSeam(&part.vertices[t], &part.normals[t], axes, box, planes, seam);
+        }
+    }
+    mesh.stats = stats;
+    TRACE_COUNT("region_triangles_added", (floats - kept) / 9);
+
+    stitchSeam(seam, axes, planes, mesh);
+    return true;
+}
@@ -0,0 +1,77 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file RegionOfInterest.hpp
+ *
+ * @brief Re-extraction of a sub-box of an extracted mesh at a finer step.
+ * The region is snapped outwards to whole cells of the coarse grid. Every
+ * coarse triangle whose cell lies in the region (found from its centroid,
+ * which is always inside the cell that emitted it) is removed, and the
+ * region is extracted again with each coarse cell split into refinement^3
+ * fine cells. The fine corners on the border of the region are exactly the
+ * coarse corners there, so the fine surface ends where the coarse surface
+ * was cut away, but on the fine edges rather than at the midpoints of the
+ * coarse ones. On every coarse cell face of the border, the loops the two
+ * contours bound between them are filled with flat triangles lying in the
+ * face, so the welded mesh keeps the connected components and the closed
+ * edges it had before.
+ *
+ * The cost is one pass over the mesh plus the fine extraction of the
+ * region; nothing outside the region is sampled again.
+ */
+
+#ifndef REGIONOFINTEREST_HPP
+#define REGIONOFINTEREST_HPP
+
+#include "Fields.hpp"
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+
+/***
+ * RegionOfInterest: an axis-aligned sub-box of the grid
+*/
+struct RegionOfInterest {
+    float minx, maxx;
+    float miny, maxy;
+    float minz, maxz;
+};
+
+/***
+ * @brief The smallest box of cells of a grid covering a region.
+ * @param axes Corner coordinates of the grid
+ * @param roi The region
+ * @return CellBox The covering cells, empty if the region misses the grid
+*/
+CellBox regionCells(const GridAxes& axes, const RegionOfInterest& roi);
+
+/***
+ * @brief Corner coordinates of a box of cells with every cell split into refinement cells per axis.
+ * @param axes Corner coordinates of the coarse grid
+ * @param box The coarse cells
+ * @param refinement Fine cells per coarse cell along each axis
+ * @return GridAxes The fine corners, beginning and ending on the coarse corners of the box
+*/
+GridAxes refineAxes(const GridAxes& axes, const CellBox& box, unsigned refinement);
+
+/***
+ * @brief Replace the triangles of a region of a mesh by a finer extraction of it.
+ * @param f Scalar field, called concurrently from several threads
+ * @param grid The grid the mesh was extracted on
+ * @param isoval Isovalue the mesh was extracted at
+ * @param roi The region to refine
+ * @param refinement Fine cells per coarse cell along each axis (at least 2)
+ * @param[in,out] mesh The mesh; the fine triangles and then the stitching ones are appended after the kept coarse ones
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @return bool True if the region was refined
+*/
+bool refineRegion(const ScalarField& f, const Grid& grid, float isoval, const RegionOfInterest& roi, unsigned refinement, Mesh& mesh, unsigned threads = 0);
+
+#endif // REGIONOFINTEREST_HPP
@@ -0,0 +1,116 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SampleGrid.cpp
+ *
+ * @brief Implementation of the bricked sample storage.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <numeric>
+
+#include "SampleGrid.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+
+/***
+ * @brief Spread the low 21 bits of v to every third bit.
+*/
+static uint64_t spreadBits(uint64_t v) {
+    v &= 0x1FFFFF;
+    v = (v | v << 32) & 0x1F00000000FFFFULL;
+    v = (v | v << 16) & 0x1F0000FF0000FFULL;
+    v = (v | v << 8) & 0x100F00F00F00F00FULL;
+    v = (v | v << 4) & 0x10C30C30C30C30C3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+
+/***
+ * @brief Morton code of a brick, interleaving the bits of its coordinates.
+*/
+static uint64_t mortonCode(size_t i, size_t j, size_t k) {
+    return spreadBits(i) << 2 | spreadBits(j) << 1 | spreadBits(k);
+}
+
+
+SampleGrid::SampleGrid(const GridAxes& axes, SampleLayout layout)
+    : sx(axes.xs.size()), sy(axes.ys.size()), sz(axes.zs.size()), order(layout) {
+    if (order == SampleLayout::RowMajor) {
+        data.resize(sx * sy * sz);
+        return;
+    }
+
+    bx = (sx + SAMPLE_BRICK - 1) / SAMPLE_BRICK;
+    by = (sy + SAMPLE_BRICK - 1) / SAMPLE_BRICK;
+    bz = (sz + SAMPLE_BRICK - 1) / SAMPLE_BRICK;
+    const size_t bricks = bx * by * bz;
+
+    // Bricks are stored in Morton order; partial bricks at the far faces are padded
+    std::vector<uint64_t> codes(bricks);
+    for (size_t bi = 0; bi < bx; ++bi) {
+        for (size_t bj = 0; bj < by; ++bj) {
+            for (size_t bk = 0; bk < bz; ++bk) codes[(bi * by + bj) * bz + bk] = mortonCode(bi, bj, bk);
+        }
+    }
+    std::vector<size_t> sorted(bricks);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) { return codes[a] < codes[b]; });
+
+    const size_t brickSamples = SAMPLE_BRICK * SAMPLE_BRICK * SAMPLE_BRICK;
+    brickOffsets.resize(bricks);
+    for (size_t rank = 0; rank < bricks; ++rank) brickOffsets[sorted[rank]] = rank * brickSamples;
+    data.resize(bricks * brickSamples);
+}
+
+
+void SampleGrid::sample(const ScalarField& f, const GridAxes& axes, unsigned threads) {
+    TRACE_SCOPE("sample_grid");
+    ThreadPool& pool = ThreadPool::shared();
+    if (order == SampleLayout::RowMajor) {
+        pool.parallelFor(sx, [&](size_t i) {
+            float* plane = &data[i * sy * sz];
+            for (size_t j = 0; j < sy; ++j) {
+                for (size_t k = 0; k < sz; ++k) plane[j * sz + k] = f(axes.xs[i], axes.ys[j], axes.zs[k]);
+            }
+        }, threads);
+        return;
+    }
+
+    // One x row of bricks per task, every brick written contiguously
+    pool.parallelFor(bx, [&](size_t bi) {
+        CellBox row = {bi * SAMPLE_BRICK, std::min(sx, (bi + 1) * SAMPLE_BRICK), 0, sy, 0, sz};
+        forEachBrick(row, [&](const CellBox& part) {
+            for (size_t i = part.i0; i < part.i1; ++i) {
+                for (size_t j = part.j0; j < part.j1; ++j) {
+                    float* samples = &data[index(i, j, part.k0)];
+                    for (size_t k = part.k0; k < part.k1; ++k) *samples++ = f(axes.xs[i], axes.ys[j], axes.zs[k]);
+                }
+            }
+        });
+    }, threads);
+}
+
+
+void SampleGrid::swap(SampleGrid& other) {
+    std::swap(sx, other.sx);
+    std::swap(sy, other.sy);
+    std::swap(sz, other.sz);
+    std::swap(bx, other.bx);
+    std::swap(by, other.by);
+    std::swap(bz, other.bz);
+    std::swap(order, other.order);
+    brickOffsets.swap(other.brickOffsets);
+    data.swap(other.data);
+}
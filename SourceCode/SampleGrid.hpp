@@ -0,0 +1,212 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SampleGrid.hpp
+ *
+ * @brief Field samples of a whole grid, stored for cache-friendly traversal.
+ * With x-major rows, the eight corners of a cell lie on four rows spread
+ * over two planes a whole plane apart, so walking a brick of cells of a
+ * large grid touches new cache lines (and often a new page) for every short
+ * row. The bricked layout stores the samples in 8 x 8 x 8 bricks of 2 KiB
+ * and orders the bricks along a Z-order (Morton) curve, so neighbouring
+ * bricks are usually close in memory too. Traversals visit the grid brick
+ * by brick (forEachBrick, forEachCell); inside a brick, the corners of a
+ * cell are two pairs of adjacent 32 byte rows 256 bytes apart, usually two
+ * cache lines.
+ */
+
+#ifndef SAMPLEGRID_HPP
+#define SAMPLEGRID_HPP
+
+#include <stddef.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+
+// Samples along each side of a brick of the bricked layout
+const size_t SAMPLE_BRICK = 8;
+
+/***
+ * SampleLayout: how the samples of a SampleGrid are ordered in memory
+*/
+enum class SampleLayout {
+    RowMajor,  // Sample (i, j, k) at (i * (ny + 1) + j) * (nz + 1) + k
+    Bricked    // 8 x 8 x 8 bricks, the bricks in Morton order
+};
+
+/***
+ * SampleGrid: one float per corner of a grid
+*/
+class SampleGrid {
+
+private:
+
+    size_t sx = 0, sy = 0, sz = 0;     // Samples along each axis
+    size_t bx = 0, by = 0, bz = 0;     // Bricks along each axis
+    SampleLayout order = SampleLayout::Bricked;
+    std::vector<size_t> brickOffsets;  // First sample of brick (bi, bj, bk), at (bi * by + bj) * bz + bk
+    std::vector<float> data;
+
+public:
+
+    SampleGrid() = default;
+
+    /***
+     * @brief Allocate the samples of every corner of a grid.
+     * @param axes Corner coordinates of the grid
+     * @param layout Memory order of the samples
+    */
+    explicit SampleGrid(const GridAxes& axes, SampleLayout layout = SampleLayout::Bricked);
+
+    /***
+     * @brief Where sample (i, j, k) is stored.
+    */
+    size_t index(size_t i, size_t j, size_t k) const {
+        if (order == SampleLayout::RowMajor) return (i * sy + j) * sz + k;
+        return brickOffsets[((i / SAMPLE_BRICK) * by + j / SAMPLE_BRICK) * bz + k / SAMPLE_BRICK]
+             + ((i % SAMPLE_BRICK) * SAMPLE_BRICK + j % SAMPLE_BRICK) * SAMPLE_BRICK + k % SAMPLE_BRICK;
+    }
+
+    float operator()(size_t i, size_t j, size_t k) const { return data[index(i, j, k)]; }
+    float& operator()(size_t i, size_t j, size_t k) { return data[index(i, j, k)]; }
+
+    /***
+     * @brief Split a box of indices into its parts within each brick, brick by brick.
+     * The box may hold cells (by their first corner) or samples (with i1, j1
+     * and k1 one past the last sample). The row-major layout has one part.
+     * @param box The indices to visit
+     * @param onPart Called with every non-empty part, as a CellBox
+    */
+    template <typename OnPart>
+    void forEachBrick(const CellBox& box, OnPart&& onPart) const {
+        if (box.i0 >= box.i1 || box.j0 >= box.j1 || box.k0 >= box.k1) return;
+        if (order == SampleLayout::RowMajor) {
+            onPart(box);
+            return;
+        }
+
+        for (size_t i = box.i0 - box.i0 % SAMPLE_BRICK; i < box.i1; i += SAMPLE_BRICK) {
+            for (size_t j = box.j0 - box.j0 % SAMPLE_BRICK; j < box.j1; j += SAMPLE_BRICK) {
+                for (size_t k = box.k0 - box.k0 % SAMPLE_BRICK; k < box.k1; k += SAMPLE_BRICK) {
+                    CellBox part = {std::max(i, box.i0), std::min(i + SAMPLE_BRICK, box.i1),
+                                    std::max(j, box.j0), std::min(j + SAMPLE_BRICK, box.j1),
+                                    std::max(k, box.k0), std::min(k + SAMPLE_BRICK, box.k1)};
+                    onPart(part);
+                }
+            }
+        }
+    }
+
+    /***
+     * @brief Visit the cells of a box with their eight corners, in storage order.
+     * In the bricked layout the cells are visited brick by brick; the corners
+     * of a brick's cells, which reach one sample into the (at most seven)
+     * bricks after it, are first gathered into a 9 x 9 x 9 block on the stack.
+     * @param box The cells to visit
+     * @param visit Called as visit(i, j, k, corners); corner c is offset by
+     * (c & 1, c >> 1 & 1, c >> 2 & 1) cells from the first corner
+    */
+    template <typename Visit>
+    void forEachCell(const CellBox& box, Visit&& visit) const {
+        float corners[8];
+        if (order == SampleLayout::RowMajor) {
+            const size_t dx = sy * sz, dy = sz;
+            for (size_t i = box.i0; i < box.i1; ++i) {
+                for (size_t j = box.j0; j < box.j1; ++j) {
+                    for (size_t k = box.k0; k < box.k1; ++k) {
+                        const float* p = &data[(i * sy + j) * sz + k];
+                        corners[0] = p[0];
+                        corners[1] = p[dx];
+                        corners[2] = p[dy];
+                        corners[3] = p[dx + dy];
+                        corners[4] = p[1];
+                        corners[5] = p[dx + 1];
+                        corners[6] = p[dy + 1];
+                        corners[7] = p[dx + dy + 1];
+                        visit(i, j, k, corners);
+                    }
+                }
+            }
+            return;
+        }
+
+        forEachBrick(box, [&](const CellBox& part) {
+            const size_t bi = part.i0 / SAMPLE_BRICK, bj = part.j0 / SAMPLE_BRICK, bk = part.k0 / SAMPLE_BRICK;
+            const size_t i0 = bi * SAMPLE_BRICK, j0 = bj * SAMPLE_BRICK, k0 = bk * SAMPLE_BRICK;
+
+            // Neighbour n of the brick is offset by (n & 1, n >> 1 & 1, n >> 2 & 1) bricks
+            const float* bricks[8];
+            for (int n = 0; n < 8; ++n) {
+                const size_t ni = bi + (n & 1), nj = bj + (n >> 1 & 1), nk = bk + (n >> 2 & 1);
+                bricks[n] = ni < bx && nj < by && nk < bz ? &data[brickOffsets[(ni * by + nj) * bz + nk]] : nullptr;
+            }
+
+            // Gather the corners of the part, with the first layer of the next bricks, into one small block
+            const size_t B = SAMPLE_BRICK + 1;
+            float block[B * B * B];
+            const size_t kEnd = std::min(part.k1 - k0, SAMPLE_BRICK - 1);
+            for (size_t i = part.i0 - i0; i <= part.i1 - i0; ++i) {
+                for (size_t j = part.j0 - j0; j <= part.j1 - j0; ++j) {
+                    const int n = i / SAMPLE_BRICK | (j / SAMPLE_BRICK) << 1;
+                    const size_t row = ((i % SAMPLE_BRICK) * SAMPLE_BRICK + j % SAMPLE_BRICK) * SAMPLE_BRICK;
+                    float* dst = &block[(i * B + j) * B];
+                    for (size_t k = part.k0 - k0; k <= kEnd; ++k) dst[k] = bricks[n][row + k];
+                    if (part.k1 - k0 == SAMPLE_BRICK) dst[SAMPLE_BRICK] = bricks[n | 4][row];
+                }
+            }
+
+            for (size_t i = part.i0; i < part.i1; ++i) {
+                for (size_t j = part.j0; j < part.j1; ++j) {
+                    for (size_t k = part.k0; k < part.k1; ++k) {
+                        const float* p = &block[((i - i0) * B + j - j0) * B + k - k0];
+                        corners[0] = p[0];
+                        corners[1] = p[B * B];
+                        corners[2] = p[B];
+                        corners[3] = p[B * B + B];
+                        corners[4] = p[1];
+                        corners[5] = p[B * B + 1];
+                        corners[6] = p[B + 1];
+                        corners[7] = p[B * B + B + 1];
+                        visit(i, j, k, corners);
+                    }
+                }
+            }
+        });
+    }
+
+    /***
+     * @brief Sample a field at every corner, brick by brick in parallel.
+     * @param f Scalar field, called concurrently from several threads
+     * @param axes Corner coordinates of the grid
+     * @param threads Maximum number of threads, 0 for the whole shared pool
+    */
+    void sample(const ScalarField& f, const GridAxes& axes, unsigned threads = 0);
+
+    /***
+     * @brief Exchange the samples of two grids of the same size and layout.
+    */
+    void swap(SampleGrid& other);
+
+    SampleLayout layout() const { return order; }
+    size_t sizeX() const { return sx; }
+    size_t sizeY() const { return sy; }
+    size_t sizeZ() const { return sz; }
+
+    /***
+     * @brief Bytes of sample storage, including the padding of partial bricks.
+    */
+    size_t bytes() const { return data.size() * sizeof(float); }
+};
+
+#endif // SAMPLEGRID_HPP
@@ -0,0 +1,210 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Shard.cpp
+ *
+ * @brief Implementation of the sharded multi-process extraction.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <algorithm>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Fields.hpp"
+#include "MarchingCubes.hpp"
+#include "MeshStream.hpp"
+#include "Shard.hpp"
+#include "Trace.hpp"
+
+// Longest request line a worker accepts
+const size_t SHARD_MAX_REQUEST = 1024;
+
+
+std::string formatShardRequest(const ShardRequest& request) {
+    char line[SHARD_MAX_REQUEST];
+    snprintf(line, sizeof(line), "ISOSHARD %d %s %a %a %a %a %a %a %a %a %zu %zu\n",
+             SHARD_PROTOCOL_VERSION, request.fieldId.c_str(), request.isovalue,
+             request.grid.minx, request.grid.maxx, request.grid.miny, request.grid.maxy,
+             request.grid.minz, request.grid.maxz, request.grid.stepsize,
+             request.firstSlab, request.lastSlab);
+    return line;
+}
+
+
+bool parseShardRequest(const std::string& line, ShardRequest& request) {
+    int version = 0;
+    char field[64];
+    int parsed = sscanf(line.c_str(), "ISOSHARD %d %63s %a %a %a %a %a %a %a %a %zu %zu",
+                        &version, field, &request.isovalue,
+                        &request.grid.minx, &request.grid.maxx, &request.grid.miny, &request.grid.maxy,
+                        &request.grid.minz, &request.grid.maxz, &request.grid.stepsize,
+                        &request.firstSlab, &request.lastSlab);
+    if (parsed != 12 || version != SHARD_PROTOCOL_VERSION) return false;
+    request.fieldId = field;
+    return request.grid.stepsize > 0.0f && request.firstSlab <= request.lastSlab;
+}
+
+
+bool runShardWorker(int inFd, int outFd) {
+    // Read the request line one byte at a time so nothing past it is consumed
+    std::string line;
+    char c;
+    while (line.size() < SHARD_MAX_REQUEST && readAll(inFd, &c, 1) && c != '\n') line += c;
+
+    ShardRequest request;
+    scalar_field_3d f = nullptr;
+    GridAxes axes;
+    bool valid = parseShardRequest(line, request) && (f = findField(request.fieldId)) != nullptr;
+    if (valid) {
+        axes = gridAxes(request.grid);
+        valid = request.lastSlab <= axes.nx();
+    }
+    if (!valid) {
+        fprintf(stderr, "Invalid shard request: %s\n", line.c_str());
+        MeshStreamWriter(outFd, 1).finish();
+        return false;
+    }
+
+    MeshStreamWriter stream(outFd);
+    CellBox box = {request.firstSlab, request.lastSlab, 0, axes.ny(), 0, axes.nz()};
+    marching_cubes_brick(f, axes, box, request.isovalue, 1 << 18, [&](const float* vertices, const float* normals, size_t count) {
+        stream.write(vertices, normals, count);
+    });
+    return stream.finish();
+}
+
+
+/***
+ * A started worker process and the pipes to it
+*/
+struct ShardWorker {
+    pid_t pid = -1;
+    int requestFd = -1;
+    int meshFd = -1;
+};
+
+
+/***
+ * @brief Start a worker process with its standard input and output connected to pipes.
+*/
+static bool startWorker(const std::vector<std::string>& command, ShardWorker& worker) {
+    int toWorker[2], fromWorker[2];
+    if (pipe(toWorker) != 0) return false;
+    if (pipe(fromWorker) != 0) {
+        close(toWorker[0]);
+        close(toWorker[1]);
+        return false;
+    }
+
+    std::vector<char*> argv;
+    for (const std::string& arg : command) argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    worker.pid = fork();
+    if (worker.pid == 0) {
+        dup2(toWorker[0], STDIN_FILENO);
+        dup2(fromWorker[1], STDOUT_FILENO);
+        close(toWorker[0]);
+        close(toWorker[1]);
+        close(fromWorker[0]);
+        close(fromWorker[1]);
+        execvp(argv[0], argv.data());
+
+        // Only async-signal-safe calls between fork and exit
+        const char message[] = "Failed to start shard worker\n";
+        ssize_t ignored = ::write(STDERR_FILENO, message, sizeof(message) - 1);
+        (void) ignored;
+        _exit(127);
+    }
+
+    close(toWorker[0]);
+    close(fromWorker[1]);
+    if (worker.pid < 0) {
+        close(toWorker[1]);
+        close(fromWorker[0]);
+        return false;
+    }
+    worker.requestFd = toWorker[1];
+    worker.meshFd = fromWorker[0];
+    return true;
+}
+
+
+bool extractSharded(const std::string& fieldId, const Grid& grid, float isoval, unsigned shards, const std::vector<std::string>& workerCommand, Mesh& mesh) {
+    TRACE_SCOPE("sharded_extract");
+    if (workerCommand.empty() || findField(fieldId) == nullptr) {
+        fprintf(stderr, "Sharded extraction needs a worker command and a built-in field\n");
+        return false;
+    }
+
+    const size_t nx = gridAxis(grid.minx, grid.maxx, grid.stepsize).size() - 1;
+    shards = std::max<size_t>(1, std::min<size_t>(shards, nx));
+
+    // A worker that dies before reading its request must not kill the coordinator
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<ShardWorker> workers(shards);
+    std::vector<Mesh> parts(shards);
+    std::vector<unsigned char> received(shards, 0);
+    std::vector<std::thread> readers;
+    bool ok = true;
+
+    for (unsigned s = 0; s < shards; ++s) {
+        ShardRequest request = {fieldId, isoval, grid, nx * s / shards, nx * (s + 1) / shards};
+        if (!startWorker(workerCommand, workers[s])) {
+            fprintf(stderr, "Failed to start shard worker %u\n", s);
+            ok = false;
+            break;
+        }
+        std::string line = formatShardRequest(request);
+        writeAll(workers[s].requestFd, line.data(), line.size());
+        close(workers[s].requestFd);
+
+        readers.emplace_back([&, s]() {
+            TRACE_SLAB_SCOPE("shard_receive", s);
+            received[s] = readMeshStream(workers[s].meshFd, parts[s]);
+            close(workers[s].meshFd);
+
+            // The stream carries no statistics, so each reader adds up those of its part
+            parts[s].stats.add(parts[s].vertices.data(), parts[s].vertices.size());
+        });
+    }
+
+    for (std::thread& reader : readers) reader.join();
+    for (unsigned s = 0; s < shards; ++s) {
+        if (workers[s].pid <= 0) continue;
+        int status = 0;
+        waitpid(workers[s].pid, &status, 0);
+        if (!received[s] || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "Shard worker %u failed\n", s);
+            ok = false;
+        }
+    }
+    if (!ok) return false;
+
+    // The shards hold consecutive slabs, so concatenating them in order rebuilds the single-process mesh
+    size_t floats = 0;
+    for (const Mesh& part : parts) floats += part.vertices.size();
+    mesh.clear();
+    mesh.vertices.reserve(floats);
+    mesh.normals.reserve(floats);
+    for (Mesh& part : parts) {
+        mesh.vertices.insert(mesh.vertices.end(), part.vertices.begin(), part.vertices.end());
+        mesh.normals.insert(mesh.normals.end(), part.normals.begin(), part.normals.end());
+        mesh.stats.merge(part.stats);
+        part = Mesh();
+    }
+    return true;
+}
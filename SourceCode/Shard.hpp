@@ -0,0 +1,88 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Shard.hpp
+ *
+ * @brief Extraction split across worker processes.
+ * A coordinator splits the x slabs of the grid into contiguous ranges and
+ * starts one worker process per range. It sends each worker a one-line
+ * request on its standard input, and reads the sub-mesh back as a mesh
+ * stream (see MeshStream.hpp) from its standard output. A worker extracts
+ * its slabs on the coordinates of the whole grid, so the triangles on
+ * either side of a range border meet exactly, and the sub-meshes
+ * concatenated in range order are bit-identical to a single-process
+ * marching_cubes_async run.
+ *
+ * Workers are started from a command line, by default this program with
+ * --shard-worker. The protocol only needs the standard input and output of
+ * the worker, so a command such as "ssh host assign5 --shard-worker" can
+ * run shards remotely without any change.
+ *
+ * Request line (floats in hexadecimal so that they are exact):
+ *
+ * ISOSHARD <version> <field> <isovalue> <minx> <maxx> <miny> <maxy> <minz> <maxz> <stepsize> <first slab> <last slab>
+ */
+
+#ifndef SHARD_HPP
+#define SHARD_HPP
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "Mesh.hpp"
+
+const int SHARD_PROTOCOL_VERSION = 1;
+
+/***
+ * ShardRequest: the slabs [firstSlab, lastSlab) of one extraction
+*/
+struct ShardRequest {
+    std::string fieldId; // A built-in field name, see findField
+    float isovalue;
+    Grid grid;
+    size_t firstSlab;
+    size_t lastSlab;
+};
+
+/***
+ * @brief Format a request as its protocol line, including the newline.
+*/
+std::string formatShardRequest(const ShardRequest& request);
+
+/***
+ * @brief Parse a request line.
+ * @return bool True if the line is a valid request of this protocol version
+*/
+bool parseShardRequest(const std::string& line, ShardRequest& request);
+
+/***
+ * @brief Serve one request as a worker: read it from inFd and stream the sub-mesh to outFd.
+ * A request that cannot be served is answered with a failed stream.
+ * @param inFd Where the request line is read from
+ * @param outFd Where the mesh stream is written to
+ * @return bool True if the request was served
+*/
+bool runShardWorker(int inFd, int outFd);
+
+/***
+ * @brief Extract a named field in worker processes and concatenate their sub-meshes.
+ * @param fieldId A built-in field name, see findField
+ * @param grid The sampled box and step size
+ * @param isoval Isovalue
+ * @param shards Number of worker processes, at most one per slab
+ * @param workerCommand Program and arguments that start a worker
+ * @param[out] mesh Output mesh, replaced by the isosurface and its statistics
+ * @return bool True if every worker succeeded
+*/
+bool extractSharded(const std::string& fieldId, const Grid& grid, float isoval, unsigned shards, const std::vector<std::string>& workerCommand, Mesh& mesh);
+
+#endif // SHARD_HPP
@@ -0,0 +1,221 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SharedMesh.cpp
+ *
+ * @brief Implementation of the shared memory mesh transport.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MarchingCubes.hpp"
+#include "SharedMesh.hpp"
+#include "Trace.hpp"
+
+
+/***
+ * @brief Bytes of a shared mesh file with room for floatCapacity floats.
+*/
+static size_t sharedMeshBytes(size_t floatCapacity) {
+    return SHARED_MESH_HEADER_BYTES + 2 * floatCapacity * sizeof(float) + floatCapacity / 3 * sizeof(uint32_t);
+}
+
+
+size_t sharedMeshCapacity(const ScalarField& f, const Grid& grid, float isoval, ExtractionEngine engine) {
+    TRACE_SCOPE("shared_capacity");
+    size_t activeCells = 0;
+    size_t triangles = marching_cubes_count(f, grid, isoval, 0, &activeCells);
+    if (engine == ExtractionEngine::SurfaceNets) triangles = activeCells * 6;
+    return triangles * 9;
+}
+
+
+bool SharedMeshWriter::create(const std::string& path, const Grid& grid, size_t floatCapacity) {
+    close();
+    floatCapacity -= floatCapacity % 9;
+
+    // A new file rather than a truncated one, so readers of the previous mesh are not cut off
+    unlink(path.c_str());
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to create shared mesh %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    // Reserve every block now, so that a full disk or tmpfs fails here rather than with SIGBUS on a later write
+    length = sharedMeshBytes(floatCapacity);
+    int reserved = posix_fallocate(fd, 0, length);
+    if (reserved != 0) {
+        fprintf(stderr, "Failed to reserve %zu bytes for shared mesh %s: %s\n", length, path.c_str(), strerror(reserved));
+        ::close(fd);
+        unlink(path.c_str());
+        length = 0;
+        return false;
+    }
+    data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Failed to map shared mesh %s: %s\n", path.c_str(), strerror(errno));
+        data = nullptr;
+        length = 0;
+        unlink(path.c_str());
+        return false;
+    }
+
+    this->path = path;
+    header = new (data) SharedMeshHeader();
+    header->format = SHARED_MESH_FORMAT;
+    header->floatCapacity = floatCapacity;
+    const float bounds[7] = {grid.minx, grid.maxx, grid.miny, grid.maxy, grid.minz, grid.maxz, grid.stepsize};
+    memcpy(header->bounds, bounds, sizeof(bounds));
+    header->state.store(SHARED_MESH_EXTRACTING);
+    header->sequence.store(0);
+    header->generation.store(0);
+    header->floatCount.store(0);
+    header->indexCount.store(0);
+
+    // Readers check the magic last, so they never see a half-written header
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, SHARED_MESH_MAGIC, sizeof(SHARED_MESH_MAGIC));
+    return true;
+}
+
+
+void SharedMeshWriter::close() {
+    if (data != nullptr) munmap(data, length);
+    data = nullptr;
+    header = nullptr;
+    length = 0;
+}
+
+
+bool SharedMeshWriter::append(const float* vertices, const float* normals, size_t count) {
+    size_t published = header->floatCount.load(std::memory_order_relaxed);
+    if (published + count > header->floatCapacity) {
+        fprintf(stderr, "Shared mesh %s is full (%zu floats)\n", path.c_str(), (size_t) header->floatCapacity);
+        return false;
+    }
+
+    TRACE_COUNT("shared_bytes", 2 * count * sizeof(float));
+    memcpy((float*) this->vertices() + published, vertices, count * sizeof(float));
+    memcpy((float*) this->normals() + published, normals, count * sizeof(float));
+    header->floatCount.store(published + count, std::memory_order_release);
+    return true;
+}
+
+
+bool SharedMeshWriter::replace(const IndexedMesh& mesh) {
+    if (mesh.positions.size() > header->floatCapacity || mesh.indices.size() > header->floatCapacity / 3 ||
+        mesh.normals.size() != mesh.positions.size()) {
+        fprintf(stderr, "Indexed mesh does not fit shared mesh %s\n", path.c_str());
+        return false;
+    }
+
+    TRACE_SCOPE("shared_replace");
+    uint32_t* indices = (uint32_t*) (normals() + header->floatCapacity);
+
+    // Odd sequence: readers that overlap with the copy discard what they read
+    header->sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy((float*) vertices(), mesh.positions.data(), mesh.positions.size() * sizeof(float));
+    memcpy((float*) normals(), mesh.normals.data(), mesh.normals.size() * sizeof(float));
+    memcpy(indices, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    header->floatCount.store(mesh.positions.size(), std::memory_order_relaxed);
+    header->indexCount.store(mesh.indices.size(), std::memory_order_relaxed);
+    header->generation.fetch_add(1, std::memory_order_relaxed);
+    header->sequence.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+
+void SharedMeshWriter::finish(bool ok) {
+    header->state.store(ok ? SHARED_MESH_DONE : SHARED_MESH_FAILED, std::memory_order_release);
+}
+
+
+bool SharedMeshReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open shared mesh %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < SHARED_MESH_HEADER_BYTES) {
+        fprintf(stderr, "%s is not a shared mesh\n", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    length = st.st_size;
+    data = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Failed to map shared mesh %s: %s\n", path.c_str(), strerror(errno));
+        data = nullptr;
+        length = 0;
+        return false;
+    }
+
+    const SharedMeshHeader* mapped = (const SharedMeshHeader*) data;
+    bool valid = memcmp(mapped->magic, SHARED_MESH_MAGIC, sizeof(SHARED_MESH_MAGIC)) == 0 &&
+                 mapped->format == SHARED_MESH_FORMAT &&
+                 sharedMeshBytes(mapped->floatCapacity) == length;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid) {
+        fprintf(stderr, "%s is not a shared mesh of format %u\n", path.c_str(), SHARED_MESH_FORMAT);
+        close();
+        return false;
+    }
+    header = mapped;
+    return true;
+}
+
+
+void SharedMeshReader::close() {
+    if (data != nullptr) munmap(data, length);
+    data = nullptr;
+    header = nullptr;
+    length = 0;
+}
+
+
+SharedMeshSnapshot SharedMeshReader::snapshot() const {
+    SharedMeshSnapshot snapshot;
+    snapshot.sequence = header->sequence.load(std::memory_order_acquire);
+    snapshot.generation = header->generation.load(std::memory_order_relaxed);
+    snapshot.indexCount = header->indexCount.load(std::memory_order_relaxed);
+    snapshot.floatCount = header->floatCount.load(std::memory_order_acquire);
+    snapshot.state = header->state.load(std::memory_order_acquire);
+    return snapshot;
+}
+
+
+bool SharedMeshReader::validate(const SharedMeshSnapshot& snapshot) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header->sequence.load(std::memory_order_relaxed) == snapshot.sequence;
+}
+
+
+Grid SharedMeshReader::grid() const {
+    const float* b = header->bounds;
+    return {b[0], b[1], b[2], b[3], b[4], b[5], b[6]};
+}
@@ -0,0 +1,219 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SharedMesh.hpp
+ *
+ * @brief A mesh handed from an extracting process to a viewer through a
+ * shared memory mapping.
+ * The extracting process creates a file (under /dev/shm it never touches
+ * a disk), maps it and appends every slab's vertices and normals to it as
+ * they are extracted. The viewer maps the same file read-only and uploads
+ * each newly published range to the GPU straight from the mapping, so the
+ * mesh is never serialized or copied on its way between the processes.
+ *
+ * Appending is lock-free: the data of a slab is written first and then the
+ * published float count is advanced with a release store, so a reader that
+ * loads the count with acquire semantics only sees complete slabs. When the
+ * writer replaces the published mesh (with its welded, indexed version once
+ * the extraction is done) it makes the sequence counter odd for the
+ * duration and bumps the generation; readers check the sequence before and
+ * after they upload and start over if it moved.
+ *
+ * The file is sized from a counting pass over the grid before the
+ * extraction (see sharedMeshCapacity), and its blocks are reserved when it
+ * is created, so a disk or tmpfs without room for the mesh is reported then
+ * instead of faulting on a later write.
+ *
+ * File layout (native endianness):
+ *
+ * SharedMeshHeader, padded to SHARED_MESH_HEADER_BYTES
+ * vertices: floatCapacity floats
+ * normals: floatCapacity floats
+ * indices: floatCapacity / 3 uint32_t
+ */
+
+#ifndef SHAREDMESH_HPP
+#define SHAREDMESH_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <string>
+
+#include "Fields.hpp"
+#include "IndexedMesh.hpp"
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+
+const char SHARED_MESH_MAGIC[8] = {'I', 'S', 'O', 'S', 'H', 'M', '\0', '\0'};
+const uint32_t SHARED_MESH_FORMAT = 1;
+const size_t SHARED_MESH_HEADER_BYTES = 4096;
+
+// States of a published mesh
+const uint32_t SHARED_MESH_EXTRACTING = 0;
+const uint32_t SHARED_MESH_DONE = 1;
+const uint32_t SHARED_MESH_FAILED = 2;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared mesh counters must be lock-free across processes");
+
+struct SharedMeshHeader {
+    char magic[8];
+    uint32_t format;
+    std::atomic<uint32_t> state;        // SHARED_MESH_EXTRACTING, _DONE or _FAILED
+    uint64_t floatCapacity;             // Floats of room for vertices, and again for normals
+    float bounds[7];                    // The extracted grid: minx, maxx, miny, maxy, minz, maxz, stepsize
+    std::atomic<uint64_t> sequence;     // Odd while the writer replaces the published mesh
+    std::atomic<uint64_t> generation;   // Bumped whenever the published mesh is replaced
+    std::atomic<uint64_t> floatCount;   // Published floats of vertices, and of normals
+    std::atomic<uint64_t> indexCount;   // Published indices, 0 for a triangle soup
+};
+
+/***
+ * SharedMeshSnapshot: the published state a reader saw at one moment
+*/
+struct SharedMeshSnapshot {
+    uint64_t sequence;
+    uint64_t generation;
+    size_t floatCount;
+    size_t indexCount;
+    uint32_t state;
+
+    // False while the writer is replacing the mesh; try again later
+    bool stable() const { return (sequence & 1) == 0; }
+};
+
+/***
+ * @brief Floats of room needed for the mesh of a grid.
+ * The cells are classified once with marching_cubes_count, which gives the
+ * exact triangle count of marching cubes. Surface Nets emits up to six
+ * triangles per cell the surface crosses (a quad for each of the three
+ * edges a cell owns), so six are reserved for each of those.
+ * @param f Scalar field that will be extracted
+ * @param grid The grid that will be extracted
+ * @param isoval Isovalue
+ * @param engine The engine that will extract it
+ * @return size_t Floats of vertices, and of normals
+*/
+size_t sharedMeshCapacity(const ScalarField& f, const Grid& grid, float isoval, ExtractionEngine engine);
+
+/***
+ * SharedMeshWriter: the extracting side, which creates and fills the mapping
+*/
+class SharedMeshWriter {
+
+private:
+
+    std::string path;
+    void* data = nullptr;
+    size_t length = 0;
+    SharedMeshHeader* header = nullptr;
+
+public:
+
+    SharedMeshWriter() {}
+    SharedMeshWriter(const SharedMeshWriter&) = delete;
+    SharedMeshWriter& operator=(const SharedMeshWriter&) = delete;
+
+    /***
+     * @brief Unmap the file; it stays behind for the readers.
+    */
+    ~SharedMeshWriter() { close(); }
+
+    /***
+     * @brief Create the file, replacing any previous one, and map it.
+     * Readers still mapping a previous file keep their (now nameless) copy.
+     * @param path Path of the file, e.g. /dev/shm/assign5.mesh
+     * @param grid The grid that will be extracted, recorded for the readers
+     * @param floatCapacity Room for vertices, see sharedMeshCapacity
+     * @return bool True if the file was created
+    */
+    bool create(const std::string& path, const Grid& grid, size_t floatCapacity);
+
+    void close();
+
+    /***
+     * @brief Append a slab of triangles to the published triangle soup.
+     * @param vertices Vertex coordinates
+     * @param normals Normal coordinates
+     * @param count Floats in each of vertices and normals
+     * @return bool False if the mapping is full
+    */
+    bool append(const float* vertices, const float* normals, size_t count);
+
+    /***
+     * @brief Replace the published mesh with an indexed mesh.
+     * @param mesh The mesh, with normals
+     * @return bool False if the mesh does not fit
+    */
+    bool replace(const IndexedMesh& mesh);
+
+    /***
+     * @brief Mark the mesh as complete (or failed); readers stop waiting for slabs.
+    */
+    void finish(bool ok);
+
+    const float* vertices() const { return (const float*) ((const char*) data + SHARED_MESH_HEADER_BYTES); }
+    const float* normals() const { return vertices() + header->floatCapacity; }
+    size_t floatCount() const { return header->floatCount.load(std::memory_order_relaxed); }
+};
+
+/***
+ * SharedMeshReader: the viewing side, which maps the file read-only
+*/
+class SharedMeshReader {
+
+private:
+
+    void* data = nullptr;
+    size_t length = 0;
+    const SharedMeshHeader* header = nullptr;
+
+public:
+
+    SharedMeshReader() {}
+    SharedMeshReader(const SharedMeshReader&) = delete;
+    SharedMeshReader& operator=(const SharedMeshReader&) = delete;
+    ~SharedMeshReader() { close(); }
+
+    /***
+     * @brief Map a file created by a SharedMeshWriter.
+     * @param path Path of the file
+     * @return bool True if the file is a valid shared mesh
+    */
+    bool open(const std::string& path);
+
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+
+    /***
+     * @brief Load the published state, before reading the mesh.
+    */
+    SharedMeshSnapshot snapshot() const;
+
+    /***
+     * @brief Check after reading that the writer did not replace the mesh meanwhile.
+     * @param snapshot The state loaded before reading
+     * @return bool True if what was read belongs to the snapshot
+    */
+    bool validate(const SharedMeshSnapshot& snapshot) const;
+
+    /***
+     * @brief The grid the writer extracts.
+    */
+    Grid grid() const;
+
+    const float* vertices() const { return (const float*) ((const char*) data + SHARED_MESH_HEADER_BYTES); }
+    const float* normals() const { return vertices() + header->floatCapacity; }
+    const uint32_t* indices() const { return (const uint32_t*) (normals() + header->floatCapacity); }
+};
+
+#endif // SHAREDMESH_HPP
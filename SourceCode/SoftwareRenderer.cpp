@@ -0,0 +1,417 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SoftwareRenderer.cpp
+ *
+ * @brief Implementation of the tiled CPU rasterizer.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "HelperFunctions.hpp"
+#include "SoftwareRenderer.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+// Sub-pixel precision of the fixed-point vertex positions (4 bits)
+const int64_t SUBPIXEL = 16;
+
+// Triangles are clipped to this many viewport half-sizes around the view, keeping fixed point in range
+const float GUARD_BAND = 32.0f;
+
+// Near and far planes of the viewer's projection
+const float NEAR_PLANE = 0.001f;
+const float FAR_PLANE = 1000.0f;
+
+// Triangles binned by each binning task
+const size_t BIN_TRIANGLES = 16384;
+
+/***
+ * ClipVertex: a vertex in clip space with the attributes the shader interpolates
+*/
+struct ClipVertex {
+    glm::vec4 clip;
+    glm::vec3 camera;  // Position in camera space
+    glm::vec3 normal;  // Normal in camera space
+};
+
+/***
+ * ScreenVertex: a vertex snapped to the sub-pixel grid, attributes divided by w
+*/
+struct ScreenVertex {
+    int64_t x, y;
+    float invW;
+    glm::vec3 cameraW;
+    glm::vec3 normalW;
+};
+
+/***
+ * ScreenTriangle: three screen vertices, counter-clockwise in image coordinates
+*/
+struct ScreenTriangle {
+    ScreenVertex v[3];
+    int64_t area;  // Twice the area in sub-pixel units, positive
+};
+
+/***
+ * Transform: everything the vertex stage needs
+*/
+struct Transform {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat3 normalMatrix;
+    float width, height;
+};
+
+
+/***
+ * @brief Signed distances of a clip-space point to the six clip planes; inside is >= 0.
+*/
+static void planeDistances(const glm::vec4& c, float* d) {
+    d[0] = c.w + c.z;                // near
+    d[1] = c.w - c.z;                // far
+    d[2] = GUARD_BAND * c.w + c.x;   // left guard band
+    d[3] = GUARD_BAND * c.w - c.x;   // right
+    d[4] = GUARD_BAND * c.w + c.y;   // bottom
+    d[5] = GUARD_BAND * c.w - c.y;   // top
+}
+
+
+static ClipVertex lerp(const ClipVertex& a, const ClipVertex& b, float t) {
+    return {a.clip + t * (b.clip - a.clip), a.camera + t * (b.camera - a.camera), a.normal + t * (b.normal - a.normal)};
+}
+
+
+/***
+ * @brief Snap a clip-space vertex to the screen.
+*/
+static ScreenVertex toScreen(const ClipVertex& v, const Transform& xf) {
+    float invW = 1.0f / v.clip.w;
+    float sx = (v.clip.x * invW * 0.5f + 0.5f) * xf.width;
+    float sy = (0.5f - v.clip.y * invW * 0.5f) * xf.height;
+    return {(int64_t) std::llround(sx * SUBPIXEL), (int64_t) std::llround(sy * SUBPIXEL), invW, v.camera * invW, v.normal * invW};
+}
+
+
+static int64_t edge(const ScreenVertex& a, const ScreenVertex& b, int64_t px, int64_t py) {
+    return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+}
+
+
+/***
+ * @brief Transform, clip and project one triangle of the mesh.
+ * @param[out] out Up to seven screen triangles (a triangle clipped by six planes)
+ * @param[out] clipped Set if the triangle had to be clipped
+ * @return int Number of screen triangles, 0 if the triangle is out of view or degenerate
+*/
+static int setupTriangle(const Mesh& mesh, size_t t, const Transform& xf, ScreenTriangle* out, bool& clipped) {
+    ClipVertex vertices[3];
+    float distances[3][6];
+    int outside = 0;
+    int culledBy[6] = {0, 0, 0, 0, 0, 0};
+    for (int c = 0; c < 3; ++c) {
+        const float* p = &mesh.vertices[9 * t + 3 * c];
+        const float* n = &mesh.normals[9 * t + 3 * c];
+        glm::vec4 camera = xf.view * glm::vec4(p[0], p[1], p[2], 1.0f);
+        vertices[c] = {xf.projection * camera, glm::vec3(camera), xf.normalMatrix * glm::vec3(n[0], n[1], n[2])};
+        planeDistances(vertices[c].clip, distances[c]);
+        bool in = true;
+        for (int k = 0; k < 6; ++k) {
+            if (distances[c][k] < 0.0f) {
+                culledBy[k]++;
+                in = false;
+            }
+        }
+        outside += !in;
+    }
+    for (int k = 0; k < 6; ++k) {
+        if (culledBy[k] == 3) return 0;
+    }
+
+    // Sutherland-Hodgman against every plane the triangle crosses
+    ClipVertex polygon[9];
+    int count = 3;
+    std::copy(vertices, vertices + 3, polygon);
+    clipped = outside > 0;
+    if (clipped) {
+        for (int k = 0; k < 6 && count > 0; ++k) {
+            if (culledBy[k] == 0) continue;
+            ClipVertex next[9];
+            int nextCount = 0;
+            for (int i = 0; i < count; ++i) {
+                const ClipVertex& a = polygon[i];
+                const ClipVertex& b = polygon[(i + 1) % count];
+                float da[6], db[6];
+                planeDistances(a.clip, da);
+                planeDistances(b.clip, db);
+                if (da[k] >= 0.0f) next[nextCount++] = a;
+                if ((da[k] >= 0.0f) != (db[k] >= 0.0f)) next[nextCount++] = lerp(a, b, da[k] / (da[k] - db[k]));
+            }
+            std::copy(next, next + nextCount, polygon);
+            count = nextCount;
+        }
+    }
+
+    int triangles = 0;
+    for (int i = 1; i + 1 < count; ++i) {
+        ScreenTriangle& tri = out[triangles];
+        tri.v[0] = toScreen(polygon[0], xf);
+        tri.v[1] = toScreen(polygon[i], xf);
+        tri.v[2] = toScreen(polygon[i + 1], xf);
+        tri.area = edge(tri.v[0], tri.v[1], tri.v[2].x, tri.v[2].y);
+        if (tri.area == 0) continue;
+        if (tri.area < 0) {
+            std::swap(tri.v[1], tri.v[2]);
+            tri.area = -tri.area;
+        }
+        triangles++;
+    }
+    return triangles;
+}
+
+
+/***
+ * @brief Pixel bounds of a screen triangle, clamped to the image.
+ * @return bool False if the triangle covers no pixel of the image
+*/
+static bool pixelBounds(const ScreenTriangle& tri, unsigned width, unsigned height, int64_t* bounds) {
+    int64_t minX = std::min({tri.v[0].x, tri.v[1].x, tri.v[2].x});
+    int64_t maxX = std::max({tri.v[0].x, tri.v[1].x, tri.v[2].x});
+    int64_t minY = std::min({tri.v[0].y, tri.v[1].y, tri.v[2].y});
+    int64_t maxY = std::max({tri.v[0].y, tri.v[1].y, tri.v[2].y});
+
+    // Pixel p is sampled at its centre p * SUBPIXEL + SUBPIXEL / 2; >> 4 floors, also below zero
+    bounds[0] = std::max<int64_t>(0, -((SUBPIXEL / 2 - minX) >> 4));
+    bounds[1] = std::min<int64_t>((int64_t) width - 1, (maxX - SUBPIXEL / 2) >> 4);
+    bounds[2] = std::max<int64_t>(0, -((SUBPIXEL / 2 - minY) >> 4));
+    bounds[3] = std::min<int64_t>((int64_t) height - 1, (maxY - SUBPIXEL / 2) >> 4);
+    return bounds[0] <= bounds[1] && bounds[2] <= bounds[3];
+}
+
+
+/***
+ * @brief Whether pixels exactly on the edge a -> b belong to the triangle (top-left rule).
+*/
+static bool topLeft(const ScreenVertex& a, const ScreenVertex& b) {
+    int64_t dx = b.x - a.x;
+    int64_t dy = b.y - a.y;
+    return dy < 0 || (dy == 0 && dx > 0);
+}
+
+
+/***
+ * Tile: the colour and depth samples of one tile while it is rasterized
+*/
+struct Tile {
+    int64_t x0, y0, x1, y1;     // Pixels [x0, x1) x [y0, y1) of the supersampled image
+    std::vector<float> color;   // RGB per sample
+    std::vector<float> depth;   // 1/w per sample, 0 for nothing drawn
+};
+
+
+/***
+ * @brief The shader's Phong model for one fragment, blended over the tile.
+*/
+static void shadeFragment(float* dst, const glm::vec3& camera, const glm::vec3& normal, const glm::vec3& lightCamera, const RenderOptions& options) {
+    glm::vec4 modelColor(options.color[0], options.color[1], options.color[2], options.color[3]);
+    float length = glm::length(normal);
+    float cosTheta = 0.0f;
+    float cosAlpha = 0.0f;
+    if (length > 0.0f) {
+        glm::vec3 n = normal / length;
+        glm::vec3 l = glm::normalize(lightCamera - camera);
+        glm::vec3 e = glm::normalize(-camera);
+        glm::vec3 r = glm::reflect(-l, n);
+        cosTheta = glm::clamp(glm::dot(n, l), 0.0f, 1.0f);
+        cosAlpha = glm::clamp(glm::dot(e, r), 0.0f, 1.0f);
+    }
+
+    glm::vec4 ambient = glm::vec4(0.2f, 0.2f, 0.2f, 1.0f) * modelColor;
+    glm::vec4 diffuse = cosTheta * modelColor;
+    glm::vec4 specular = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f) * std::pow(cosAlpha, options.shininess);
+    glm::vec4 color = glm::clamp(ambient + diffuse + specular, 0.0f, 1.0f);
+
+    // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+    for (int c = 0; c < 3; ++c) dst[c] = color[c] * color.w + dst[c] * (1.0f - color.w);
+}
+
+
+void shadePhong(float* dst, const float* position, const float* normal, const float* light, const RenderOptions& options) {
+    shadeFragment(dst, glm::vec3(position[0], position[1], position[2]), glm::vec3(normal[0], normal[1], normal[2]), glm::vec3(light[0], light[1], light[2]), options);
+}
+
+
+/***
+ * @brief Rasterize one screen triangle into the part of a tile it covers.
+*/
+static void rasterize(const ScreenTriangle& tri, Tile& tile, const glm::vec3& lightCamera, const RenderOptions& options, unsigned width, unsigned height) {
+    int64_t bounds[4];
+    if (!pixelBounds(tri, width, height, bounds)) return;
+    int64_t x0 = std::max(bounds[0], tile.x0), x1 = std::min(bounds[1] + 1, tile.x1);
+    int64_t y0 = std::max(bounds[2], tile.y0), y1 = std::min(bounds[3] + 1, tile.y1);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const ScreenVertex& a = tri.v[0];
+    const ScreenVertex& b = tri.v[1];
+    const ScreenVertex& c = tri.v[2];
+
+    // Pixels on an edge that is not top-left are left to the neighbouring triangle
+    const int64_t bias0 = topLeft(b, c) ? 0 : -1;
+    const int64_t bias1 = topLeft(c, a) ? 0 : -1;
+    const int64_t bias2 = topLeft(a, b) ? 0 : -1;
+    const float invArea = 1.0f / (float) tri.area;
+    const int64_t tileWidth = tile.x1 - tile.x0;
+
+    for (int64_t y = y0; y < y1; ++y) {
+        int64_t py = y * SUBPIXEL + SUBPIXEL / 2;
+        int64_t px = x0 * SUBPIXEL + SUBPIXEL / 2;
+        int64_t w0 = edge(b, c, px, py), w1 = edge(c, a, px, py), w2 = edge(a, b, px, py);
+        const int64_t step0 = -(c.y - b.y) * SUBPIXEL, step1 = -(a.y - c.y) * SUBPIXEL, step2 = -(b.y - a.y) * SUBPIXEL;
+
+        for (int64_t x = x0; x < x1; ++x, w0 += step0, w1 += step1, w2 += step2) {
+            if (w0 + bias0 < 0 || w1 + bias1 < 0 || w2 + bias2 < 0) continue;
+
+            float l0 = w0 * invArea, l1 = w1 * invArea, l2 = w2 * invArea;
+            float invW = l0 * a.invW + l1 * b.invW + l2 * c.invW;
+            size_t sample = (y - tile.y0) * tileWidth + (x - tile.x0);
+
+            // GL_LESS on depth, which is GREATER on 1/w
+            if (!(invW > tile.depth[sample])) continue;
+            tile.depth[sample] = invW;
+
+            glm::vec3 camera = (l0 * a.cameraW + l1 * b.cameraW + l2 * c.cameraW) / invW;
+            glm::vec3 normal = (l0 * a.normalW + l1 * b.normalW + l2 * c.normalW) / invW;
+            shadeFragment(&tile.color[3 * sample], camera, normal, lightCamera, options);
+        }
+    }
+}
+
+
+Image renderMesh(const Mesh& mesh, const RenderOptions& options, RenderStats* stats) {
+    TRACE_SCOPE("software_render");
+    const unsigned samples = std::max(1u, options.supersample);
+    const unsigned width = options.width * samples;
+    const unsigned height = options.height * samples;
+    const unsigned tileSize = std::max(1u, (options.tileSize + samples - 1) / samples) * samples;
+    const unsigned tilesX = (width + tileSize - 1) / tileSize;
+    const unsigned tilesY = (height + tileSize - 1) / tileSize;
+    const size_t tileCount = (size_t) tilesX * tilesY;
+    const size_t triangleCount = mesh.triangleCount();
+
+    // The viewer's camera: orbiting the origin, light at the eye
+    glm::vec3 eye = sphericalToCartesian(options.r, options.theta, options.phi);
+    Transform xf;
+    xf.view = glm::lookAt(eye, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    xf.projection = glm::perspective(glm::radians(options.fieldOfView), (float) width / height, NEAR_PLANE, FAR_PLANE);
+    xf.normalMatrix = glm::mat3(xf.view);
+    xf.width = width;
+    xf.height = height;
+    glm::vec3 lightCamera = glm::vec3(xf.view * glm::vec4(eye, 1.0f));
+
+    ThreadPool& pool = ThreadPool::shared();
+    RenderStats counted;
+    counted.triangles = triangleCount;
+    counted.tiles = tileCount;
+
+    // Bin every triangle into the tiles its bounds overlap; parts keep the mesh order
+    auto start = std::chrono::steady_clock::now();
+    const size_t parts = (triangleCount + BIN_TRIANGLES - 1) / BIN_TRIANGLES;
+    std::vector<std::vector<std::vector<uint32_t>>> bins(parts, std::vector<std::vector<uint32_t>>(tileCount));
+    std::vector<size_t> partBinned(parts, 0), partClipped(parts, 0);
+    pool.parallelFor(parts, [&](size_t p) {
+        TRACE_SCOPE("raster_bin");
+        ScreenTriangle screen[7];
+        for (size_t t = p * BIN_TRIANGLES; t < std::min(triangleCount, (p + 1) * BIN_TRIANGLES); ++t) {
+            bool clipped = false;
+            int count = setupTriangle(mesh, t, xf, screen, clipped);
+            partClipped[p] += clipped;
+
+            int64_t box[4] = {INT64_MAX, INT64_MIN, INT64_MAX, INT64_MIN};
+            for (int s = 0; s < count; ++s) {
+                int64_t bounds[4];
+                if (!pixelBounds(screen[s], width, height, bounds)) continue;
+                box[0] = std::min(box[0], bounds[0]);
+                box[1] = std::max(box[1], bounds[1]);
+                box[2] = std::min(box[2], bounds[2]);
+                box[3] = std::max(box[3], bounds[3]);
+            }
+            if (box[0] > box[1]) continue;
+
+            partBinned[p]++;
+            for (int64_t ty = box[2] / tileSize; ty <= box[3] / tileSize; ++ty) {
+                for (int64_t tx = box[0] / tileSize; tx <= box[1] / tileSize; ++tx) bins[p][ty * tilesX + tx].push_back(t);
+            }
+        }
+    }, options.threads);
+    for (size_t p = 0; p < parts; ++p) {
+        counted.binnedTriangles += partBinned[p];
+        counted.clippedTriangles += partClipped[p];
+    }
+    counted.binSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Rasterize every tile on its own and resolve its samples into the image
+    start = std::chrono::steady_clock::now();
+    Image image;
+    image.width = options.width;
+    image.height = options.height;
+    image.rgb.resize(3 * (size_t) image.width * image.height);
+    std::vector<size_t> tileEntries(tileCount, 0);
+    pool.parallelFor(tileCount, [&](size_t i) {
+        TRACE_SCOPE("raster_tile");
+        Tile tile;
+        tile.x0 = (i % tilesX) * tileSize;
+        tile.y0 = (i / tilesX) * tileSize;
+        tile.x1 = std::min<int64_t>(tile.x0 + tileSize, width);
+        tile.y1 = std::min<int64_t>(tile.y0 + tileSize, height);
+        size_t tileSamples = (tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+        tile.depth.assign(tileSamples, 0.0f);
+        tile.color.resize(3 * tileSamples);
+        for (size_t s = 0; s < tileSamples; ++s) std::copy(options.background, options.background + 3, &tile.color[3 * s]);
+
+        ScreenTriangle screen[7];
+        for (size_t p = 0; p < parts; ++p) {
+            tileEntries[i] += bins[p][i].size();
+            for (uint32_t t : bins[p][i]) {
+                bool clipped = false;
+                int count = setupTriangle(mesh, t, xf, screen, clipped);
+                for (int s = 0; s < count; ++s) rasterize(screen[s], tile, lightCamera, options, width, height);
+            }
+        }
+
+        // Average the samples of every pixel and convert to 8 bits like a unorm framebuffer
+        const int64_t tileWidth = tile.x1 - tile.x0;
+        for (int64_t y = tile.y0; y < tile.y1; y += samples) {
+            for (int64_t x = tile.x0; x < tile.x1; x += samples) {
+                float sum[3] = {0.0f, 0.0f, 0.0f};
+                for (unsigned sy = 0; sy < samples; ++sy) {
+                    for (unsigned sx = 0; sx < samples; ++sx) {
+                        const float* color = &tile.color[3 * ((y - tile.y0 + sy) * tileWidth + (x - tile.x0 + sx))];
+                        for (int c = 0; c < 3; ++c) sum[c] += color[c];
+                    }
+                }
+                uint8_t* pixel = &image.rgb[3 * ((y / samples) * image.width + x / samples)];
+                for (int c = 0; c < 3; ++c) pixel[c] = (uint8_t) std::lround(glm::clamp(sum[c] / (samples * samples), 0.0f, 1.0f) * 255.0f);
+            }
+        }
+    }, options.threads);
+    for (size_t n : tileEntries) counted.tileEntries += n;
+    counted.rasterSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (stats != nullptr) *stats = counted;
+    return image;
+}
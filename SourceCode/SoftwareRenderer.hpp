@@ -0,0 +1,91 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SoftwareRenderer.hpp
+ *
+ * @brief A multithreaded CPU rasterizer for rendering meshes without a GPU.
+ * It reproduces the viewer: the camera orbits the origin at the spherical
+ * coordinates (r, theta, phi) of sphericalToCartesian with the light at the
+ * eye, the projection is the viewer's 45 degree perspective, and every pixel
+ * is shaded with the Phong model of Shaders/PhongTexture.fragmentshader,
+ * blended over what is behind it like the viewer's GL_BLEND setup.
+ *
+ * The image is cut into square tiles. A first parallel pass transforms the
+ * triangles, clips those that cross the near plane or leave a wide guard
+ * band, and bins each one into the tiles its bounds overlap. A second
+ * parallel pass rasterizes every tile on its own, with its own depth buffer,
+ * drawing its triangles in mesh order, so the image is the same whatever the
+ * number of threads. Edges are evaluated in fixed point with a top-left fill
+ * rule, so triangles sharing an edge neither overlap nor leave cracks.
+ */
+
+#ifndef SOFTWARERENDERER_HPP
+#define SOFTWARERENDERER_HPP
+
+#include <stddef.h>
+
+#include "Constants.hpp"
+#include "ImageWriter.hpp"
+#include "Mesh.hpp"
+
+/***
+ * RenderOptions: the image, camera and material of a software render
+*/
+struct RenderOptions {
+    unsigned width = 512;                               // Image size in pixels
+    unsigned height = 512;
+    float r = 8.660254f;                                // Camera distance from the origin
+    float theta = 0.785398f;                            // Camera azimuth
+    float phi = 0.955317f;                              // Camera polar angle
+    float fieldOfView = 45.0f;                          // Vertical, in degrees
+    float color[4] = {0.0f, 0.8f, 0.8f, 1.0f};          // modelColor of the shader
+    float shininess = SHININESS;                        // Specular exponent of the shader
+    float background[3] = {0.2f, 0.2f, 0.3f};          // The viewer's clear colour
+    unsigned supersample = 2;                           // Samples per pixel along each axis, averaged
+    unsigned tileSize = 64;                             // Tile side in (supersampled) pixels
+    unsigned threads = 0;                               // 0 for the whole shared pool
+};
+
+/***
+ * RenderStats: the work of one render
+*/
+struct RenderStats {
+    size_t triangles = 0;
+    size_t binnedTriangles = 0; // Triangles at least partly in view
+    size_t clippedTriangles = 0;
+    size_t tileEntries = 0;     // Sum over tiles of the triangles binned into them
+    size_t tiles = 0;
+    double binSeconds = 0.0;
+    double rasterSeconds = 0.0;
+};
+
+/***
+ * @brief Render a triangle soup with its per-vertex normals.
+ * @param mesh The mesh
+ * @param options Image, camera and material
+ * @param[out] stats Optional, receives what the render did
+ * @return Image The rendered image
+*/
+Image renderMesh(const Mesh& mesh, const RenderOptions& options = RenderOptions(), RenderStats* stats = nullptr);
+
+/***
+ * @brief Shade one fragment with the Phong model of renderMesh, blended over a colour.
+ * Positions may be in camera space or in any frame translated to the eye,
+ * with the eye at the origin.
+ * @param[in,out] dst RGB behind the fragment, replaced by the blended colour
+ * @param position Position of the fragment
+ * @param normal Normal of the fragment, of any length
+ * @param light Position of the light
+ * @param options Material
+*/
+void shadePhong(float* dst, const float* position, const float* normal, const float* light, const RenderOptions& options);
+
+#endif // SOFTWARERENDERER_HPP
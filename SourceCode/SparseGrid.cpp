@@ -0,0 +1,217 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SparseGrid.cpp
+ *
+ * @brief Implementation of the narrow-band sparse sample storage.
+ */
+
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SparseGrid.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+
+/***
+ * @brief Grow a set of leaves by a number of leaves along one axis.
+ * @param[in,out] flags One byte per leaf, (li * ly + lj) * lz + lk
+ * @param stride Distance between neighbouring leaves along the axis
+ * @param count Leaves along the axis
+ * @param radius Leaves to grow by
+*/
+static void dilateAxis(std::vector<unsigned char>& flags, size_t stride, size_t count, size_t radius) {
+    std::vector<unsigned char> grown(flags.size(), 0);
+    for (size_t l = 0; l < flags.size(); ++l) {
+        if (!flags[l]) continue;
+        const size_t at = l / stride % count;
+        const size_t first = at - std::min(at, radius);
+        const size_t last = std::min(count - 1, at + radius);
+        for (size_t n = first; n <= last; ++n) grown[l + n * stride - at * stride] = 1;
+    }
+    flags.swap(grown);
+}
+
+
+template <typename Sampler>
+void SparseGrid::buildFrom(const Sampler& sample, const GridAxes& axes, float isovalue, unsigned bandLeaves, unsigned threads) {
+    TRACE_SCOPE("sparse_build");
+    ThreadPool& pool = ThreadPool::shared();
+    sx = axes.xs.size();
+    sy = axes.ys.size();
+    sz = axes.zs.size();
+    lx = (sx + SPARSE_LEAF - 1) / SPARSE_LEAF;
+    ly = (sy + SPARSE_LEAF - 1) / SPARSE_LEAF;
+    lz = (sz + SPARSE_LEAF - 1) / SPARSE_LEAF;
+    nx = (lx + SPARSE_NODE - 1) / SPARSE_NODE;
+    ny = (ly + SPARSE_NODE - 1) / SPARSE_NODE;
+    nz = (lz + SPARSE_NODE - 1) / SPARSE_NODE;
+    iso = isovalue;
+    const size_t leafSlots = lx * ly * lz;
+    auto leafSlot = [&](size_t li, size_t lj, size_t lk) { return (li * ly + lj) * lz + lk; };
+
+    // Pass one: the range of the samples of every leaf, kept only until the band is known
+    std::vector<float> lo(leafSlots), hi(leafSlots);
+    pool.parallelFor(lx, [&](size_t li) {
+        for (size_t lj = 0; lj < ly; ++lj) {
+            for (size_t lk = 0; lk < lz; ++lk) {
+                float low = FLT_MAX, high = -FLT_MAX;
+                for (size_t i = li * SPARSE_LEAF; i < std::min(sx, (li + 1) * SPARSE_LEAF); ++i) {
+                    for (size_t j = lj * SPARSE_LEAF; j < std::min(sy, (lj + 1) * SPARSE_LEAF); ++j) {
+                        for (size_t k = lk * SPARSE_LEAF; k < std::min(sz, (lk + 1) * SPARSE_LEAF); ++k) {
+                            float value = sample(i, j, k);
+                            low = std::min(low, value);
+                            high = std::max(high, value);
+                        }
+                    }
+                }
+                lo[leafSlot(li, lj, lk)] = low;
+                hi[leafSlot(li, lj, lk)] = high;
+            }
+        }
+    }, threads);
+
+    // The cells of a leaf have their corners in the leaf and the (up to seven) leaves after it,
+    // so a leaf whose samples and theirs straddle the isovalue may hold a crossed cell
+    std::vector<unsigned char> band(leafSlots, 0);
+    for (size_t li = 0; li < lx; ++li) {
+        for (size_t lj = 0; lj < ly; ++lj) {
+            for (size_t lk = 0; lk < lz; ++lk) {
+                float low = FLT_MAX, high = -FLT_MAX;
+                for (int n = 0; n < 8; ++n) {
+                    const size_t ni = li + (n & 1), nj = lj + (n >> 1 & 1), nk = lk + (n >> 2 & 1);
+                    if (ni >= lx || nj >= ly || nk >= lz) continue;
+                    low = std::min(low, lo[leafSlot(ni, nj, nk)]);
+                    high = std::max(high, hi[leafSlot(ni, nj, nk)]);
+                }
+                band[leafSlot(li, lj, lk)] = low < iso && high >= iso;
+            }
+        }
+    }
+
+    // Grow the band, which also stores the leaves after every crossed leaf that its cells read
+    const size_t radius = std::max(1u, bandLeaves);
+    dilateAxis(band, ly * lz, lx, radius);
+    dilateAxis(band, lz, ly, radius);
+    dilateAxis(band, 1, lz, radius);
+
+    // Allocate the internal nodes holding a leaf of the band and number their leaves in node order
+    root.assign(nx * ny * nz, SPARSE_TILE);
+    rootTiles.assign(nx * ny * nz, 0.0f);
+    nodes.clear();
+    leafOrigins.clear();
+    for (size_t ni = 0; ni < nx; ++ni) {
+        for (size_t nj = 0; nj < ny; ++nj) {
+            for (size_t nk = 0; nk < nz; ++nk) {
+                const size_t slot = (ni * ny + nj) * nz + nk;
+                bool used = false;
+                float low = FLT_MAX, high = -FLT_MAX;
+                for (size_t li = ni * SPARSE_NODE; li < std::min(lx, (ni + 1) * SPARSE_NODE); ++li) {
+                    for (size_t lj = nj * SPARSE_NODE; lj < std::min(ly, (nj + 1) * SPARSE_NODE); ++lj) {
+                        for (size_t lk = nk * SPARSE_NODE; lk < std::min(lz, (nk + 1) * SPARSE_NODE); ++lk) {
+                            used = used || band[leafSlot(li, lj, lk)];
+                            low = std::min(low, lo[leafSlot(li, lj, lk)]);
+                            high = std::max(high, hi[leafSlot(li, lj, lk)]);
+                        }
+                    }
+                }
+
+                // Without a leaf of the band every leaf of the node is on one side of the isovalue
+                if (!used) {
+                    rootTiles[slot] = 0.5f * low + 0.5f * high;
+                    continue;
+                }
+
+                root[slot] = nodes.size();
+                nodes.emplace_back();
+                SparseNode& node = nodes.back();
+                for (size_t child = 0; child < SPARSE_NODE_SLOTS; ++child) {
+                    const size_t li = ni * SPARSE_NODE + child / (SPARSE_NODE * SPARSE_NODE);
+                    const size_t lj = nj * SPARSE_NODE + child / SPARSE_NODE % SPARSE_NODE;
+                    const size_t lk = nk * SPARSE_NODE + child % SPARSE_NODE;
+                    node.leaves[child] = SPARSE_TILE;
+                    node.tiles[child] = 0.0f;
+                    if (li >= lx || lj >= ly || lk >= lz) continue;
+
+                    const size_t l = leafSlot(li, lj, lk);
+                    if (band[l]) {
+                        node.leaves[child] = leafOrigins.size() / 3;
+                        leafOrigins.push_back(li * SPARSE_LEAF);
+                        leafOrigins.push_back(lj * SPARSE_LEAF);
+                        leafOrigins.push_back(lk * SPARSE_LEAF);
+                    } else {
+                        node.tiles[child] = 0.5f * lo[l] + 0.5f * hi[l];
+                    }
+                }
+            }
+        }
+    }
+    TRACE_COUNT("sparse_leaves", leafCount());
+
+    // Pass two: sample the leaves of the band; the padding of partial leaves is never read
+    leafData.assign(leafCount() * SPARSE_LEAF_SAMPLES, 0.0f);
+    pool.parallelFor(leafCount(), [&](size_t leaf) {
+        const size_t i0 = leafOrigins[3 * leaf], j0 = leafOrigins[3 * leaf + 1], k0 = leafOrigins[3 * leaf + 2];
+        float* samples = &leafData[leaf * SPARSE_LEAF_SAMPLES];
+        for (size_t i = i0; i < std::min(sx, i0 + SPARSE_LEAF); ++i) {
+            for (size_t j = j0; j < std::min(sy, j0 + SPARSE_LEAF); ++j) {
+                float* row = &samples[((i - i0) * SPARSE_LEAF + j - j0) * SPARSE_LEAF];
+                for (size_t k = k0; k < std::min(sz, k0 + SPARSE_LEAF); ++k) row[k - k0] = sample(i, j, k);
+            }
+        }
+    }, threads);
+}
+
+
+void SparseGrid::build(const ScalarField& f, const GridAxes& axes, float isovalue, unsigned bandLeaves, unsigned threads) {
+    buildFrom([&](size_t i, size_t j, size_t k) { return f(axes.xs[i], axes.ys[j], axes.zs[k]); }, axes, isovalue, bandLeaves, threads);
+}
+
+
+void SparseGrid::build(const float* volume, const GridAxes& axes, float isovalue, unsigned bandLeaves, unsigned threads) {
+    const size_t sy = axes.ys.size(), sz = axes.zs.size();
+    buildFrom([&](size_t i, size_t j, size_t k) { return volume[(i * sy + j) * sz + k]; }, axes, isovalue, bandLeaves, threads);
+}
+
+
+bool SparseGrid::buildFromRawFile(const std::string& path, const GridAxes& axes, float isovalue, unsigned bandLeaves, unsigned threads) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open raw volume %s\n", path.c_str());
+        return false;
+    }
+
+    const size_t length = axes.xs.size() * axes.ys.size() * axes.zs.size() * sizeof(float);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size != length) {
+        fprintf(stderr, "Raw volume %s is not %zu x %zu x %zu floats\n", path.c_str(), axes.xs.size(), axes.ys.size(), axes.zs.size());
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Failed to map raw volume %s\n", path.c_str());
+        return false;
+    }
+
+    build((const float*) data, axes, isovalue, bandLeaves, threads);
+    munmap(data, length);
+    return true;
+}
@@ -0,0 +1,216 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SparseGrid.hpp
+ *
+ * @brief Field samples stored only in a narrow band around an isosurface.
+ * A dense SampleGrid holds a float for every corner of the grid, although
+ * marching cubes only emits triangles from the cells the surface crosses;
+ * for a torus in [-5, 5]^3 that is a few percent of them. A SparseGrid is a
+ * three level tree in the manner of a VDB:
+ *
+ * leaves: 8 x 8 x 8 samples (2 KiB), allocated only in the band
+ * internal nodes: 16 x 16 x 16 leaves (128^3 samples), allocated only where
+ * they hold a leaf; a slot without a leaf holds a tile value instead
+ * root: one slot per internal node of the grid, holding the node or a tile value
+ *
+ * The band is made of the leaves some cell of which may cross the
+ * isovalue, grown by bandLeaves leaves in every direction. Leaves are kept
+ * in the order of their internal nodes, so the leaves of a node lie
+ * together in memory. A tile value is on the same side of the isovalue as
+ * every sample it stands for, so a lookup outside the band still tells
+ * inside from outside.
+ *
+ * The memory is that of the band, which scales with the area of the
+ * surface; building from a field still samples every corner once (keeping
+ * only a minimum and maximum per leaf), and samples the band again.
+ * Extracting at the isovalue the grid was built for gives the same
+ * triangles as the dense grid; other isovalues are only exact where the
+ * band covers their surface.
+ *
+ * Example:
+ *
+ * GridAxes axes = gridAxes(Grid::cube(-5, 5, 0.01f));
+ * SparseGrid samples;
+ * samples.build(f4, axes, 0.0f);
+ * Mesh torus;
+ * marching_cubes_sparse(samples, axes, 0.0f, torus);
+ */
+
+#ifndef SPARSEGRID_HPP
+#define SPARSEGRID_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+#include "SampleGrid.hpp"
+
+// Samples along each side of a leaf, the brick size of SampleGrid
+const size_t SPARSE_LEAF = SAMPLE_BRICK;
+const size_t SPARSE_LEAF_SAMPLES = SPARSE_LEAF * SPARSE_LEAF * SPARSE_LEAF;
+
+// Leaves along each side of an internal node
+const size_t SPARSE_NODE = 16;
+const size_t SPARSE_NODE_SLOTS = SPARSE_NODE * SPARSE_NODE * SPARSE_NODE;
+
+// A slot of an internal node, or of the root, holding a tile value
+const uint32_t SPARSE_TILE = UINT32_MAX;
+
+/***
+ * SparseNode: an internal node, 16 x 16 x 16 slots of a leaf or a tile value
+*/
+struct SparseNode {
+    uint32_t leaves[SPARSE_NODE_SLOTS]; // Leaf of slot ((li * 16) + lj) * 16 + lk, or SPARSE_TILE
+    float tiles[SPARSE_NODE_SLOTS];     // Value of the slots without a leaf
+};
+
+/***
+ * SparseGrid: the samples of a grid in a narrow band around an isosurface
+*/
+class SparseGrid {
+
+private:
+
+    size_t sx = 0, sy = 0, sz = 0;         // Samples along each axis
+    size_t lx = 0, ly = 0, lz = 0;         // Leaves along each axis
+    size_t nx = 0, ny = 0, nz = 0;         // Internal nodes along each axis
+    float iso = 0.0f;
+    std::vector<uint32_t> root;            // Node of slot (ni * ny + nj) * nz + nk, or SPARSE_TILE
+    std::vector<float> rootTiles;          // Value of the root slots without a node
+    std::vector<SparseNode> nodes;
+    std::vector<uint32_t> leafOrigins;     // First sample (i, j, k) of every leaf
+    std::vector<float> leafData;           // SPARSE_LEAF_SAMPLES per leaf, (i * 8 + j) * 8 + k within it
+
+    template <typename Sampler>
+    void buildFrom(const Sampler& sampler, const GridAxes& axes, float isovalue, unsigned bandLeaves, unsigned threads);
+
+public:
+
+    SparseGrid() = default;
+
+    /***
+     * @brief Sample a field in the band around one of its isosurfaces.
+     * @param f Scalar field, called concurrently from several threads
+     * @param axes Corner coordinates of the grid
+     * @param isovalue The isovalue the band follows
+     * @param bandLeaves Leaves added around the crossed leaves in every direction (at least 1)
+     * @param threads Maximum number of threads, 0 for the whole shared pool
+    */
+    void build(const ScalarField& f, const GridAxes& axes, float isovalue, unsigned bandLeaves = 1, unsigned threads = 0);
+
+    /***
+     * @brief Keep the band of a volume of samples, one per corner of the grid.
+     * @param volume Sample (i, j, k) at (i * (ny + 1) + j) * (nz + 1) + k, like SampleLayout::RowMajor
+     * @param axes Corner coordinates of the grid
+     * @param isovalue The isovalue the band follows
+     * @param bandLeaves Leaves added around the crossed leaves in every direction (at least 1)
+     * @param threads Maximum number of threads, 0 for the whole shared pool
+    */
+    void build(const float* volume, const GridAxes& axes, float isovalue, unsigned bandLeaves = 1, unsigned threads = 0);
+
+    /***
+     * @brief Keep the band of a raw volume file of native endian 32 bit floats.
+     * The file is memory-mapped, so only its pages are read, never a copy.
+     * @param path The file, laid out like the volume of build
+     * @param axes Corner coordinates of the grid, giving the size of the volume
+     * @param isovalue The isovalue the band follows
+     * @param bandLeaves Leaves added around the crossed leaves in every direction (at least 1)
+     * @param threads Maximum number of threads, 0 for the whole shared pool
+     * @return bool True if the file holds exactly one float per corner and was read
+    */
+    bool buildFromRawFile(const std::string& path, const GridAxes& axes, float isovalue, unsigned bandLeaves = 1, unsigned threads = 0);
+
+    /***
+     * @brief The sample of corner (i, j, k), or the tile value standing for it.
+    */
+    float operator()(size_t i, size_t j, size_t k) const {
+        const size_t li = i / SPARSE_LEAF, lj = j / SPARSE_LEAF, lk = k / SPARSE_LEAF;
+        const size_t slot = ((li / SPARSE_NODE) * ny + lj / SPARSE_NODE) * nz + lk / SPARSE_NODE;
+        if (root[slot] == SPARSE_TILE) return rootTiles[slot];
+        const SparseNode& node = nodes[root[slot]];
+        const size_t child = ((li % SPARSE_NODE) * SPARSE_NODE + lj % SPARSE_NODE) * SPARSE_NODE + lk % SPARSE_NODE;
+        if (node.leaves[child] == SPARSE_TILE) return node.tiles[child];
+        return leafData[node.leaves[child] * SPARSE_LEAF_SAMPLES
+                        + ((i % SPARSE_LEAF) * SPARSE_LEAF + j % SPARSE_LEAF) * SPARSE_LEAF + k % SPARSE_LEAF];
+    }
+
+    /***
+     * @brief Visit the cells of one leaf with their eight corners.
+     * The corners of the leaf's cells, which reach one sample into the
+     * leaves after it, are first gathered into a 9 x 9 x 9 block on the
+     * stack, the samples outside the leaf through the tree.
+     * @param leaf Index of the leaf, below leafCount()
+     * @param visit Called as visit(i, j, k, corners) like SampleGrid::forEachCell
+    */
+    template <typename Visit>
+    void forEachLeafCell(size_t leaf, Visit&& visit) const {
+        const size_t i0 = leafOrigins[3 * leaf], j0 = leafOrigins[3 * leaf + 1], k0 = leafOrigins[3 * leaf + 2];
+        if (i0 + 1 >= sx || j0 + 1 >= sy || k0 + 1 >= sz) return; // No cell starts in the leaf
+        const size_t ci = std::min(SPARSE_LEAF, sx - 1 - i0);
+        const size_t cj = std::min(SPARSE_LEAF, sy - 1 - j0);
+        const size_t ck = std::min(SPARSE_LEAF, sz - 1 - k0);
+
+        const size_t B = SPARSE_LEAF + 1;
+        const float* samples = &leafData[leaf * SPARSE_LEAF_SAMPLES];
+        float block[B * B * B];
+        for (size_t i = 0; i <= ci; ++i) {
+            for (size_t j = 0; j <= cj; ++j) {
+                float* dst = &block[(i * B + j) * B];
+                if (i < SPARSE_LEAF && j < SPARSE_LEAF) {
+                    const float* row = &samples[(i * SPARSE_LEAF + j) * SPARSE_LEAF];
+                    for (size_t k = 0; k <= ck; ++k) dst[k] = k < SPARSE_LEAF ? row[k] : (*this)(i0 + i, j0 + j, k0 + k);
+                } else {
+                    for (size_t k = 0; k <= ck; ++k) dst[k] = (*this)(i0 + i, j0 + j, k0 + k);
+                }
+            }
+        }
+
+        float corners[8];
+        for (size_t i = 0; i < ci; ++i) {
+            for (size_t j = 0; j < cj; ++j) {
+                for (size_t k = 0; k < ck; ++k) {
+                    const float* p = &block[(i * B + j) * B + k];
+                    corners[0] = p[0];
+                    corners[1] = p[B * B];
+                    corners[2] = p[B];
+                    corners[3] = p[B * B + B];
+                    corners[4] = p[1];
+                    corners[5] = p[B * B + 1];
+                    corners[6] = p[B + 1];
+                    corners[7] = p[B * B + B + 1];
+                    visit(i0 + i, j0 + j, k0 + k, corners);
+                }
+            }
+        }
+    }
+
+    float isovalue() const { return iso; }
+    size_t leafCount() const { return leafOrigins.size() / 3; }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t sizeX() const { return sx; }
+    size_t sizeY() const { return sy; }
+    size_t sizeZ() const { return sz; }
+
+    /***
+     * @brief Bytes of the tree: the root, the internal nodes and the leaves.
+    */
+    size_t bytes() const {
+        return root.size() * sizeof(uint32_t) + rootTiles.size() * sizeof(float) + nodes.size() * sizeof(SparseNode)
+             + leafOrigins.size() * sizeof(uint32_t) + leafData.size() * sizeof(float);
+    }
+};
+
+#endif // SPARSEGRID_HPP
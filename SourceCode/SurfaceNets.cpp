@@ -0,0 +1,249 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SurfaceNets.cpp
+ *
+ * @brief Implementation of the Surface Nets kernel.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "SurfaceNets.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+// Cells without a vertex
+const uint32_t NO_VERTEX = UINT32_MAX;
+
+/***
+ * SlabVertices: the vertex of every cell of one x slab, if the surface crosses it
+*/
+struct SlabVertices {
+    std::vector<uint32_t> index;       // Per cell (j * nz + k), into the vectors below
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> cells;       // The cell of every vertex
+    std::vector<uint8_t> inside;       // Its corners below the isovalue, bit c for corner c
+};
+
+
+/***
+ * @brief Sample the field on one plane of grid corners.
+*/
+static void samplePlane(const ScalarField& f, const GridAxes& axes, size_t i, std::vector<float>& plane) {
+    const size_t nz = axes.nz();
+    for (size_t j = 0; j <= axes.ny(); ++j) {
+        for (size_t k = 0; k <= nz; ++k) plane[j * (nz + 1) + k] = f(axes.xs[i], axes.ys[j], axes.zs[k]);
+    }
+}
+
+
+/***
+ * @brief Place the vertex of every crossed cell of slab i, at the mean of its edge crossings.
+ * @param nearPlane Samples of plane i
+ * @param farPlane Samples of plane i + 1
+*/
+static void placeVertices(const GridAxes& axes, size_t i, const std::vector<float>& nearPlane, const std::vector<float>& farPlane, float isoval, SlabVertices& slab) {
+    const size_t ny = axes.ny();
+    const size_t nz = axes.nz();
+    slab.index.assign(ny * nz, NO_VERTEX);
+    slab.positions.clear();
+    slab.cells.clear();
+    slab.inside.clear();
+
+    for (size_t j = 0; j < ny; ++j) {
+        const float* near0 = &nearPlane[j * (nz + 1)];
+        const float* near1 = near0 + nz + 1;
+        const float* far0 = &farPlane[j * (nz + 1)];
+        const float* far1 = far0 + nz + 1;
+        for (size_t k = 0; k < nz; ++k) {
+            // Corner c is offset by (c & 1, c >> 1 & 1, c >> 2 & 1) cells
+            const float values[8] = {near0[k], far0[k], near1[k], far1[k], near0[k + 1], far0[k + 1], near1[k + 1], far1[k + 1]};
+            int inside = 0;
+            for (int c = 0; c < 8; ++c) inside |= (values[c] < isoval) << c;
+            if (inside == 0 || inside == 0xFF) continue;
+
+            const glm::vec3 origin(axes.xs[i], axes.ys[j], axes.zs[k]);
+            const glm::vec3 size(axes.xs[i + 1] - axes.xs[i], axes.ys[j + 1] - axes.ys[j], axes.zs[k + 1] - axes.zs[k]);
+            glm::vec3 sum(0.0f);
+            int crossings = 0;
+            for (int c = 0; c < 8; ++c) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    const int d = c | 1 << axis;
+                    if (d == c || ((inside >> c) & 1) == ((inside >> d) & 1)) continue;
+
+                    // Linear interpolation of the crossing along the edge c -> d
+                    float t = (isoval - values[c]) / (values[d] - values[c]);
+                    glm::vec3 corner((c & 1) * size.x, (c >> 1 & 1) * size.y, (c >> 2 & 1) * size.z);
+                    corner[axis] += t * size[axis];
+                    sum += corner;
+                    crossings++;
+                }
+            }
+
+            slab.index[j * nz + k] = slab.positions.size();
+            slab.positions.push_back(origin + sum / (float) crossings);
+            slab.cells.push_back(j * nz + k);
+            slab.inside.push_back(inside);
+        }
+    }
+}
+
+
+/***
+ * @brief Emit a triangle with the normal of compute_normals.
+*/
+static void emitTriangle(Mesh& mesh, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 norm = glm::normalize(glm::cross(a - b, a - c));
+    const size_t n = mesh.vertices.size();
+    mesh.vertices.resize(n + 9);
+    mesh.normals.resize(n + 9);
+    float* vertices = &mesh.vertices[n];
+    float* normals = &mesh.normals[n];
+    for (const glm::vec3* v : {&a, &b, &c}) {
+        *vertices++ = v->x;
+        *vertices++ = v->y;
+        *vertices++ = v->z;
+        *normals++ = norm.x;
+        *normals++ = norm.y;
+        *normals++ = norm.z;
+    }
+    mesh.stats.addTriangle(&mesh.vertices[n]);
+}
+
+
+/***
+ * @brief Emit the quad of a crossed edge as two triangles.
+ * @param quad The four cell vertices, counter-clockwise around the edge's axis
+ * @param increasing Whether the field goes from below to above the isovalue along the axis
+*/
+static void emitQuad(Mesh& mesh, const glm::vec3* quad[4], bool increasing) {
+    // Marching cubes faces its triangles the way the field increases
+    if (!increasing) std::swap(quad[1], quad[3]);
+
+    const glm::vec3 d02 = *quad[0] - *quad[2];
+    const glm::vec3 d13 = *quad[1] - *quad[3];
+    if (glm::dot(d02, d02) <= glm::dot(d13, d13)) {
+        emitTriangle(mesh, *quad[0], *quad[1], *quad[2]);
+        emitTriangle(mesh, *quad[0], *quad[2], *quad[3]);
+    }
+    else {
+        emitTriangle(mesh, *quad[0], *quad[1], *quad[3]);
+        emitTriangle(mesh, *quad[1], *quad[2], *quad[3]);
+    }
+}
+
+
+bool surface_nets(const ScalarField& f, const Grid& grid, float isoval, Mesh& mesh, unsigned threads, const ProgressCallback& progress, const CancellationToken& cancel) {
+    const GridAxes axes = gridAxes(grid);
+    const size_t nx = axes.nx();
+    const size_t ny = axes.ny();
+    const size_t nz = axes.nz();
+    mesh.clear();
+    if (nx == 0 || ny == 0 || nz == 0) return true;
+
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size() + 1;
+
+    // Blocks of consecutive slabs, a few per thread for load balance
+    const size_t slabsPerBlock = std::max<size_t>(1, nx / (4 * threads));
+    const size_t blocks = (nx + slabsPerBlock - 1) / slabsPerBlock;
+    std::vector<Mesh> parts(blocks);
+    std::atomic<size_t> completed(0);
+
+    pool.parallelFor(blocks, [&](size_t b) {
+        const size_t first = b * slabsPerBlock;
+        const size_t last = std::min(nx, first + slabsPerBlock);
+        TRACE_SLAB_SCOPE("surface_nets", first);
+
+        // The quads on plane first join the cells of slab first - 1, so that slab is placed too
+        const size_t start = first > 0 ? first - 1 : 0;
+        std::vector<float> nearPlane((ny + 1) * (nz + 1));
+        std::vector<float> farPlane((ny + 1) * (nz + 1));
+        samplePlane(f, axes, start, nearPlane);
+        SlabVertices previous, current;
+        Mesh& part = parts[b];
+
+        for (size_t i = start; i < last; ++i) {
+            if (cancel.cancelled()) return;
+            samplePlane(f, axes, i + 1, farPlane);
+            placeVertices(axes, i, nearPlane, farPlane, isoval, current);
+
+            // Every crossed edge is the x, y or z edge leaving the first corner of a crossed cell
+            if (i >= first) {
+                const glm::vec3* quad[4];
+                auto cell = [](const SlabVertices& slab, size_t c) { return &slab.positions[slab.index[c]]; };
+
+                for (size_t v = 0; v < current.cells.size(); ++v) {
+                    const size_t j = current.cells[v] / nz;
+                    const size_t k = current.cells[v] % nz;
+                    const int inside = current.inside[v];
+                    const bool increasing = inside & 1;
+
+                    // x edge inside slab i, joining the cells (j - 1..j, k - 1..k) of the slab
+                    if (j > 0 && k > 0 && ((inside ^ inside >> 1) & 1)) {
+                        quad[0] = cell(current, (j - 1) * nz + k - 1);
+                        quad[1] = cell(current, j * nz + k - 1);
+                        quad[2] = cell(current, j * nz + k);
+                        quad[3] = cell(current, (j - 1) * nz + k);
+                        emitQuad(part, quad, increasing);
+                    }
+
+                    // y and z edges on plane i, joining cells of slabs i - 1 and i
+                    if (i > 0 && k > 0 && ((inside ^ inside >> 2) & 1)) {
+                        quad[0] = cell(previous, j * nz + k - 1);
+                        quad[1] = cell(previous, j * nz + k);
+                        quad[2] = cell(current, j * nz + k);
+                        quad[3] = cell(current, j * nz + k - 1);
+                        emitQuad(part, quad, increasing);
+                    }
+                    if (i > 0 && j > 0 && ((inside ^ inside >> 4) & 1)) {
+                        quad[0] = cell(previous, (j - 1) * nz + k);
+                        quad[1] = cell(current, (j - 1) * nz + k);
+                        quad[2] = cell(current, j * nz + k);
+                        quad[3] = cell(previous, j * nz + k);
+                        emitQuad(part, quad, increasing);
+                    }
+                }
+            }
+
+            previous.cells.swap(current.cells);
+            previous.inside.swap(current.inside);
+            previous.index.swap(current.index);
+            previous.positions.swap(current.positions);
+            nearPlane.swap(farPlane);
+        }
+
+        TRACE_COUNT("cells", (last - first) * ny * nz);
+        if (progress) progress(completed += last - first, nx);
+    }, threads);
+    if (cancel.cancelled()) return false;
+
+    // Gather the blocks in order into one exactly sized mesh
+    std::vector<size_t> offsets(blocks + 1, 0);
+    for (size_t b = 0; b < blocks; ++b) {
+        offsets[b + 1] = offsets[b] + parts[b].vertices.size();
+        mesh.stats.merge(parts[b].stats);
+    }
+    mesh.vertices.resize(offsets[blocks]);
+    mesh.normals.resize(offsets[blocks]);
+    pool.parallelFor(blocks, [&](size_t b) {
+        std::copy(parts[b].vertices.begin(), parts[b].vertices.end(), mesh.vertices.begin() + offsets[b]);
+        std::copy(parts[b].normals.begin(), parts[b].normals.end(), mesh.normals.begin() + offsets[b]);
+        parts[b] = Mesh();
+    }, threads);
+    TRACE_COUNT("triangles", mesh.triangleCount());
+    return true;
+}
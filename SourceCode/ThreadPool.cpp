@@ -0,0 +1,106 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file ThreadPool.cpp
+ *
+ * @brief Implementation of the shared thread pool.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "ThreadPool.hpp"
+
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i) workers.emplace_back([this]() { workerLoop(); });
+}
+
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body, unsigned maxThreads) {
+    if (count == 0) return;
+
+    // Shared with the helper tasks, which may only start after this call has returned
+    struct Loop {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        size_t count;
+        const std::function<void(size_t)>* body;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<Loop> loop = std::make_shared<Loop>();
+    loop->count = count;
+    loop->body = &body;
+
+    // body stays alive until every claimed iteration is done, so only claimed iterations touch it
+    auto work = [](Loop& loop) {
+        size_t i;
+        while ((i = loop.next.fetch_add(1)) < loop.count) {
+            (*loop.body)(i);
+            if (loop.done.fetch_add(1) + 1 == loop.count) {
+                std::lock_guard<std::mutex> lock(loop.mutex);
+                loop.finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min<size_t>(size(), count - 1);
+    if (maxThreads > 0) helpers = std::min<size_t>(helpers, maxThreads - 1);
+    for (size_t h = 0; h < helpers; ++h) submit([loop, work]() { work(*loop); });
+
+    work(*loop);
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finished.wait(lock, [&]() { return loop->done.load() == loop->count; });
+}
+
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,87 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file ThreadPool.hpp
+ *
+ * @brief A fixed-size pool of worker threads shared by the library.
+ * Tasks are queued with submit(). parallelFor() splits a loop over the
+ * pool; the calling thread takes part in the loop and only waits for the
+ * iterations other threads have already claimed, so a parallelFor issued
+ * from inside a pool task cannot deadlock even when every worker is busy.
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***
+ * ThreadPool: a fixed set of workers draining a task queue
+*/
+class ThreadPool {
+
+private:
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+
+    /***
+     * @brief Start the workers.
+     * @param threads Number of workers, 0 for one per hardware thread
+    */
+    explicit ThreadPool(unsigned threads = 0);
+
+    /***
+     * @brief Finish the queued tasks and join the workers.
+    */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /***
+     * @brief Number of worker threads.
+    */
+    unsigned size() const { return workers.size(); }
+
+    /***
+     * @brief Queue a task to run on a worker.
+    */
+    void submit(std::function<void()> task);
+
+    /***
+     * @brief Run body(i) for every i in [0, count) across the pool and the calling thread.
+     * @param count Number of iterations
+     * @param body Loop body, called concurrently from several threads
+     * @param maxThreads Upper bound on the threads working on the loop, 0 for no bound
+    */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body, unsigned maxThreads = 0);
+
+    /***
+     * @brief The pool shared by the whole process, one worker per hardware thread.
+    */
+    static ThreadPool& shared();
+};
+
+#endif // THREADPOOL_HPP
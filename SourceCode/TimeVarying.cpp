@@ -0,0 +1,124 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file TimeVarying.cpp
+ *
+ * @brief Implementation of the incremental extraction of time-varying fields.
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+#include "ThreadPool.hpp"
+#include "TimeVarying.hpp"
+#include "Trace.hpp"
+
+
+IncrementalExtractor::IncrementalExtractor(const TimeVaryingField& field, const Grid& grid, size_t brickCells, unsigned threads, SampleLayout layout)
+    : field(field), axes(gridAxes(grid)), threads(threads), samples(axes, layout), previous(axes, layout) {
+    const size_t nx = axes.nx(), ny = axes.ny(), nz = axes.nz();
+    const size_t b = std::max<size_t>(1, brickCells);
+
+    for (size_t i = 0; i < nx; i += b) {
+        for (size_t j = 0; j < ny; j += b) {
+            for (size_t k = 0; k < nz; k += b) {
+                boxes.push_back({i, std::min(nx, i + b), j, std::min(ny, j + b), k, std::min(nz, k + b)});
+            }
+        }
+    }
+    meshes.resize(boxes.size());
+}
+
+
+void IncrementalExtractor::step(float t, float isoval, Mesh& mesh) {
+    ThreadPool& pool = ThreadPool::shared();
+    IncrementalStats stats;
+    stats.bricks = boxes.size();
+
+    // Sample the new time step, keeping the previous one for comparison
+    auto start = std::chrono::steady_clock::now();
+    previous.swap(samples);
+    {
+        TRACE_SCOPE("sample_step");
+        samples.sample([&](float x, float y, float z) { return field(x, y, z, t); }, axes, threads);
+    }
+    auto sampled = std::chrono::steady_clock::now();
+
+    // Re-polygonize the bricks whose samples changed and that straddle the isovalue or held triangles
+    const bool isoChanged = first || isoval != lastIsovalue;
+    std::vector<unsigned char> changed(boxes.size(), 0);
+    std::vector<unsigned char> extracted(boxes.size(), 0);
+    {
+        TRACE_SCOPE("repolygonize");
+        pool.parallelFor(boxes.size(), [&](size_t b) {
+            const CellBox& box = boxes[b];
+            bool samplesChanged = first;
+            float lo = samples(box.i0, box.j0, box.k0);
+            float hi = lo;
+
+            // Every corner of the brick, one sample brick at a time; k runs are contiguous in both layouts
+            CellBox corners = {box.i0, box.i1 + 1, box.j0, box.j1 + 1, box.k0, box.k1 + 1};
+            samples.forEachBrick(corners, [&](const CellBox& part) {
+                const size_t span = part.k1 - part.k0;
+                for (size_t i = part.i0; i < part.i1; ++i) {
+                    for (size_t j = part.j0; j < part.j1; ++j) {
+                        const float* now = &samples(i, j, part.k0);
+                        const float* before = &previous(i, j, part.k0);
+                        if (!samplesChanged && memcmp(now, before, span * sizeof(float)) != 0) samplesChanged = true;
+                        for (size_t k = 0; k < span; ++k) {
+                            lo = std::min(lo, now[k]);
+                            hi = std::max(hi, now[k]);
+                        }
+                    }
+                }
+            });
+
+            // A brick only has triangles if some corner is below the isovalue and some is not
+            bool straddles = lo < isoval && hi >= isoval;
+            bool hadTriangles = !meshes[b].vertices.empty();
+            changed[b] = samplesChanged;
+            if ((samplesChanged || isoChanged) && (straddles || hadTriangles)) {
+                meshes[b].clear();
+                if (straddles) marching_cubes_sampled(samples, axes, box, isoval, meshes[b]);
+                extracted[b] = 1;
+            }
+        }, threads);
+    }
+
+    // Assemble the frame from the brick meshes
+    size_t floats = 0;
+    for (size_t b = 0; b < boxes.size(); ++b) {
+        floats += meshes[b].vertices.size();
+        stats.changedBricks += changed[b];
+        stats.extractedBricks += extracted[b];
+    }
+    mesh.vertices.resize(floats);
+    mesh.normals.resize(floats);
+    mesh.stats = MeshStats();
+    size_t offset = 0;
+    for (const Mesh& brick : meshes) {
+        std::copy(brick.vertices.begin(), brick.vertices.end(), mesh.vertices.begin() + offset);
+        std::copy(brick.normals.begin(), brick.normals.end(), mesh.normals.begin() + offset);
+        mesh.stats.merge(brick.stats);
+        offset += brick.vertices.size();
+    }
+    auto done = std::chrono::steady_clock::now();
+
+    stats.triangles = floats / 9;
+    stats.sampleSeconds = std::chrono::duration<double>(sampled - start).count();
+    stats.extractSeconds = std::chrono::duration<double>(done - sampled).count();
+    TRACE_COUNT("bricks_extracted", stats.extractedBricks);
+
+    first = false;
+    lastIsovalue = isoval;
+    lastStats = stats;
+}
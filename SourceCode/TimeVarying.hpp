@@ -0,0 +1,98 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file TimeVarying.hpp
+ *
+ * @brief Incremental extraction of time-varying fields for playback.
+ * The extractor keeps the samples of the previous time step and the mesh of
+ * every brick of the grid. A step samples the field at the new time, then
+ * re-polygonizes only the bricks whose samples changed (bit for bit) and
+ * that either straddle the isovalue now or held triangles before; every
+ * other brick keeps its mesh. The brick meshes are then concatenated into
+ * the frame. Each frame holds exactly the triangles a full extraction at
+ * that time would produce, grouped by brick. The samples are kept in the
+ * bricked layout of SampleGrid, so scanning and polygonizing a brick reads
+ * contiguous memory instead of one short row per plane.
+ */
+
+#ifndef TIMEVARYING_HPP
+#define TIMEVARYING_HPP
+
+#include <stddef.h>
+#include <vector>
+
+#include "Fields.hpp"
+#include "MarchingCubes.hpp"
+#include "Mesh.hpp"
+#include "SampleGrid.hpp"
+
+/***
+ * IncrementalStats: the work done by the last step
+*/
+struct IncrementalStats {
+    size_t bricks = 0;          // Bricks in the grid
+    size_t changedBricks = 0;   // Bricks whose samples changed
+    size_t extractedBricks = 0; // Bricks re-polygonized
+    size_t triangles = 0;       // Triangles in the frame
+    double sampleSeconds = 0;   // Time spent sampling the field
+    double extractSeconds = 0;  // Time spent re-polygonizing and assembling the frame
+};
+
+/***
+ * IncrementalExtractor: extracts successive time steps of one field over one grid
+*/
+class IncrementalExtractor {
+
+private:
+
+    TimeVaryingField field;
+    GridAxes axes;
+    unsigned threads;
+    std::vector<CellBox> boxes;
+    std::vector<Mesh> meshes;
+    SampleGrid samples;
+    SampleGrid previous;
+    bool first = true;
+    float lastIsovalue = 0.0f;
+    IncrementalStats lastStats;
+
+public:
+
+    /***
+     * @brief Prepare the bricks and sample storage of a grid.
+     * @param field Time-varying field, called concurrently from several threads
+     * @param grid The sampled box and step size
+     * @param brickCells Cells along each side of a brick
+     * @param threads Maximum number of threads, 0 for the whole shared pool
+     * @param layout Memory order of the samples
+    */
+    IncrementalExtractor(const TimeVaryingField& field, const Grid& grid, size_t brickCells = 16, unsigned threads = 0, SampleLayout layout = SampleLayout::Bricked);
+
+    /***
+     * @brief Extract the isosurface at the next time step.
+     * @param t Time passed to the field
+     * @param isoval Isovalue, which may change between steps
+     * @param[out] mesh Receives the frame; its storage is reused across calls
+    */
+    void step(float t, float isoval, Mesh& mesh);
+
+    /***
+     * @brief The meshes of the bricks after the last step, in brick order.
+    */
+    const std::vector<Mesh>& brickMeshes() const { return meshes; }
+
+    /***
+     * @brief The work done by the last step.
+    */
+    const IncrementalStats& stats() const { return lastStats; }
+};
+
+#endif // TIMEVARYING_HPP
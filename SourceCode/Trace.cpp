@@ -0,0 +1,179 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Trace.cpp
+ *
+ * @brief Recording and export of trace events and counters.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "Trace.hpp"
+
+std::mutex traceMutex;
+std::vector<std::unique_ptr<TraceThreadBuffer>> traceBuffers;
+const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+std::atomic<bool> traceEnabled(false);
+
+
+void traceEnable(bool enabled) {
+    traceEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+uint64_t traceNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+
+TraceThreadBuffer& traceThreadBuffer() {
+    thread_local TraceThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        traceBuffers.emplace_back(new TraceThreadBuffer());
+        buffer = traceBuffers.back().get();
+        buffer->tid = traceBuffers.size();
+    }
+    return *buffer;
+}
+
+
+void traceCount(const char* name, uint64_t value) {
+    if (!traceEnabled.load(std::memory_order_relaxed)) return;
+
+    std::vector<TraceCounter>& counters = traceThreadBuffer().counters;
+    for (TraceCounter& counter : counters) {
+        if (strcmp(counter.name, name) == 0) {
+            counter.value += value;
+            return;
+        }
+    }
+    counters.push_back({name, value});
+}
+
+
+void traceRecord(const char* name, int64_t slab, uint64_t start, uint64_t duration) {
+    TraceThreadBuffer& buffer = traceThreadBuffer();
+    if (buffer.events.size() < TRACE_MAX_EVENTS) buffer.events.push_back({name, slab, start, duration});
+    else buffer.dropped++;
+
+    for (TraceStage& stage : buffer.stages) {
+        if (strcmp(stage.name, name) == 0) {
+            stage.count++;
+            stage.total += duration;
+            stage.max = std::max(stage.max, duration);
+            stage.first = std::min(stage.first, start);
+            stage.last = std::max(stage.last, start + duration);
+            return;
+        }
+    }
+    buffer.stages.push_back({name, 1, duration, duration, start, start + duration});
+}
+
+
+bool traceWriteChrome(const std::string& path) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == NULL) {
+        fprintf(stderr, "Failed to write trace file %s\n", path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+    for (const auto& buffer : traceBuffers) {
+        fprintf(out, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"thread %u\"}}",
+                first ? "" : ",\n", buffer->tid, buffer->tid);
+        first = false;
+
+        uint64_t last = 0;
+        for (const TraceEvent& event : buffer->events) {
+            fprintf(out, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f",
+                    event.name, buffer->tid, event.start / 1e3, event.duration / 1e3);
+            if (event.slab >= 0) fprintf(out, ", \"args\": {\"slab\": %lld}", (long long) event.slab);
+            fprintf(out, "}");
+            last = std::max(last, event.start + event.duration);
+        }
+
+        for (const TraceCounter& counter : buffer->counters) {
+            fprintf(out, ",\n{\"name\": \"%s\", \"ph\": \"C\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"args\": {\"%s\": %llu}}",
+                    counter.name, buffer->tid, last / 1e3, counter.name, (unsigned long long) counter.value);
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    for (const auto& buffer : traceBuffers) {
+        if (buffer->dropped > 0) {
+            fprintf(stderr, "Trace of thread %u holds its first %zu events, %llu later ones are only in the summary\n",
+                    buffer->tid, buffer->events.size(), (unsigned long long) buffer->dropped);
+        }
+    }
+
+    return fclose(out) == 0;
+}
+
+
+void tracePrintSummary() {
+    struct Stage {
+        uint64_t count = 0;
+        uint64_t total = 0;
+        uint64_t max = 0;
+    };
+
+    std::map<std::string, Stage> stages;
+    std::map<std::string, uint64_t> counters;
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    for (const auto& buffer : traceBuffers) {
+        for (const TraceStage& recorded : buffer->stages) {
+            Stage& stage = stages[recorded.name];
+            stage.count += recorded.count;
+            stage.total += recorded.total;
+            stage.max = std::max(stage.max, recorded.max);
+            first = std::min(first, recorded.first);
+            last = std::max(last, recorded.last);
+        }
+        for (const TraceCounter& counter : buffer->counters) counters[counter.name] += counter.value;
+    }
+    uint64_t wall = last > first ? last - first : 0;
+
+    printf("\n%-20s %10s %12s %12s %12s %8s\n", "stage", "calls", "total ms", "mean us", "max us", "% wall");
+    for (const auto& entry : stages) {
+        const Stage& stage = entry.second;
+        printf("%-20s %10llu %12.3f %12.3f %12.3f %8.1f\n", entry.first.c_str(),
+               (unsigned long long) stage.count, stage.total / 1e6,
+               stage.total / 1e3 / stage.count, stage.max / 1e3,
+               wall > 0 ? 100.0 * stage.total / wall : 0.0);
+    }
+
+    if (!counters.empty()) {
+        printf("\n%-20s %16s\n", "counter", "total");
+        for (const auto& entry : counters) {
+            printf("%-20s %16llu\n", entry.first.c_str(), (unsigned long long) entry.second);
+        }
+    }
+}
+
+
+float estimateRemainingSeconds(float elapsedSeconds, size_t completed, size_t total) {
+    if (completed == 0) return -1.0f;
+    return elapsedSeconds * (float) (total - completed) / (float) completed;
+}
+
@@ -0,0 +1,174 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file Trace.hpp
+ *
+ * @brief Lightweight scoped timers and counters for the extraction pipeline.
+ * Timers record one complete event per scope into a buffer owned by the
+ * calling thread, tagged with the slab being processed, so recording never
+ * takes a lock. Tracing is off until traceEnable() is called; while it is
+ * off a timer costs one relaxed atomic load. Building with
+ * -DISO_DISABLE_TRACE removes the instrumentation altogether.
+ *
+ * At exit the events can be written as a Chrome/Perfetto trace JSON
+ * (load it in chrome://tracing or ui.perfetto.dev) and summarized as a
+ * table of total, mean and maximum time per stage plus counter totals.
+ * Each thread keeps its first TRACE_MAX_EVENTS events for the trace file;
+ * the summary covers every event.
+ *
+ * Macros:
+ *
+ * TRACE_SCOPE(name): Time the enclosing scope
+ * TRACE_SLAB_SCOPE(name, slab): Time the enclosing scope, tagged with a slab index
+ * TRACE_COUNT(name, value): Add value to a per-thread counter
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+struct TraceEvent {
+    const char* name;
+    int64_t slab;
+    uint64_t start;    // nanoseconds since the trace epoch
+    uint64_t duration; // nanoseconds
+};
+
+struct TraceCounter {
+    const char* name;
+    uint64_t value;
+};
+
+struct TraceStage {
+    const char* name;
+    uint64_t count;
+    uint64_t total;  // nanoseconds
+    uint64_t max;    // nanoseconds
+    uint64_t first;  // start of the earliest event
+    uint64_t last;   // end of the latest event
+};
+
+// Events kept per thread for the Chrome trace; later ones only count towards the summary
+const size_t TRACE_MAX_EVENTS = 1 << 20;
+
+struct TraceThreadBuffer {
+    uint32_t tid;
+    std::vector<TraceEvent> events;    // The first TRACE_MAX_EVENTS events
+    std::vector<TraceStage> stages;    // Every event, summed per name
+    std::vector<TraceCounter> counters;
+    uint64_t dropped = 0;              // Events beyond TRACE_MAX_EVENTS
+};
+
+extern std::atomic<bool> traceEnabled;
+
+/***
+ * @brief Turn recording on or off.
+*/
+void traceEnable(bool enabled);
+
+/***
+ * @brief Nanoseconds since the trace epoch.
+*/
+uint64_t traceNow();
+
+/***
+ * @brief The buffer of the calling thread, registered on first use.
+ * Buffers outlive their threads so that the trace can be written at exit.
+*/
+TraceThreadBuffer& traceThreadBuffer();
+
+/***
+ * @brief Add a value to a counter of the calling thread.
+ * Counters are matched by their text, so the same name used in several
+ * files is one counter.
+ * @param name Counter name, a string literal
+ * @param value Amount to add
+*/
+void traceCount(const char* name, uint64_t value);
+
+/***
+ * @brief Record one event of the calling thread.
+ * It is added to the totals of its stage, and kept for the Chrome trace
+ * while the thread holds fewer than TRACE_MAX_EVENTS events, so a long
+ * interactive session does not grow without bound.
+ * @param name Stage name, a string literal
+ * @param slab Slab index, or -1
+ * @param start Nanoseconds since the trace epoch
+ * @param duration Nanoseconds
+*/
+void traceRecord(const char* name, int64_t slab, uint64_t start, uint64_t duration);
+
+/***
+ * ScopedTimer: records the lifetime of a scope as one trace event
+*/
+class ScopedTimer {
+
+private:
+
+    const char* name;
+    int64_t slab;
+    uint64_t start;
+    bool active;
+
+public:
+
+    ScopedTimer(const char* name, int64_t slab = -1) : name(name), slab(slab), start(0),
+        active(traceEnabled.load(std::memory_order_relaxed)) {
+        if (active) start = traceNow();
+    }
+
+    ~ScopedTimer() {
+        if (active) traceRecord(name, slab, start, traceNow() - start);
+    }
+};
+
+
+#ifdef ISO_DISABLE_TRACE
+#define TRACE_SCOPE(name)
+#define TRACE_SLAB_SCOPE(name, slab)
+#define TRACE_COUNT(name, value)
+#else
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) ScopedTimer TRACE_CONCAT(traceTimer, __LINE__)(name)
+#define TRACE_SLAB_SCOPE(name, slab) ScopedTimer TRACE_CONCAT(traceTimer, __LINE__)(name, slab)
+#define TRACE_COUNT(name, value) traceCount(name, value)
+#endif
+
+
+/***
+ * @brief Write all recorded events and counters as a Chrome trace JSON file.
+ * @param path Output path
+ * @return bool True if the file was written
+*/
+bool traceWriteChrome(const std::string& path);
+
+/***
+ * @brief Print the total, mean and maximum time of every stage and the counter totals.
+*/
+void tracePrintSummary();
+
+/***
+ * @brief Estimate the remaining time of a run from its completed slabs.
+ * @param elapsedSeconds Time since the run started
+ * @param completed Number of completed slabs
+ * @param total Total number of slabs
+ * @return float Estimated seconds left, or a negative value before the first slab completes
+*/
+float estimateRemainingSeconds(float elapsedSeconds, size_t completed, size_t total);
+
+
+#endif // TRACE_HPP
@@ -26,13 +26,16 @@
  * positions of vertices used to construct polygons in 3D space. Each row of
  * the table corresponds to a vertex and contains the (x, y, z) position of
  * the vertex.
+ *
+ * Both tables are inline variables, so the header can be included by any
+ * number of translation units.
  */
 
 #ifndef TRITABLE_HPP
 #define TRITABLE_HPP
 
 
-int marching_cubes_lut[256][16] =
+inline int marching_cubes_lut[256][16] =
 {{-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
 {0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
 {0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
@@ -292,7 +295,7 @@ int marching_cubes_lut[256][16] =
 };
 
 
-float vertTable[12][3] = {
+inline float vertTable[12][3] = {
 	{0.5f, 0.0f, 0.0f},
 	{1.0f, 0.0f, 0.5f},
 	{0.5f, 0.0f, 1.0f},
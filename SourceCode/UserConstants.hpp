@@ -19,16 +19,59 @@
  * Constants:
  * 
  * FILE_NAME: Default output file name for the generated PLY file (default: "output.ply").
+ * OUTPUT_DIRECTORY: Directory of the generated PLY file (default: "../OutputPLYFiles/").
+ * PLY_PRECISION: Significant digits of the floats in the PLY file, 0 for the shortest digits
+ * that read back exactly (default: 6).
  * ZOOM_SPEED: Zoom speed controlled by arrow keys (default: 6.0f).
  * MOUSE_SPEED: Mouse speed control by cursor and left (default: 0.5f).
+ * USE_MESH_CACHE: Whether extracted meshes are cached on disk (default: true).
+ * CACHE_DIRECTORY: Directory holding the cached meshes (default: "../MeshCache/").
+ * CACHE_MAX_BYTES: Size cap of the mesh cache before LRU eviction (default: 2 GiB).
+ * TWO_PASS_EXTRACTION: Extract with the exact-allocation two-pass kernel instead of
+ * streaming bricks into the viewer as they complete, nearest the camera first (default: false).
+ * ANIMATION_SPEED: Field time advanced per second of playback with --animate (default: 1.0f).
+ * ANIMATION_BRICK_CELLS: Cells per side of the bricks re-extracted during playback (default: 16).
+ * OPTIMIZE_MESH: Weld the extracted mesh, reorder it for the vertex cache and draw and write it
+ * indexed with smooth normals, instead of flat triangles (default: false).
+ * FRUSTUM_CULLING: Store the finished mesh as spatial chunks and draw only those inside the
+ * view frustum (default: true).
+ * RENDER_CHUNK_CELLS: Cells per side of the chunks (default: 32).
+ * DAEMON_MAX_JOBS: Extractions the --daemon service runs at once (default: 2).
+ * DAEMON_MAX_QUEUED: Jobs the --daemon service queues before holding clients back (default: 64).
+ * THUMBNAIL_SUPERSAMPLE: Samples per pixel along each axis of --thumbnail images (default: 2).
+ * RAYCAST_MACRO_CELLS: Macro cells along the longest side of the box that --raycast rays
+ * skip through where the surface cannot be (default: 64).
  */
 
 #ifndef USERCONSTANTS_HPP
 #define USERCONSTANTS_HPP
 
-std::string FILE_NAME = "output.ply"; // Choose a file name for the output PLY file
-float ZOOM_SPEED = 6.0f;              // Zoom speed controlled by arrow keys
-float MOUSE_SPEED = 0.5f;             // Mouse speed control by cursor and left
+#include <stddef.h>
+#include <string>
+
+inline std::string FILE_NAME = "output.ply";               // Choose a file name for the output PLY file
+inline std::string OUTPUT_DIRECTORY = "../OutputPLYFiles/"; // Where the output PLY file is written
+inline int PLY_PRECISION = 6;                               // Significant digits of the written floats
+inline float ZOOM_SPEED = 6.0f;                             // Zoom speed controlled by arrow keys
+inline float MOUSE_SPEED = 0.5f;                            // Mouse speed control by cursor and left
+
+inline bool USE_MESH_CACHE = true;                          // Reuse meshes from previous identical runs
+inline std::string CACHE_DIRECTORY = "../MeshCache/";       // Where cached meshes are stored
+inline unsigned long long CACHE_MAX_BYTES = 2ULL << 30;     // Evict least recently used meshes above this size
+
+inline bool TWO_PASS_EXTRACTION = false;                    // Count then emit into an exactly sized mesh
+inline bool OPTIMIZE_MESH = false;                          // Draw and write a vertex-cache-ordered indexed mesh
+inline bool FRUSTUM_CULLING = true;                         // Draw only the mesh chunks inside the view
+inline size_t RENDER_CHUNK_CELLS = 32;                      // Cells per side of the mesh chunks
+
+inline float ANIMATION_SPEED = 1.0f;                        // Field time advanced per second of playback
+inline size_t ANIMATION_BRICK_CELLS = 16;                   // Cells per side of the playback bricks
+
+inline unsigned DAEMON_MAX_JOBS = 2;                        // Extractions the daemon runs at once
+inline size_t DAEMON_MAX_QUEUED = 64;                       // Jobs queued before clients are held back
+
+inline unsigned THUMBNAIL_SUPERSAMPLE = 2;                  // Samples per pixel along each axis of --thumbnail
+inline unsigned RAYCAST_MACRO_CELLS = 64;                   // Macro cells along the box for --raycast
 
 
 #endif // USERCONSTANTS_HPP
\ No newline at end of file
@@ -22,8 +22,9 @@
  * 
  * Worldboundaries: A class for drawing the boundaries of the world. This class
  * has a constructor that takes three glm::vec3 objects as input to define the
- * world boundaries. It also contains a draw() function that draws the coordinate
- * axes and a box that encloses the world boundaries using OpenGL.
+ * world boundaries and uploads the coordinate axes and the box enclosing them
+ * into a vertex buffer once. Its draw() function draws that buffer with the
+ * shader program in use, in flat colours.
  * 
  */
 
@@ -44,83 +45,108 @@ private:
 	glm::vec3 posBound;
 	glm::vec3 negBound;
 
+	GLuint vaoID = 0;
+	GLuint vboID = 0;
+
+	// Vertices of the buffer: two lines per axis, then the box as a line strip
+	static const GLint AXIS_VERTICES = 4;
+	static const GLint BOX_FIRST = 3 * AXIS_VERTICES;
+	static const GLint BOX_VERTICES = 16;
+
 public:
 
 	/**
 	 * @brief Constructs a Worldboundaries object with the given origin and 
-	 * positive and negative bounds in each of the three axes.
+	 * positive and negative bounds in each of the three axes, and uploads
+	 * its geometry. Needs a current OpenGL context.
 	 * 
 	 * @param origin The origin point for the world boundaries.
 	 * @param posBound The positive bounds in each of the three axes.
 	 * @param negBound The negative bounds in each of the three axes.
 	 */
 	Worldboundaries(glm::vec3 origin, glm::vec3 posBound, glm::vec3 negBound) : 
-	origin(origin), posBound(posBound), negBound(negBound) {}
+	origin(origin), posBound(posBound), negBound(negBound) {
+
+		const glm::vec3 vertices[BOX_FIRST + BOX_VERTICES] = {
+			// X-axis
+			origin, origin + glm::vec3(posBound.x, 0.0f, 0.0f),
+			origin, origin + glm::vec3(negBound.x, 0.0f, 0.0f),
+
+			// Y-axis
+			origin, origin + glm::vec3(0.0f, posBound.y, 0.0f),
+			origin, origin + glm::vec3(0.0f, negBound.y, 0.0f),
+
+			// Z-axis
+			origin, origin + glm::vec3(0.0f, 0.0f, posBound.z),
+			origin, origin + glm::vec3(0.0f, 0.0f, negBound.z),
+
+			// Box
+			{negBound.x, negBound.y, negBound.z},
+			{posBound.x, negBound.y, negBound.z},
+			{posBound.x, negBound.y, posBound.z},
+			{negBound.x, negBound.y, posBound.z},
+
+			{negBound.x, negBound.y, negBound.z},
+			{negBound.x, posBound.y, negBound.z},
+			{posBound.x, posBound.y, negBound.z},
+			{posBound.x, negBound.y, negBound.z},
+
+			{posBound.x, posBound.y, negBound.z},
+			{posBound.x, posBound.y, posBound.z},
+			{posBound.x, negBound.y, posBound.z},
+			{posBound.x, posBound.y, posBound.z},
+
+			{negBound.x, posBound.y, posBound.z},
+			{negBound.x, negBound.y, posBound.z},
+			{negBound.x, posBound.y, posBound.z},
+			{negBound.x, posBound.y, negBound.z},
+		};
+
+		glGenVertexArrays(1, &vaoID);
+		glGenBuffers(1, &vboID);
+		glBindVertexArray(vaoID);
+		glBindBuffer(GL_ARRAY_BUFFER, vboID);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
+		glBindVertexArray(0);
+	}
 
 	/**
-	 * @brief Draws the coordinate axes and box that encloses the world 
-	 * boundaries using OpenGL.
+	 * @brief Draws the coordinate axes and the box that encloses the world
+	 * boundaries with the shader program in use.
+	 * 
+	 * @param colorID Location of the colour uniform
+	 * @param unlitID Location of the uniform that turns lighting off
 	 */
-	void draw() {
-
-		glMatrixMode( GL_MODELVIEW );
-		glPushMatrix();
+	void draw(GLint colorID, GLint unlitID) const {
+		glUniform1i(unlitID, GL_TRUE);
+		glBindVertexArray(vaoID);
 
 		// DRAW THE COORDINATE AXES
-		glLineWidth(2.0f);
-		glBegin(GL_LINES);
-
-		// X-axis
-		glColor3f(1.0f, 0.0f, 0.0f);
-		glVertex3f(origin.x, origin.y, origin.z);
-		glVertex3f(origin.x + posBound.x, origin.y, origin.z);
-		glVertex3f(origin.x, origin.y, origin.z);
-		glVertex3f(origin.x + negBound.x, origin.y, origin.z);
-
-		// Y-axis
-		glColor3f(0.0f, 1.0f, 0.0f);
-		glVertex3f(origin.x, origin.y, origin.z);
-		glVertex3f(origin.x, origin.y + posBound.y, origin.z);
-		glVertex3f(origin.x, origin.y, origin.z);
-		glVertex3f(origin.x, origin.y + negBound.y, origin.z);
-
-		// Z-axis
-		glColor3f(0.0f, 0.0f, 1.0f);
-		glVertex3f(origin.x, origin.y, origin.z);
-		glVertex3f(origin.x, origin.y, origin.z + posBound.z);
-		glVertex3f(origin.x, origin.y, origin.z);
-		glVertex3f(origin.x, origin.y, origin.z + negBound.z);
-		
-		
-		glEnd();
+		glUniform4f(colorID, 1.0f, 0.0f, 0.0f, 1.0f);
+		glDrawArrays(GL_LINES, 0, AXIS_VERTICES);
+		glUniform4f(colorID, 0.0f, 1.0f, 0.0f, 1.0f);
+		glDrawArrays(GL_LINES, AXIS_VERTICES, AXIS_VERTICES);
+		glUniform4f(colorID, 0.0f, 0.0f, 1.0f, 1.0f);
+		glDrawArrays(GL_LINES, 2 * AXIS_VERTICES, AXIS_VERTICES);
 
 		// DRAW THE BOX
-		glColor3f(0.8f, 0.8f, 0.0f);
-		glLineWidth(2.0f);
-		glBegin(GL_LINE_STRIP);
-			glVertex3f(negBound.x, negBound.y, negBound.z);
-			glVertex3f(posBound.x, negBound.y, negBound.z); 
-			glVertex3f(posBound.x, negBound.y, posBound.z);
-			glVertex3f(negBound.x, negBound.y, posBound.z);
-
-			glVertex3f(negBound.x, negBound.y, negBound.z);
-			glVertex3f(negBound.x, posBound.y, negBound.z);
-			glVertex3f(posBound.x, posBound.y, negBound.z);
-			glVertex3f(posBound.x, negBound.y, negBound.z);	
-
-			glVertex3f(posBound.x, posBound.y, negBound.z);
-			glVertex3f(posBound.x, posBound.y, posBound.z);
-			glVertex3f(posBound.x, negBound.y, posBound.z);
-			glVertex3f(posBound.x, posBound.y, posBound.z);
-
-			glVertex3f(negBound.x, posBound.y, posBound.z);
-			glVertex3f(negBound.x, negBound.y, posBound.z);
-			glVertex3f(negBound.x, posBound.y, posBound.z);
-			glVertex3f(negBound.x, posBound.y, negBound.z);
-			
-		glEnd();
-
-		glPopMatrix();
+		glUniform4f(colorID, 0.8f, 0.8f, 0.0f, 1.0f);
+		glDrawArrays(GL_LINE_STRIP, BOX_FIRST, BOX_VERTICES);
+
+		glBindVertexArray(0);
+		glUniform1i(unlitID, GL_FALSE);
+	}
+
+	/**
+	 * @brief Deletes the buffers, while the OpenGL context still exists.
+	 */
+	void release() {
+		glDeleteBuffers(1, &vboID);
+		glDeleteVertexArrays(1, &vaoID);
+		vboID = 0;
+		vaoID = 0;
 	}
 
 };
\ No newline at end of file
@@ -0,0 +1,713 @@
+/***
+ * Ryan Hecht
+ * Professor Brandt
+ * CS 3388 Computer Graphics I
+ * Due Date: 10 April 2023
+ *
+ * Created: 19 October 2026
+ * Last Edited: 19 October 2026
+ *
+ * Assignment 5
+ *
+ * @file bench.cpp
+ *
+ * @brief Micro and macro benchmarks of the isosurface extraction pipeline.
+ *
+ * @details Built with "make bench", this program times every stage of the
+ * pipeline in isolation and end to end, without opening a window:
+ *
+ * field/fN: evaluation of each generating function over the sample grid
+ * classify: computing the cube configuration of every cell from its samples
+ * emit: looking up and emitting the triangles of every cell
+ * compute_normals: the per-triangle normals of a full mesh
+ * mesh_stats: area, volume and bounds of a full mesh in a pass of their own,
+ * the pass the extraction kernels save by accumulating them as they emit
+ * weld / components: welding the mesh and labelling its connected components
+ * region_refine: splicing a refinement of a region of interest into the
+ * mesh; the run fails if the welded surface then has a different number
+ * of connected components than before
+ * vertex_cache: reordering the welded mesh for the vertex cache, with the
+ * simulated ACMR and ATVR before and after
+ * frustum_cull: culling the chunks of the welded mesh against a view frustum
+ * software_render: rasterizing the mesh on the CPU into a 512 x 512 image
+ * with 2 x 2 samples per pixel, from the viewer's starting camera
+ * raycast: ray casting the same image straight from the field, against
+ * extracting and rasterizing a mesh at the step size, half and a quarter of it
+ * writePLY: writing a full mesh as a PLY file, with the 6 significant digits
+ * of the default, with the shortest round-trip digits, and with the stream
+ * formatting the writer used before (writePLY_stream) for comparison
+ * end_to_end: marching_cubes_async across step sizes and thread counts
+ * two_pass: marching_cubes_two_pass (count, then emit into an exact allocation)
+ * surface_nets: the Surface Nets engine over the same grids, with its
+ * triangle count relative to marching cubes
+ * incremental_step: one playback step of the time-varying version of the function
+ * sample_layout: polygonizing a large sampled grid in 16^3 cell bricks from
+ * row-major and from bricked (Morton-ordered) samples, with the last-level
+ * and L1 data cache misses of one run where perf counters are available
+ * sparse_grid: building a narrow-band sparse grid of the same samples, and
+ * polygonizing its leaves, with its size against the dense grid's
+ * csg_scene: sampling CSG unions of 64, 512 and 4096 primitives point by
+ * point through their hierarchy, exhaustively, and brick by brick in batches
+ * cancel_latency: from cancelling a running two-pass extraction job to the
+ * job having stopped, which is bounded by the time of one slab
+ * batch: one large and twelve small jobs of two isovalues each, extracted
+ * back to back and as one batch scheduled on the shared thread pool
+ * daemon_throughput: concurrent clients of the extraction daemon, half of
+ * them asking for the same mesh
+ *
+ * Each benchmark is repeated and the fastest run is reported, together with
+ * its throughput (cells/s, triangles/s, bytes written/s) and the peak
+ * resident set size of the process so far. The results are printed as a
+ * table, and as JSON when --json is given, so that runs of different
+ * versions can be compared for regressions.
+ *
+ * @note How to Run
+ * ./assign5_bench [--json=results.json] [--repeat=3] [--function=4] [--iso=0] [--quick]
+ * Without --json the JSON document is not written; --json=- prints it to stdout.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "IsoSurface.hpp"
+#include "Constants.hpp"
+#include "TriTable.hpp"
+
+
+scalar_field_3d benchFields[8] = {f1, f2, f3, f4, f5, f6, f7, f8};
+
+/***
+ * One row of the benchmark report
+*/
+struct BenchResult {
+    std::string name;
+    std::string params;
+    double seconds;
+    double cellsPerSecond;
+    double trianglesPerSecond;
+    double bytesPerSecond;
+    long peakRSSKiB;
+};
+
+std::vector<BenchResult> results;
+
+
+/***
+ * @brief Peak resident set size of the process in KiB.
+*/
+long peakRSS() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+
+/***
+ * @brief Time a benchmark body and keep the fastest of several runs.
+ * @param repeat Number of runs
+ * @param body The code to time
+ * @return double Seconds taken by the fastest run
+*/
+double timeBest(int repeat, const std::function<void()>& body) {
+    double best = 1e300;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+
+/***
+ * @brief The PLY writer before the chunked formatting, formatting every number with operator<<.
+ * @param vertices A list of vertices
+ * @param normals A list of normals
+ * @param outputPath The output PLY file path
+*/
+void writePLYStream(const std::vector<float>& vertices, const std::vector<float>& normals, const std::string& outputPath) {
+    std::ofstream out(outputPath);
+    writePLYHeader(out, vertices.size() / 3);
+    for (size_t i = 0; i < vertices.size(); i += 3) {
+        out << vertices[i] << " " << vertices[i + 1] << " " << vertices[i + 2] << " ";
+        out << normals[i] << " " << normals[i + 1] << " " << normals[i + 2] << "\n";
+    }
+    for (size_t i = 0; i < vertices.size() / 3; i += 3) {
+        out << "3 " << i << " " << (i + 1) << " " << (i + 2) << "\n";
+    }
+}
+
+
+/***
+ * CacheCounter: a hardware cache event of the calling thread, counted with
+ * perf_event_open where the kernel and the machine allow it
+*/
+class CacheCounter {
+
+private:
+
+    int fd = -1;
+
+public:
+
+    explicit CacheCounter(uint32_t type, uint64_t config) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~CacheCounter() { if (fd >= 0) close(fd); }
+
+    bool available() const { return fd >= 0; }
+
+    /***
+     * @brief Count the events of one run of a body.
+     * @return long long The count, or -1 without perf counters
+    */
+    long long count(const std::function<void()>& body) {
+        if (fd < 0) {
+            body();
+            return -1;
+        }
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        body();
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long value = 0;
+        return read(fd, &value, sizeof(value)) == sizeof(value) ? value : -1;
+    }
+};
+
+
+/***
+ * @brief Record a benchmark result and print it as a table row.
+*/
+void report(const std::string& name, const std::string& params, double seconds, double cells, double triangles, double bytes) {
+    BenchResult result = {name, params, seconds,
+                          cells / seconds, triangles / seconds, bytes / seconds, peakRSS()};
+    results.push_back(result);
+    printf("%-18s %-28s %10.3f ms %12.3e %12.3e %12.3e %10ld\n", name.c_str(), params.c_str(),
+           seconds * 1e3, result.cellsPerSecond, result.trianglesPerSecond,
+           result.bytesPerSecond, result.peakRSSKiB);
+}
+
+
+/***
+ * @brief Write all results as a JSON document.
+ * @param path Output path, or "-" for stdout
+*/
+void writeJSON(const std::string& path) {
+    FILE* out = path == "-" ? stdout : fopen(path.c_str(), "w");
+    if (out == NULL) {
+        fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return;
+    }
+
+    fprintf(out, "{\n  \"engine_version\": %d,\n  \"hardware_threads\": %u,\n  \"results\": [\n",
+            ENGINE_VERSION, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"params\": \"%s\", \"seconds\": %.9g, "
+                     "\"cells_per_second\": %.6g, \"triangles_per_second\": %.6g, "
+                     "\"bytes_per_second\": %.6g, \"peak_rss_kib\": %ld}%s\n",
+                r.name.c_str(), r.params.c_str(), r.seconds, r.cellsPerSecond,
+                r.trianglesPerSecond, r.bytesPerSecond, r.peakRSSKiB,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+
+    if (out != stdout) fclose(out);
+}
+
+
+/***
+ * @brief Run marching_cubes_async on several threads, each taking a contiguous range of x slabs.
+ * The per-thread meshes are concatenated in slab order, giving the same mesh as a single call.
+*/
+void marchingCubesThreaded(std::vector<float>& vertices, std::vector<float>& normals, scalar_field_3d f, float isoval, float min, float max, float stepsize, unsigned threads) {
+    std::vector<float> xs = gridAxis(min, max, stepsize);
+    size_t slabs = xs.size() - 1;
+    threads = std::max(1u, std::min<unsigned>(threads, slabs));
+
+    std::vector<std::vector<float>> partVertices(threads), partNormals(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t first = slabs * t / threads;
+        size_t last = slabs * (t + 1) / threads;
+        float partMax = (last == slabs) ? max : xs[last];
+        workers.emplace_back([&, t, first, partMax]() {
+            marching_cubes_async(partVertices[t], partNormals[t], f, isoval, xs[first], partMax, min, max, min, max, stepsize);
+        });
+    }
+
+    for (unsigned t = 0; t < threads; ++t) {
+        workers[t].join();
+        vertices.insert(vertices.end(), partVertices[t].begin(), partVertices[t].end());
+        normals.insert(normals.end(), partNormals[t].begin(), partNormals[t].end());
+    }
+}
+
+
+/***
+ * @brief Main entry point of the benchmark program.
+ * @param argc Number of command-line arguments
+ * @param argv Array of command-line arguments
+ * @return int 0 if the benchmarks ran successfully
+*/
+int main(int argc, char* argv[]) {
+    std::string jsonPath;
+    int repeat = 3;
+    int func = 4;
+    float isoval = 0.0f;
+    bool quick = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--json=", 7) == 0) jsonPath = argv[i] + 7;
+        else if (strncmp(argv[i], "--repeat=", 9) == 0) repeat = std::max(1, atoi(argv[i] + 9));
+        else if (strncmp(argv[i], "--function=", 11) == 0) func = std::min(8, std::max(1, atoi(argv[i] + 11)));
+        else if (strncmp(argv[i], "--iso=", 6) == 0) isoval = atof(argv[i] + 6);
+        else if (strcmp(argv[i], "--quick") == 0) quick = true;
+        else {
+            fprintf(stderr, "Unknown argument %s\n", argv[i]);
+            return -1;
+        }
+    }
+
+    const float min = -5.0f;
+    const float max = 5.0f;
+    const float stepsize = quick ? 0.2f : 0.1f;
+    scalar_field_3d f = benchFields[func - 1];
+
+    std::vector<float> axis = gridAxis(min, max, stepsize);
+    const size_t n = axis.size() - 1; // cells per axis
+    const double cells = (double) n * n * n;
+    char params[128];
+
+    printf("%-18s %-28s %13s %12s %12s %12s %10s\n", "benchmark", "params", "time",
+           "cells/s", "tris/s", "bytes/s", "peakKiB");
+
+    // Field evaluation over the (n + 1)^3 sample points
+    std::vector<float> samples((n + 1) * (n + 1) * (n + 1));
+    for (int fi = 0; fi < 8; ++fi) {
+        double seconds = timeBest(repeat, [&]() {
+            size_t s = 0;
+            for (size_t i = 0; i <= n; ++i)
+                for (size_t j = 0; j <= n; ++j)
+                    for (size_t k = 0; k <= n; ++k)
+                        samples[s++] = benchFields[fi](axis[i], axis[j], axis[k]);
+        });
+        snprintf(params, sizeof(params), "step=%g", stepsize);
+        report("field/f" + std::to_string(fi + 1), params, seconds, cells, 0, 0);
+    }
+
+    // Cell classification from the samples of the selected function
+    size_t s = 0;
+    for (size_t i = 0; i <= n; ++i)
+        for (size_t j = 0; j <= n; ++j)
+            for (size_t k = 0; k <= n; ++k)
+                samples[s++] = f(axis[i], axis[j], axis[k]);
+
+    auto sample = [&](size_t i, size_t j, size_t k) { return samples[(i * (n + 1) + j) * (n + 1) + k]; };
+    std::vector<unsigned char> cases(n * n * n);
+    snprintf(params, sizeof(params), "f%d iso=%g step=%g", func, isoval, stepsize);
+
+    double seconds = timeBest(repeat, [&]() {
+        size_t c = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                for (size_t k = 0; k < n; ++k) {
+                    int which = 0;
+                    if (sample(i, j + 1, k + 1) < isoval) which |= NEAR_TOP_LEFT;
+                    if (sample(i + 1, j + 1, k + 1) < isoval) which |= NEAR_TOP_RIGHT;
+                    if (sample(i + 1, j, k + 1) < isoval) which |= NEAR_BOTTOM_RIGHT;
+                    if (sample(i, j, k + 1) < isoval) which |= NEAR_BOTTOM_LEFT;
+                    if (sample(i, j + 1, k) < isoval) which |= FAR_TOP_LEFT;
+                    if (sample(i + 1, j + 1, k) < isoval) which |= FAR_TOP_RIGHT;
+                    if (sample(i + 1, j, k) < isoval) which |= FAR_BOTTOM_RIGHT;
+                    if (sample(i, j, k) < isoval) which |= FAR_BOTTOM_LEFT;
+                    cases[c++] = which;
+                }
+    });
+    report("classify", params, seconds, cells, 0, 0);
+
+    // Triangle emission from the classified cells
+    std::vector<float> vertices;
+    seconds = timeBest(repeat, [&]() {
+        vertices.clear();
+        vertices.shrink_to_fit();
+        size_t c = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                for (size_t k = 0; k < n; ++k) {
+                    int* verts = marching_cubes_lut[cases[c++]];
+                    for (int t = 0; verts[t] >= 0; t += 3) {
+                        for (int v = 0; v < 3; ++v) {
+                            vertices.emplace_back(axis[i] + stepsize * vertTable[verts[t + v]][0]);
+                            vertices.emplace_back(axis[j] + stepsize * vertTable[verts[t + v]][1]);
+                            vertices.emplace_back(axis[k] + stepsize * vertTable[verts[t + v]][2]);
+                        }
+                    }
+                }
+    });
+    double triangles = vertices.size() / 9.0;
+    report("emit", params, seconds, cells, triangles, 0);
+
+    // Normals of the emitted mesh
+    std::vector<float> normals;
+    seconds = timeBest(repeat, [&]() { normals = compute_normals(vertices); });
+    report("compute_normals", params, seconds, 0, triangles, 0);
+
+    // A separate pass for the area, volume and bounds, which the kernels now accumulate while emitting
+    MeshStats stats;
+    seconds = timeBest(repeat, [&]() {
+        stats = MeshStats();
+        stats.add(vertices.data(), vertices.size());
+    });
+    report("mesh_stats", params, seconds, 0, triangles, 0);
+
+    Mesh soup = {vertices, normals, stats};
+    IndexedMesh indexed;
+    seconds = timeBest(repeat, [&]() { indexed = weldMesh(soup); });
+    report("weld", params, seconds, 0, triangles, 0);
+    seconds = timeBest(repeat, [&]() { labelComponents(indexed); });
+    report("components", params, seconds, 0, triangles, 0);
+
+    // Refinement of a region of the mesh, which must splice in without splitting the surface
+    bool spliced = true;
+    {
+        const RegionOfInterest roi = {0.5f, 1.5f, 0.5f, 1.5f, 0.5f, 2.5f};
+        Mesh refined;
+        seconds = timeBest(repeat, [&]() {
+            refined = soup;
+            refineRegion(f, Grid::cube(min, max, stepsize), isoval, roi, 4, refined);
+        });
+        const size_t before = labelComponents(indexed).components.size();
+        const size_t after = labelComponents(weldMesh(refined)).components.size();
+        spliced = before == after;
+        if (!spliced) fprintf(stderr, "Refining the region changed the connected components from %zu to %zu\n", before, after);
+        char regionParams[128];
+        snprintf(regionParams, sizeof(regionParams), "%s components=%zu/%zu", params, after, before);
+        report("region_refine", regionParams, seconds, 0, refined.triangleCount() - triangles, 0);
+    }
+
+    // Triangle reordering for the vertex cache, with the simulated miss ratios before and after
+    {
+        VertexCacheStats before = simulateVertexCache(indexed.indices, indexed.vertexCount());
+        std::vector<uint32_t> reordered;
+        seconds = timeBest(repeat, [&]() {
+            reordered = indexed.indices;
+            optimizeVertexCache(reordered);
+        });
+        VertexCacheStats after = simulateVertexCache(reordered, indexed.vertexCount());
+        char cacheParams[128];
+        snprintf(cacheParams, sizeof(cacheParams), "acmr=%.2f->%.2f atvr=%.2f->%.2f", before.acmr, after.acmr, before.atvr, after.atvr);
+        report("vertex_cache", cacheParams, seconds, 0, triangles, 0);
+    }
+
+    // Frustum culling of the chunked mesh, for a view of the central quarter of the box
+    {
+        IndexedMesh chunked = indexed;
+        std::vector<MeshChunk> chunks = chunkMesh(chunked, Grid::cube(min, max, stepsize), 8);
+        const float s = 4.0f / (max - min);
+        const float view[16] = {s, 0, 0, 0, 0, s, 0, 0, 0, 0, s, 0, 0, 0, 0, 1};
+        CullStats stats;
+        seconds = timeBest(repeat, [&]() { cullChunks(chunks, frustumFromMatrix(view), &stats); });
+        char cullParams[128];
+        snprintf(cullParams, sizeof(cullParams), "chunks=%zu/%zu", stats.visibleChunks, stats.chunks);
+        report("frustum_cull", cullParams, seconds, 0, stats.triangles, 0);
+    }
+
+    // CPU rendering of the emitted mesh, from the viewer's starting camera scaled to the box
+    {
+        RenderOptions render;
+        render.r = std::sqrt(3.0f) * std::max(std::fabs(min), std::fabs(max));
+        RenderStats stats;
+        seconds = timeBest(repeat, [&]() { renderMesh(soup, render, &stats); });
+        char renderParams[128];
+        snprintf(renderParams, sizeof(renderParams), "%ux%u binned=%zu tiles=%zu", render.width, render.height, stats.binnedTriangles, stats.tiles);
+        report("software_render", renderParams, seconds, 0, triangles, 0);
+
+        // The same image ray cast from the field, whose cost does not depend on a step size
+        RayCastStats cast;
+        seconds = timeBest(repeat, [&]() { RayCaster(f, Grid::cube(min, max, stepsize), isoval).render(render, &cast); });
+        snprintf(renderParams, sizeof(renderParams), "%ux%u evals/ray=%.1f", render.width, render.height, (double) cast.evaluations / cast.rays);
+        report("raycast", renderParams, seconds, 0, 0, 0);
+
+        for (float step : {stepsize, 0.5f * stepsize, 0.25f * stepsize}) {
+            size_t meshTriangles = 0;
+            seconds = timeBest(repeat, [&]() {
+                Mesh mesh;
+                marching_cubes_two_pass(f, Grid::cube(min, max, step), isoval, mesh);
+                renderMesh(mesh, render);
+                meshTriangles = mesh.triangleCount();
+            });
+            snprintf(renderParams, sizeof(renderParams), "mesh step=%g", step);
+            report("raycast", renderParams, seconds, 0, meshTriangles, 0);
+        }
+    }
+
+    // PLY output of the emitted mesh
+    std::error_code ec;
+    const std::string plyPath = (std::filesystem::temp_directory_path(ec) / "bench_output.ply").string();
+    seconds = timeBest(repeat, [&]() { writePLYStream(vertices, normals, plyPath); });
+    double bytes = std::filesystem::file_size(plyPath, ec);
+    report("writePLY_stream", params, seconds, 0, triangles, bytes);
+    seconds = timeBest(repeat, [&]() { writePLY(vertices, normals, plyPath); });
+    bytes = std::filesystem::file_size(plyPath, ec);
+    report("writePLY", params, seconds, 0, triangles, bytes);
+    seconds = timeBest(repeat, [&]() { writePLY(vertices, normals, plyPath, 0); });
+    bytes = std::filesystem::file_size(plyPath, ec);
+    std::filesystem::remove(plyPath, ec);
+    report("writePLY_shortest", params, seconds, 0, triangles, bytes);
+
+    // End to end across step sizes and thread counts
+    std::vector<float> steps = quick ? std::vector<float>{0.2f, 0.1f} : std::vector<float>{0.2f, 0.1f, 0.05f};
+    std::vector<unsigned> threadCounts = {1, 2, 4};
+    unsigned hardware = std::thread::hardware_concurrency();
+    if (hardware > 4) threadCounts.push_back(hardware);
+
+    for (float step : steps) {
+        std::vector<float> stepAxis = gridAxis(min, max, step);
+        double stepCells = std::pow((double) stepAxis.size() - 1, 3);
+        for (unsigned threads : threadCounts) {
+            std::vector<float> meshVertices, meshNormals;
+            seconds = timeBest(repeat, [&]() {
+                meshVertices.clear();
+                meshNormals.clear();
+                marchingCubesThreaded(meshVertices, meshNormals, f, isoval, min, max, step, threads);
+            });
+            snprintf(params, sizeof(params), "f%d step=%g threads=%u", func, step, threads);
+            report("end_to_end", params, seconds, stepCells, meshVertices.size() / 9.0, 0);
+
+            Mesh mesh;
+            Grid grid = Grid::cube(min, max, step);
+            seconds = timeBest(repeat, [&]() { marching_cubes_two_pass(f, grid, isoval, mesh, threads); });
+            report("two_pass", params, seconds, stepCells, mesh.triangleCount(), 0);
+
+            // The dual engine over the same grid, with its triangles relative to marching cubes
+            Mesh nets;
+            seconds = timeBest(repeat, [&]() { surface_nets(f, grid, isoval, nets, threads); });
+            char netsParams[128];
+            snprintf(netsParams, sizeof(netsParams), "%s tris/mc=%.2f", params, nets.triangleCount() / std::max<double>(1, mesh.triangleCount()));
+            report("surface_nets", netsParams, seconds, stepCells, nets.triangleCount(), 0);
+        }
+    }
+
+    // Playback of the time-varying field, one step of t per run
+    {
+        IncrementalExtractor animation(findTimeVaryingField("f" + std::to_string(func)), Grid::cube(min, max, stepsize), 16);
+        Mesh frame;
+        float t = 0.0f;
+        animation.step(t, isoval, frame);
+        seconds = timeBest(repeat, [&]() { animation.step(t += 0.05f, isoval, frame); });
+        snprintf(params, sizeof(params), "f%d step=%g bricks=%zu", func, stepsize, animation.stats().bricks);
+        report("incremental_step", params, seconds, cells, frame.triangleCount(), 0);
+    }
+
+    // Brick-by-brick polygonization of a large sampled grid in both sample layouts, on one thread
+    {
+        const size_t layoutCells = quick ? 160 : 256;
+        const float layoutStep = (max - min) / layoutCells;
+        GridAxes axes = gridAxes(Grid::cube(min, max, layoutStep));
+        std::vector<CellBox> boxes;
+        for (size_t i = 0; i < axes.nx(); i += 16) {
+            for (size_t j = 0; j < axes.ny(); j += 16) {
+                for (size_t k = 0; k < axes.nz(); k += 16) {
+                    boxes.push_back({i, std::min(axes.nx(), i + 16), j, std::min(axes.ny(), j + 16), k, std::min(axes.nz(), k + 16)});
+                }
+            }
+        }
+        const double layoutCellCount = (double) axes.nx() * axes.ny() * axes.nz();
+
+        size_t denseBytes = 0;
+        for (SampleLayout layout : {SampleLayout::RowMajor, SampleLayout::Bricked}) {
+            SampleGrid samples(axes, layout);
+            samples.sample(f, axes);
+            Mesh mesh;
+            auto polygonize = [&]() {
+                mesh.clear();
+                for (const CellBox& box : boxes) marching_cubes_sampled(samples, axes, box, isoval, mesh);
+            };
+            seconds = timeBest(repeat, polygonize);
+
+            CacheCounter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            CacheCounter l1d(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            long long llcMisses = llc.count(polygonize);
+            long long l1dMisses = l1d.count(polygonize);
+
+            const char* name = layout == SampleLayout::Bricked ? "bricked" : "row-major";
+            if (llcMisses < 0 && l1dMisses < 0) snprintf(params, sizeof(params), "%s n=%zu misses=n/a", name, layoutCells);
+            else snprintf(params, sizeof(params), "%s n=%zu llc=%lld l1d=%lld", name, layoutCells, llcMisses, l1dMisses);
+            report("sample_layout", params, seconds, layoutCellCount, mesh.triangleCount(), samples.bytes());
+            denseBytes = samples.bytes();
+        }
+
+        // The same samples kept only in the band around the surface
+        SparseGrid sparse;
+        seconds = timeBest(repeat, [&]() { sparse.build(f, axes, isoval); });
+        snprintf(params, sizeof(params), "build n=%zu leaves=%zu dense=%.1fx", layoutCells, sparse.leafCount(), (double) denseBytes / sparse.bytes());
+        report("sparse_grid", params, seconds, layoutCellCount, 0, sparse.bytes());
+
+        Mesh mesh;
+        seconds = timeBest(repeat, [&]() { marching_cubes_sparse(sparse, axes, isoval, mesh); });
+        snprintf(params, sizeof(params), "polygonize n=%zu", layoutCells);
+        report("sparse_grid", params, seconds, layoutCellCount, mesh.triangleCount(), sparse.bytes());
+    }
+
+    // Union of a lattice of spheres and tori, sampled through the hierarchy and exhaustively, on one thread
+    for (size_t side : {4, 8, 16}) {
+        CSGScene scene;
+        std::vector<size_t> shapes;
+        const float spacing = (max - min) / side;
+        for (size_t i = 0; i < side * side * side; ++i) {
+            const float x = min + spacing * (i / (side * side) + 0.5f);
+            const float y = min + spacing * (i / side % side + 0.5f);
+            const float z = min + spacing * (i % side + 0.5f);
+            if (i % 2 == 0) shapes.push_back(scene.sphere(x, y, z, 0.35f * spacing));
+            else shapes.push_back(scene.torus(x, y, z, 0.3f * spacing, 0.1f * spacing));
+        }
+        scene.unite(shapes);
+
+        std::vector<float> points = gridAxis(min, max, (max - min) / 31);
+        std::vector<float> values(points.size() * points.size() * points.size());
+        seconds = timeBest(repeat, [&]() {
+            size_t v = 0;
+            for (float x : points) for (float y : points) for (float z : points) values[v++] = scene(x, y, z);
+        });
+        snprintf(params, sizeof(params), "n=%zu bvh", scene.primitiveCount());
+        report("csg_scene", params, seconds, values.size(), 0, 0);
+
+        seconds = timeBest(repeat, [&]() {
+            size_t v = 0;
+            for (float x : points) for (float y : points) for (float z : points) values[v++] = scene.evaluateAll(x, y, z);
+        });
+        snprintf(params, sizeof(params), "n=%zu exhaustive", scene.primitiveCount());
+        report("csg_scene", params, seconds, values.size(), 0, 0);
+
+        GridAxes axes = gridAxes(Grid::cube(min, max, stepsize));
+        SampleGrid grid(axes);
+        seconds = timeBest(repeat, [&]() { scene.sample(grid, axes, 1); });
+        snprintf(params, sizeof(params), "n=%zu batch step=%g", scene.primitiveCount(), stepsize);
+        report("csg_scene", params, seconds, (double) axes.xs.size() * axes.ys.size() * axes.zs.size(), 0, 0);
+    }
+
+    // Time from cancelling a running extraction job to the job having stopped
+    {
+        JobScheduler jobs;
+        Grid large = Grid::cube(min, max, stepsize / 4);
+        double latency = 1e30;
+        for (int run = 0; run < repeat; ++run) {
+            ExtractionOptions options;
+            IsoSurfaceExtractor extractor(f, "", large, options);
+            JobHandle job = jobs.submit([&](const CancellationToken&) { return extractor.extract(isoval).triangleCount() > 0; }, 0, options.cancel);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            auto start = std::chrono::steady_clock::now();
+            job.cancel();
+            job.wait();
+            latency = std::min(latency, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::vector<float> largeAxis = gridAxis(min, max, large.stepsize);
+        snprintf(params, sizeof(params), "f%d step=%g slab=%zux%zu", func, large.stepsize, largeAxis.size(), largeAxis.size());
+        report("cancel_latency", params, latency, 0, 0, 0);
+    }
+
+    // A mixed batch of one large and many small jobs, run back to back and scheduled together
+    {
+        std::vector<BatchJob> jobs(1);
+        jobs[0].fieldId = "f" + std::to_string(func);
+        jobs[0].grid = Grid::cube(min, max, stepsize / 2);
+        jobs[0].isovalues = {isoval};
+        for (int n = 0; n < 12; ++n) {
+            BatchJob job;
+            job.fieldId = "f" + std::to_string(n % 8 + 1);
+            job.grid = Grid::cube(min, max, stepsize * 2);
+            job.isovalues = {isoval, isoval + 0.5f};
+            jobs.push_back(job);
+        }
+
+        double batchCells = 0;
+        for (const BatchJob& job : jobs) {
+            std::vector<float> axis = gridAxis(min, max, job.grid.stepsize);
+            batchCells += std::pow((double) axis.size() - 1, 3) * job.isovalues.size();
+        }
+
+        size_t batchTriangles = 0;
+        seconds = timeBest(repeat, [&]() {
+            batchTriangles = 0;
+            for (const BatchJob& job : jobs) {
+                IsoSurfaceExtractor extractor(findField(job.fieldId), job.fieldId, job.grid);
+                for (float isovalue : job.isovalues) batchTriangles += extractor.extract(isovalue).triangleCount();
+            }
+        });
+        snprintf(params, sizeof(params), "back-to-back jobs=%zu", jobs.size());
+        report("batch", params, seconds, batchCells, batchTriangles, 0);
+
+        seconds = timeBest(repeat, [&]() {
+            batchTriangles = 0;
+            for (const BatchRecord& record : runBatch(jobs)) batchTriangles += record.triangles;
+        });
+        snprintf(params, sizeof(params), "scheduled jobs=%zu", jobs.size());
+        report("batch", params, seconds, batchCells, batchTriangles, 0);
+    }
+
+    // Requests served by the daemon to concurrent clients; identical requests share one extraction
+    {
+        DaemonOptions options;
+        options.socketPath = (std::filesystem::temp_directory_path(ec) / "bench_daemon.sock").string();
+        std::atomic<bool> stop(false);
+        std::thread daemon([&]() { runDaemon(options, stop); });
+        while (!std::filesystem::exists(options.socketPath)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        const unsigned clients = 8;
+        const unsigned requestsPerClient = 4;
+        std::atomic<size_t> served(0);
+        seconds = timeBest(repeat, [&]() {
+            served = 0;
+            std::vector<std::thread> threads;
+            for (unsigned c = 0; c < clients; ++c) {
+                threads.emplace_back([&, c]() {
+                    DaemonClient client;
+                    if (!client.connect(options.socketPath)) return;
+                    for (unsigned r = 0; r < requestsPerClient; ++r) {
+                        // Even clients all ask for the same mesh, odd ones for their own
+                        DaemonRequest request = {"f" + std::to_string(func), isoval + (c % 2 == 0 ? 0.0f : 0.01f * (c * requestsPerClient + r)), Grid::cube(min, max, stepsize)};
+                        Mesh mesh;
+                        if (client.extract(request, mesh)) served += mesh.triangleCount();
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+        });
+        stop = true;
+        daemon.join();
+        snprintf(params, sizeof(params), "f%d step=%g clients=%u", func, stepsize, clients);
+        report("daemon_throughput", params, seconds, cells * clients * requestsPerClient, served.load(), 0);
+    }
+
+    if (!jsonPath.empty()) writeJSON(jsonPath);
+    return spliced ? 0 : 1;
+}
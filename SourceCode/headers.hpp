@@ -12,17 +12,18 @@
  * @file headers.hpp
  * 
  * @brief A collection of all the necessary headers and libraries for the main program.
- * This file includes all the required libraries, headers, and global variables
+ * This file includes all the required libraries and headers
  * for the main program. It aggregates all dependencies in a single file for
  * easier management and maintainability.
  * 
  * Included libraries and headers:
  * 
- * Standard C++ libraries (stdio, stdlib, cmath, functional, fstream)
+ * Standard C++ libraries (stdio, stdlib, string, cmath, functional, fstream)
  * OpenGL libraries (GLEW, GLFW)
  * GLM (OpenGL Mathematics) for 3D math operations
- * C++ Standard Library features (iostream, vector, future, thread, chrono)
- * Project-specific headers (TriTable, Constants, shader, Worldboundaries,
+ * C++ Standard Library features (iostream, vector, future, atomic, thread, chrono, mutex)
+ * The isosurface library (IsoSurface.hpp)
+ * Project-specific headers (Constants, shader, Worldboundaries,
  * HelperFunctions, UserConstants)
  */
 
@@ -31,6 +32,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <cmath>
 #include <functional>
 #include <fstream>
@@ -40,7 +42,6 @@
 
 // Include GLFW
 #include <GLFW/glfw3.h>
-GLFWwindow* window;
 
 // Include GLM
 #include <glm/glm.hpp>
@@ -51,10 +52,16 @@ using namespace glm;
 #include <iostream>
 #include <vector>
 #include <future>
+#include <atomic>
 #include <thread>
 #include <chrono>
+#include <mutex>
+#include <sstream>
 
-#include "TriTable.hpp"
+#include <signal.h>
+#include <unistd.h>
+
+#include "IsoSurface.hpp"
 #include "Constants.hpp"
 #include "shader.hpp"
 #include "Worldboundaries.hpp"
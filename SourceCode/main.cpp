@@ -18,8 +18,11 @@
  * It initializes GLFW, GLEW, sets up shaders, and creates a window. The program
  * sets up VAOs and VBOs, camera, and lighting. The marching cubes algorithm runs
  * asynchronously, updating vertices and normals as it processes. Once the marching cubes
- * algorithm is complete, the program writes the resulting isosurface data to a PLY file.
- * The isosurface is rendered in the window with user interaction for camera control.
+ * algorithm is complete, the program writes the resulting isosurface data to a PLY file
+ * and stores the mesh in an on-disk cache, so an identical later run skips the extraction.
+ * The isosurface is rendered in the window with user interaction for camera control,
+ * from buffers with a 3.3 core profile shader program, and a frame is only drawn when
+ * the camera, the mesh or the window changes, so an idle viewer sleeps in glfwWaitEvents.
  * The program handles cleanup and termination upon completion.
  * 
  * @section ProcessInput
@@ -31,12 +34,15 @@
  * theta and phi values, which affect the camera's orientation.
  * 
  * @note Program Structure
- * The overall structure of the program includes a central headers.hpp file which
- * incorporates several other header files, such as:
+ * The extraction itself lives in libisosurface, a library without any OpenGL
+ * dependency (see IsoSurface.hpp); this program is a client of it that streams
+ * the extracted chunks into the VBOs. The overall structure of the program
+ * includes a central headers.hpp file which incorporates several other header
+ * files, such as:
+ * IsoSurface.hpp: The public headers of the extraction library
  * Constants.hpp: General constants used throughout the program
- * HelperFunctions.hpp: Utility functions, including marching cubes algorithm
+ * HelperFunctions.hpp: Utility functions used by the viewer and the software renderer
  * shader.hpp: Shader loading and management functions
- * TriTable.hpp: Lookup table for the marching cubes algorithm
  * UserConstants.hpp: User-defined constants for customization
  * Worldboundaries.hpp: Class definition for the world boundaries and axes
  * 
@@ -49,6 +55,40 @@
  * This will run the program with a 1920 x 1080 pixel window, step size of 0.1,
  * coordinate boundaries of (-5, -5, -5) to (5, 5, 5) with an iso value of 1.0
  * and the first of eight generating functions selected. 
+ * Adding --trace=trace.json records per-stage timings, writes them as a
+ * Chrome/Perfetto trace and prints a summary table at exit.
+ * Adding --roi=minx,maxx,miny,maxy,minz,maxz re-extracts that box with every
+ * cell split --refine=4 times per axis and splices it into the mesh.
+ * Adding --components prints the connected components of the surface, and
+ * --cull-triangles=N / --cull-area=A drop the components below those sizes.
+ * Adding --shards=4 extracts in 4 worker processes (this program started
+ * with --shard-worker, or the program given by --shard-command="...").
+ * Adding --animate plays the time-varying version of the selected function
+ * (f4 and f7 are animated), re-extracting only the bricks that changed.
+ * Adding --out-of-core=512 extracts brick by brick within a 512 MiB memory
+ * budget and writes the PLY file without opening a window.
+ * With OPTIMIZE_MESH the finished mesh is welded, reordered for the GPU vertex
+ * cache and drawn and written indexed, with smooth normals. With
+ * FRUSTUM_CULLING it is stored as chunks of RENDER_CHUNK_CELLS cells per side
+ * and only the chunks inside the view frustum are drawn.
+ * Adding --daemon=/tmp/assign5.sock serves extraction requests on that Unix
+ * domain socket until interrupted, without opening a window (see Daemon.hpp).
+ * Adding --thumbnail=thumb.png renders the isosurface on the CPU into a
+ * screen width x screen height PNG (or PPM) without opening a window, and
+ * --camera=r,theta,phi sets the starting camera of the viewer or thumbnail.
+ * Adding --raycast=preview.png ray casts the isosurface straight from the
+ * function into the same kind of image, without extracting a mesh, so it
+ * takes as long at any step size (see RayCaster.hpp).
+ * Adding --engine=surface-nets extracts with Surface Nets instead of marching
+ * cubes (see SurfaceNets.hpp), in the viewer and for --thumbnail.
+ * Adding --batch=jobs.txt runs every extraction of a manifest on the shared
+ * thread pool without opening a window (see Batch.hpp), and
+ * --batch-report=timings.csv writes the timing of every job.
+ * Adding --publish=/dev/shm/assign5.mesh extracts without a window into that
+ * shared memory file, slab by slab, and a second ./assign5 --view=/dev/shm/assign5.mesh
+ * draws the mesh from it while it grows (see SharedMesh.hpp).
+ * The extraction runs as a cancellable job (see JobScheduler.hpp): closing the
+ * window stops an unfinished extraction within one slab or brick.
  */
 
 
@@ -73,10 +113,19 @@ float lastFrame = 0.0f; // Time of last frame
 GLuint vaoID;
 GLuint vboVertexID;
 GLuint vboNormalID;
+GLuint vboIndexID;
+
+// The window, created in main
+GLFWwindow* window;
+
+// Set when the window needs repainting (resized, exposed) even though nothing else changed
+bool windowDamaged = true;
+
+// Set by SIGINT and SIGTERM to shut the --daemon service down
+std::atomic<bool> stopDaemon(false);
 
 // Forward declarations
-typedef float (*scalar_field_3d)(float, float, float);
-void processInput(GLFWwindow *window);
+bool processInput(GLFWwindow *window);
 
 
 
@@ -100,17 +149,144 @@ int main(int argc, char* argv[]) {
     float xmin = -5;
     float xmax = 5;
     float isoval = 1;
+    int func = 1;
     scalar_field_3d selectedF = f1;
 
+    // Separate --option=value flags from the positional arguments
+    std::vector<char*> args;
+    std::string tracePath;
+    unsigned long long outOfCoreBudget = 0;
+    std::string daemonSocket;
+    std::string thumbnailPath;
+    std::string raycastPath;
+    std::string batchManifest;
+    std::string batchReport;
+    std::string publishPath;
+    std::string viewPath;
+    ExtractionEngine engine = ExtractionEngine::MarchingCubes;
+    bool animate = false;
+    RegionOfInterest roi = {0, 0, 0, 0, 0, 0};
+    bool refineROI = false;
+    unsigned roiRefinement = 4;
+    unsigned shards = 0;
+    std::vector<std::string> shardCommand = {argv[0], "--shard-worker"};
+    bool reportComponents = false;
+    size_t cullTriangles = 0;
+    double cullArea = 0.0;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--trace=", 8) == 0) tracePath = argv[i] + 8;
+        else if (strncmp(argv[i], "--roi=", 6) == 0) {
+            refineROI = sscanf(argv[i] + 6, "%f,%f,%f,%f,%f,%f", &roi.minx, &roi.maxx, &roi.miny, &roi.maxy, &roi.minz, &roi.maxz) == 6;
+            if (!refineROI) fprintf(stderr, "Ignoring %s, expected --roi=minx,maxx,miny,maxy,minz,maxz\n", argv[i]);
+        }
+        else if (strncmp(argv[i], "--refine=", 9) == 0) roiRefinement = atoi(argv[i] + 9);
+        else if (strcmp(argv[i], "--shard-worker") == 0) {
+            // Serve one shard request on stdin/stdout; anything printed goes to stderr instead
+            int meshFd = dup(STDOUT_FILENO);
+            dup2(STDERR_FILENO, STDOUT_FILENO);
+            return runShardWorker(STDIN_FILENO, meshFd) ? 0 : 1;
+        }
+        else if (strncmp(argv[i], "--shards=", 9) == 0) shards = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--shard-command=", 16) == 0) {
+            shardCommand.clear();
+            std::istringstream words(argv[i] + 16);
+            for (std::string word; words >> word; ) shardCommand.push_back(word);
+        }
+        else if (strcmp(argv[i], "--components") == 0) reportComponents = true;
+        else if (strncmp(argv[i], "--cull-triangles=", 17) == 0) cullTriangles = strtoull(argv[i] + 17, NULL, 10);
+        else if (strncmp(argv[i], "--cull-area=", 12) == 0) cullArea = atof(argv[i] + 12);
+        else if (strcmp(argv[i], "--animate") == 0) animate = true;
+        else if (strncmp(argv[i], "--out-of-core=", 14) == 0) outOfCoreBudget = strtoull(argv[i] + 14, NULL, 10) << 20;
+        else if (strncmp(argv[i], "--daemon=", 9) == 0) daemonSocket = argv[i] + 9;
+        else if (strncmp(argv[i], "--engine=", 9) == 0) {
+            if (!parseExtractionEngine(argv[i] + 9, engine)) fprintf(stderr, "Ignoring %s, expected --engine=marching-cubes or --engine=surface-nets\n", argv[i]);
+        }
+        else if (strncmp(argv[i], "--thumbnail=", 12) == 0) thumbnailPath = argv[i] + 12;
+        else if (strncmp(argv[i], "--raycast=", 10) == 0) raycastPath = argv[i] + 10;
+        else if (strncmp(argv[i], "--batch=", 8) == 0) batchManifest = argv[i] + 8;
+        else if (strncmp(argv[i], "--batch-report=", 15) == 0) batchReport = argv[i] + 15;
+        else if (strncmp(argv[i], "--publish=", 10) == 0) publishPath = argv[i] + 10;
+        else if (strncmp(argv[i], "--view=", 7) == 0) viewPath = argv[i] + 7;
+        else if (strncmp(argv[i], "--camera=", 9) == 0) {
+            float camera[3];
+            if (sscanf(argv[i] + 9, "%f,%f,%f", &camera[0], &camera[1], &camera[2]) == 3) {
+                r = camera[0];
+                theta = camera[1];
+                phi = camera[2];
+                eye = sphericalToCartesian(r, theta, phi);
+                lightPos = sphericalToCartesian(r, theta, phi);
+            }
+            else fprintf(stderr, "Ignoring %s, expected --camera=r,theta,phi\n", argv[i]);
+        }
+        else args.push_back(argv[i]);
+    }
+    if (!tracePath.empty()) traceEnable(true);
+    if (engine != ExtractionEngine::MarchingCubes && (!daemonSocket.empty() || !batchManifest.empty() || outOfCoreBudget > 0 || shards > 0 || animate || refineROI)) {
+        fprintf(stderr, "--engine=%s only applies to the viewer, --thumbnail and --publish; the other modes use marching cubes\n", extractionEngineName(engine));
+    }
+
+    // The library reports meshes served from the cache; the daemon and batch runs stay quiet
+    auto printCacheHit = [](const std::string& path) { printf("Loaded cached mesh : %s\n", path.c_str()); };
+
+    // Serve extraction requests from other programs until interrupted, without a window
+    if (!daemonSocket.empty()) {
+        DaemonOptions options;
+        options.socketPath = daemonSocket;
+        options.maxConcurrentJobs = DAEMON_MAX_JOBS;
+        options.maxQueuedJobs = DAEMON_MAX_QUEUED;
+        options.extraction.useCache = USE_MESH_CACHE;
+        options.extraction.cacheDirectory = CACHE_DIRECTORY;
+        options.extraction.cacheMaxBytes = CACHE_MAX_BYTES;
+        signal(SIGINT, [](int) { stopDaemon = true; });
+        signal(SIGTERM, [](int) { stopDaemon = true; });
+        bool served = runDaemon(options, stopDaemon);
+        if (!tracePath.empty()) {
+            if (traceWriteChrome(tracePath)) printf("Wrote trace : %s\n", tracePath.c_str());
+            tracePrintSummary();
+        }
+        return served ? 0 : -1;
+    }
+
+    // Run every job of a manifest on the shared thread pool, without a window
+    if (!batchManifest.empty()) {
+        std::vector<BatchJob> jobs;
+        if (!readBatchManifest(batchManifest, jobs)) return -1;
+        BatchOptions options;
+        options.extraction.useCache = USE_MESH_CACHE;
+        options.extraction.cacheDirectory = CACHE_DIRECTORY;
+        options.extraction.cacheMaxBytes = CACHE_MAX_BYTES;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<BatchRecord> records = runBatch(jobs, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool ok = true;
+        for (const BatchRecord& record : records) {
+            printf("Job %zu (line %zu) iso %g : %s, %zu triangles, area %.4f, volume %.4f, %.3f s extract, %.3f s write\n",
+                   record.job, jobs[record.job].line, record.isovalue, record.ok ? "ok" : "failed",
+                   record.triangles, record.area, record.volume, record.extractSeconds, record.writeSeconds);
+            ok = ok && record.ok;
+        }
+        printf("Batch of %zu jobs, %zu extractions : %.3f s\n", jobs.size(), records.size(), seconds);
+        if (!batchReport.empty()) {
+            if (writeBatchReport(records, batchReport)) printf("Wrote batch report : %s\n", batchReport.c_str());
+            else ok = false;
+        }
+        if (!tracePath.empty()) {
+            if (traceWriteChrome(tracePath)) printf("Wrote trace : %s\n", tracePath.c_str());
+            tracePrintSummary();
+        }
+        return ok ? 0 : -1;
+    }
+
     // Check commandline arguments
-    if (argc > 1) screenW = atoi(argv[1]);
-    if (argc > 2) screenH = atoi(argv[2]);
-    if (argc > 3) stepsize = atof(argv[3]);
-    if (argc > 4) xmin = atof(argv[4]);
-    if (argc > 5) xmax = atof(argv[5]);
-    if (argc > 6) isoval = atof(argv[6]);
-    if (argc > 7) {
-        int func = atoi(argv[7]);
+    if (args.size() > 0) screenW = atoi(args[0]);
+    if (args.size() > 1) screenH = atoi(args[1]);
+    if (args.size() > 2) stepsize = atof(args[2]);
+    if (args.size() > 3) xmin = atof(args[3]);
+    if (args.size() > 4) xmax = atof(args[4]);
+    if (args.size() > 5) isoval = atof(args[5]);
+    if (args.size() > 6) {
+        func = atoi(args[6]);
         if (func == 2) selectedF = f2;
         else if (func == 3) selectedF = f3;
         else if (func == 4) selectedF = f4;
@@ -118,7 +294,7 @@ int main(int argc, char* argv[]) {
         else if (func == 6) selectedF = f6;
         else if (func == 7) selectedF = f7;
         else if (func == 8) selectedF = f8;
-        // if not [2, 8]then defaults to f1
+        else func = 1; // if not [2, 8]then defaults to f1
     }
 
     // Set y,z min/max to x min/max since it's just a box
@@ -127,6 +303,127 @@ int main(int argc, char* argv[]) {
 	float zmin = xmin;
 	float zmax = xmax;
 
+    // Grids too large to hold in memory are extracted brick by brick straight to the PLY file, without a window
+    if (outOfCoreBudget > 0) {
+        OutOfCoreOptions options;
+        options.memoryBudget = outOfCoreBudget;
+        options.scratchDirectory = OUTPUT_DIRECTORY + "Bricks";
+        Grid grid = {xmin, xmax, ymin, ymax, zmin, zmax, stepsize};
+        bool written = extractOutOfCore(selectedF, grid, isoval, OUTPUT_DIRECTORY + FILE_NAME, options);
+        if (!tracePath.empty()) {
+            if (traceWriteChrome(tracePath)) printf("Wrote trace : %s\n", tracePath.c_str());
+            tracePrintSummary();
+        }
+        return written ? 0 : -1;
+    }
+
+    // Publish the mesh slab by slab into shared memory for a --view process, without a window
+    if (!publishPath.empty()) {
+        Grid grid = {xmin, xmax, ymin, ymax, zmin, zmax, stepsize};
+        SharedMeshWriter shared;
+        if (!shared.create(publishPath, grid, sharedMeshCapacity(selectedF, grid, isoval, engine))) return -1;
+        printf("Publishing to %s\n", publishPath.c_str());
+
+        ExtractionOptions options;
+        options.useCache = USE_MESH_CACHE;
+        options.cacheDirectory = CACHE_DIRECTORY;
+        options.cacheMaxBytes = CACHE_MAX_BYTES;
+        options.engine = engine;
+        options.cacheHit = printCacheHit;
+        IsoSurfaceExtractor extractor(selectedF, "f" + std::to_string(func), grid, options);
+        bool fits = true;
+        bool published = extractor.extractChunks(isoval, [&](const float* chunkVertices, const float* chunkNormals, size_t count) {
+            fits = fits && shared.append(chunkVertices, chunkNormals, count);
+        }) && fits;
+
+        // Replace the triangle soup with the welded mesh, reordered for the vertex cache
+        if (published && OPTIMIZE_MESH) {
+            Mesh mesh;
+            mesh.vertices.assign(shared.vertices(), shared.vertices() + shared.floatCount());
+            mesh.normals.assign(shared.normals(), shared.normals() + shared.floatCount());
+            IndexedMesh optimized = weldMesh(mesh);
+            computeVertexNormals(optimized);
+            optimizeVertexCache(optimized.indices);
+            optimizeVertexFetch(optimized);
+            published = shared.replace(optimized);
+        }
+        shared.finish(published);
+        printf("Published %zu floats of vertices : %s\n", shared.floatCount(), publishPath.c_str());
+        if (!tracePath.empty()) {
+            if (traceWriteChrome(tracePath)) printf("Wrote trace : %s\n", tracePath.c_str());
+            tracePrintSummary();
+        }
+        return published ? 0 : -1;
+    }
+
+    // A mesh published by another process is drawn straight from its mapping instead of being extracted here
+    SharedMeshReader sharedMesh;
+    if (!viewPath.empty()) {
+        if (!sharedMesh.open(viewPath)) return -1;
+        Grid published = sharedMesh.grid();
+        xmin = published.minx;
+        xmax = published.maxx;
+        ymin = published.miny;
+        ymax = published.maxy;
+        zmin = published.minz;
+        zmax = published.maxz;
+        stepsize = published.stepsize;
+    }
+
+    // Ray-cast previews come straight from the function, without a mesh at any step size
+    if (!raycastPath.empty()) {
+        RayCastOptions cast;
+        cast.macroCells = RAYCAST_MACRO_CELLS;
+        Grid grid = {xmin, xmax, ymin, ymax, zmin, zmax, stepsize};
+        RayCaster caster(selectedF, grid, isoval, cast);
+
+        RenderOptions render;
+        render.width = screenW;
+        render.height = screenH;
+        render.r = r;
+        render.theta = theta;
+        render.phi = phi;
+        render.supersample = THUMBNAIL_SUPERSAMPLE;
+        RayCastStats stats;
+        Image image = caster.render(render, &stats);
+        printf("Ray cast %zu rays : %zu hits, %.1f evaluations per ray, %.3f s\n", stats.rays, stats.hits, (double) stats.evaluations / std::max<size_t>(1, stats.rays), stats.seconds);
+        bool written = writeImage(image, raycastPath);
+        if (!tracePath.empty()) {
+            if (traceWriteChrome(tracePath)) printf("Wrote trace : %s\n", tracePath.c_str());
+            tracePrintSummary();
+        }
+        return written ? 0 : -1;
+    }
+
+    // Thumbnails are rasterized on the CPU, so they need neither a window nor a GPU
+    if (!thumbnailPath.empty()) {
+        ExtractionOptions options;
+        options.useCache = USE_MESH_CACHE;
+        options.cacheDirectory = CACHE_DIRECTORY;
+        options.cacheMaxBytes = CACHE_MAX_BYTES;
+        options.engine = engine;
+        options.cacheHit = printCacheHit;
+        Grid grid = {xmin, xmax, ymin, ymax, zmin, zmax, stepsize};
+        Mesh mesh = IsoSurfaceExtractor(selectedF, "f" + std::to_string(func), grid, options).extract(isoval);
+
+        RenderOptions render;
+        render.width = screenW;
+        render.height = screenH;
+        render.r = r;
+        render.theta = theta;
+        render.phi = phi;
+        render.supersample = THUMBNAIL_SUPERSAMPLE;
+        RenderStats stats;
+        Image image = renderMesh(mesh, render, &stats);
+        printf("Rendered %zu triangles : %.3f s binning, %.3f s rasterizing\n", stats.triangles, stats.binSeconds, stats.rasterSeconds);
+        bool written = writeImage(image, thumbnailPath);
+        if (!tracePath.empty()) {
+            if (traceWriteChrome(tracePath)) printf("Wrote trace : %s\n", tracePath.c_str());
+            tracePrintSummary();
+        }
+        return written ? 0 : -1;
+    }
+
     // Initialise GLFW
 	if( !glfwInit() )
 	{
@@ -137,6 +434,11 @@ int main(int argc, char* argv[]) {
 
 	glfwWindowHint(GLFW_SAMPLES, 4);
 
+	// Everything is drawn from buffers with the shader program, so a 3.3 core profile is enough
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
 	// Open a window and create its OpenGL context
 	window = glfwCreateWindow( screenW, screenH, "Ryan Hecht Assignment 5", NULL, NULL);
 	if( window == NULL ){
@@ -159,9 +461,16 @@ int main(int argc, char* argv[]) {
     // Enable sticky keys
     glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE);
 
+    // Redraw when the window is resized or uncovered, and pace continuous redraws to the display
+    glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int width, int height) {
+        glViewport(0, 0, width, height);
+        windowDamaged = true;
+    });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow*) { windowDamaged = true; });
+    glfwSwapInterval(1);
+
     // Set dark blue background
 	glClearColor(0.2f, 0.2f, 0.3f, 0.0f);
-	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
     // Enable depth test and blending
 	glEnable(GL_DEPTH_TEST);
@@ -174,21 +483,12 @@ int main(int argc, char* argv[]) {
     
 
     // Setup matrix
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
     glm::mat4 Projection = glm::perspective(glm::radians(45.0f), screenW / screenH, 0.001f, 1000.0f);
-    glLoadMatrixf(glm::value_ptr(Projection));
-
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-
 
     glm::vec4 color(0.f, 0.8f, 0.8f, 1.0f); // colour of the rendered triangles
 
     glm::mat4 V = glm::lookAt(eye, origin, up);
     glm::mat4 M = glm::mat4(1.0f);
-    glm::mat4 MV = V * M;
-    glLoadMatrixf(glm::value_ptr(V));
     glm::mat4 MVP = Projection * V * M;
 
     // get Uniform Location of shader attributes
@@ -198,144 +498,439 @@ int main(int argc, char* argv[]) {
     GLuint LightPosID = glGetUniformLocation(ProgramID, "LightPosition_worldspace");
     GLuint colorID = glGetUniformLocation(ProgramID, "modelColor");
     GLuint shininessID = glGetUniformLocation(ProgramID, "shininess");
+    GLuint unlitID = glGetUniformLocation(ProgramID, "unlit");
 
     glUseProgram(ProgramID);
     glUniformMatrix4fv(MID, 1, GL_FALSE, &M[0][0]); //model matrix always identity.
     glUniformMatrix4fv(MVPID, 1, GL_FALSE, &MVP[0][0]);
     glUniform1f(shininessID, SHININESS);
+    glUniform1i(unlitID, GL_FALSE);
 
     // VAO, VBO setup
 	glGenVertexArrays(1, &vaoID);
 	glGenBuffers(1, &vboVertexID);
 	glGenBuffers(1, &vboNormalID);
+	glGenBuffers(1, &vboIndexID);
 
     // Axes and box
-	Worldboundaries wb(origin, glm::vec3(xmin, ymin, zmin), glm::vec3(xmax, ymax, zmax));\
+	Worldboundaries wb(origin, glm::vec3(xmin, ymin, zmin), glm::vec3(xmax, ymax, zmax));
 
-    // vertices from marching cubes algo and their normals
+    // vertices from marching cubes algo and their normals, appended by the extraction thread
+    std::mutex meshMutex;
     std::vector<float> marchingVerts;
     std::vector<float> normals;
+    MeshStats meshStats; // Area, volume and bounds, written to the PLY file
+    bool meshChanged = false;
+    GLsizei drawVertexCount = 0;
+
+    // Once the mesh is optimized, marchingVerts and normals hold its shared vertices and these index them
+    std::vector<uint32_t> marchingIndices;
+    GLsizei drawIndexCount = 0;
+
+    // Chunks of the finished mesh with their bounds; only those in the view frustum are drawn
+    std::vector<MeshChunk> meshChunks;
+    std::vector<MeshChunk> drawChunks;
+    CullStats shownCull;
+
+    // Progress of the extraction, reported per completed slab
+    std::atomic<size_t> completedSlabs(0);
+    std::atomic<size_t> totalSlabs(0);
+    size_t shownSlabs = 0;
+    float extractionStart = static_cast<float>(glfwGetTime());
+
+    // The extraction library serves identical runs from the on-disk mesh cache
+    ExtractionOptions options;
+    options.useCache = USE_MESH_CACHE;
+    options.cacheDirectory = CACHE_DIRECTORY;
+    options.cacheMaxBytes = CACHE_MAX_BYTES;
+    options.engine = engine;
+    options.cacheHit = printCacheHit;
+    options.progress = [&](size_t completed, size_t total) {
+        completedSlabs.store(completed);
+        totalSlabs.store(total);
+    };
+    Grid grid = {xmin, xmax, ymin, ymax, zmin, zmax, stepsize};
+    IsoSurfaceExtractor extractor(selectedF, "f" + std::to_string(func), grid, options);
+
+    IncrementalStats animationStats;
+    size_t animationSteps = 0; // Steps played so far, to update the window title once per step
+    size_t shownSteps = 0;
+
+    // The extraction is a job that closing the window cancels; it stops within one slab or brick
+    JobScheduler jobs;
+    JobHandle extraction = jobs.submit([&](const CancellationToken& cancel) {
+        if (sharedMesh.isOpen()) return true; // extracted by the publishing process
+        if (animate) {
+            // Play the time-varying version of the field, re-extracting only the bricks that changed
+            IncrementalExtractor animation(findTimeVaryingField("f" + std::to_string(func)), grid, ANIMATION_BRICK_CELLS);
+            Mesh frame;
+            auto start = std::chrono::steady_clock::now();
+            while (!cancel.cancelled()) {
+                float t = ANIMATION_SPEED * std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+                animation.step(t, isoval, frame);
+
+                // Hand the frame over, taking back the previous frame's storage for the next step
+                std::lock_guard<std::mutex> lock(meshMutex);
+                marchingVerts.swap(frame.vertices);
+                normals.swap(frame.normals);
+                animationStats = animation.stats();
+                animationSteps++;
+                meshChanged = true;
+            }
+            return true;
+        }
+        bool extracted = true;
+        if (shards > 0) {
+            // Split the slabs across worker processes and concatenate their sub-meshes
+            Mesh mesh;
+            extracted = extractSharded("f" + std::to_string(func), grid, isoval, shards, shardCommand, mesh);
+            std::lock_guard<std::mutex> lock(meshMutex);
+            marchingVerts.swap(mesh.vertices);
+            normals.swap(mesh.normals);
+            meshStats = mesh.stats;
+            meshChanged = true;
+        } else if (TWO_PASS_EXTRACTION) {
+            // Count then emit into an exactly sized mesh, handed over in one piece
+            Mesh mesh = extractor.extract(isoval);
+            std::lock_guard<std::mutex> lock(meshMutex);
+            marchingVerts.swap(mesh.vertices);
+            normals.swap(mesh.normals);
+            meshStats = mesh.stats;
+            meshChanged = true;
+        } else {
+            // Stream the bricks nearest the camera first
+            const float from[3] = {eye.x, eye.y, eye.z};
+            extracted = extractor.extractBricks(isoval, from, [&](const float* chunkVertices, const float* chunkNormals, size_t count) {
+                std::lock_guard<std::mutex> lock(meshMutex);
+                marchingVerts.insert(marchingVerts.end(), chunkVertices, chunkVertices + count);
+                normals.insert(normals.end(), chunkNormals, chunkNormals + count);
+                meshChanged = true;
+            }, &meshStats);
+        }
 
-    // Calculate the expected number of vertices according to the stepsize and reserve memory for that
-    GLuint expectedVertCount = ceil((xmax - xmin) / stepsize) * ceil((ymax - ymin) / stepsize) * ceil((zmax - zmin) / stepsize) * 12;
-    marchingVerts.reserve(expectedVertCount);
-    normals.reserve(expectedVertCount);
+        // Nothing after a cancelled extraction is worth finishing
+        extracted = extracted && !cancel.cancelled();
 
+        // Splice a finer extraction of the region of interest into the mesh
+        if (extracted && refineROI) {
+            Mesh mesh;
+            {
+                std::lock_guard<std::mutex> lock(meshMutex);
+                mesh.vertices = marchingVerts;
+                mesh.normals = normals;
+            }
+            if (extractor.refine(mesh, isoval, roi, roiRefinement)) {
+                std::lock_guard<std::mutex> lock(meshMutex);
+                marchingVerts.swap(mesh.vertices);
+                normals.swap(mesh.normals);
+                meshStats = mesh.stats;
+                meshChanged = true;
+            }
+        }
+        // Label the connected components and drop the small ones
+        if (extracted && (reportComponents || cullTriangles > 0 || cullArea > 0.0)) {
+            Mesh mesh;
+            {
+                std::lock_guard<std::mutex> lock(meshMutex);
+                mesh.vertices = marchingVerts;
+                mesh.normals = normals;
+            }
+            ComponentLabels labels = labelComponents(weldMesh(mesh));
+            if (reportComponents) printComponentSummary(labels);
+            if (cullTriangles > 0 || cullArea > 0.0) {
+                Mesh culled = cullComponents(mesh, labels, cullTriangles, cullArea);
+                printf("Culled %zu of %zu triangles\n", mesh.triangleCount() - culled.triangleCount(), mesh.triangleCount());
+                std::lock_guard<std::mutex> lock(meshMutex);
+                marchingVerts.swap(culled.vertices);
+                normals.swap(culled.normals);
+                meshStats = culled.stats;
+                meshChanged = true;
+            }
+        }
+        // Sort the mesh into chunks for frustum culling, and weld it and reorder every chunk for the vertex cache
+        if (extracted && (OPTIMIZE_MESH || FRUSTUM_CULLING)) {
+            Mesh mesh;
+            {
+                std::lock_guard<std::mutex> lock(meshMutex);
+                mesh.vertices = marchingVerts;
+                mesh.normals = normals;
+            }
+            std::vector<MeshChunk> chunks;
+            if (OPTIMIZE_MESH) {
+                IndexedMesh optimized = weldMesh(mesh);
+                computeVertexNormals(optimized);
+                VertexCacheStats before = simulateVertexCache(optimized.indices, optimized.vertexCount());
+                if (FRUSTUM_CULLING) {
+                    chunks = chunkMesh(optimized, grid, RENDER_CHUNK_CELLS);
+                } else {
+                    optimizeVertexCache(optimized.indices);
+                    optimizeVertexFetch(optimized);
+                }
+                VertexCacheStats after = simulateVertexCache(optimized.indices, optimized.vertexCount());
+                printf("Vertex cache (%u entries): ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", VERTEX_CACHE_SIZE,
+                       before.acmr, after.acmr, before.atvr, after.atvr);
+                std::lock_guard<std::mutex> lock(meshMutex);
+                marchingVerts.swap(optimized.positions);
+                normals.swap(optimized.normals);
+                marchingIndices.swap(optimized.indices);
+                meshChunks.swap(chunks);
+                meshChanged = true;
+            } else {
+                chunks = chunkMesh(mesh, grid, RENDER_CHUNK_CELLS);
+                std::lock_guard<std::mutex> lock(meshMutex);
+                marchingVerts.swap(mesh.vertices);
+                normals.swap(mesh.normals);
+                meshChunks.swap(chunks);
+                meshChanged = true;
+            }
+        }
+        return extracted;
+    }, 1, options.cancel);
+    JobHandle writePLYJob;
 
-    std::future<bool> marching_cubes_future = std::async(std::launch::async, marching_cubes_async, std::ref(marchingVerts), std::ref(normals), selectedF, isoval, xmin, xmax, ymin, ymax, zmin, zmax, stepsize);
-    std::future<void> writePLY_future;
+    // How much of a published mesh (--view) is on the GPU
+    uint64_t sharedGeneration = UINT64_MAX;
+    size_t sharedFloats = 0;
+    size_t sharedBufferFloats = 0;
+    std::string sharedTitle;
 
-    // Rendering loop
+    // Rendering loop: a frame is only drawn when the mesh, the camera or the window changed
     bool writtenPLY = false;
+    bool redraw = true;
     do {
+        bool finished = extraction.finished();
 
-        // if the async function is finished:
-        if (marching_cubes_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-
-            // Set VAO and VBOs one last time and write the PLY file if it's not already written
-            if (!writtenPLY) {
+        // Upload the vertices and normals whenever the extraction has added to them
+        {
+            std::lock_guard<std::mutex> lock(meshMutex);
+            if (meshChanged) {
+                TRACE_SCOPE("gpu_upload");
+                TRACE_COUNT("bytes_uploaded", 2 * marchingVerts.size() * sizeof(float) + marchingIndices.size() * sizeof(uint32_t));
 
                 // Bind VAO
                 glBindVertexArray(vaoID);
         
                 glBindBuffer(GL_ARRAY_BUFFER, vboVertexID);
-                glBufferData(GL_ARRAY_BUFFER, marchingVerts.size()*sizeof(marchingVerts[0]), &marchingVerts[0], GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, marchingVerts.size()*sizeof(marchingVerts[0]), marchingVerts.data(), GL_STATIC_DRAW);
                 // 1st attribute buffer : vertices
                 glEnableVertexAttribArray(0);
                 glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
                 
                 glBindBuffer(GL_ARRAY_BUFFER, vboNormalID);
-                glBufferData(GL_ARRAY_BUFFER, normals.size()*sizeof(normals[0]), &normals[0], GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, normals.size()*sizeof(normals[0]), normals.data(), GL_STATIC_DRAW);
                 // 2nd attribute buffer : normals
                 glEnableVertexAttribArray(1);
                 glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
 
+                // Index buffer of the optimized mesh, recorded in the VAO
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIndexID);
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, marchingIndices.size()*sizeof(marchingIndices[0]), marchingIndices.data(), GL_STATIC_DRAW);
+
                 glBindVertexArray(0); // unbind vao
 
-                // Call writePLY asynchronously
-                writePLY_future = std::async(std::launch::async, [&]() {
-                    writePLY(marchingVerts, normals, FILE_NAME);
-                });
-                writtenPLY = true;
+                drawVertexCount = marchingVerts.size() / 3;
+                drawIndexCount = marchingIndices.size();
+                drawChunks = meshChunks;
+                meshChanged = false;
+                redraw = true;
             }
+        }
 
-        } else {
-            // The async function is still running, do other things here
-            glBindVertexArray(vaoID);
-    
-            glBindBuffer(GL_ARRAY_BUFFER, vboVertexID);
-            glBufferData(GL_ARRAY_BUFFER, marchingVerts.size()*sizeof(marchingVerts[0]), &marchingVerts[0], GL_STATIC_DRAW);
-            // 1st attribute buffer : vertices
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
-
-            glBindBuffer(GL_ARRAY_BUFFER, vboNormalID);
-            glBufferData(GL_ARRAY_BUFFER, normals.size()*sizeof(normals[0]), &normals[0], GL_STATIC_DRAW);
-            // 2nd attribute buffer : normals
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
+        // Upload what the publishing process appended or replaced, straight from the mapping
+        if (sharedMesh.isOpen()) {
+            SharedMeshSnapshot snapshot = sharedMesh.snapshot();
+            bool replaced = snapshot.generation != sharedGeneration;
+            if (snapshot.stable() && (replaced || snapshot.floatCount != sharedFloats)) {
+                TRACE_SCOPE("gpu_upload");
+                size_t first = replaced ? 0 : sharedFloats;
+                glBindVertexArray(vaoID);
 
-    
-            glBindVertexArray(0); // unbind vao
+                // The buffers grow by doubling while slabs arrive; a new buffer is filled from the start of the mapping
+                if (replaced || snapshot.floatCount > sharedBufferFloats) {
+                    sharedBufferFloats = replaced ? snapshot.floatCount : std::max(snapshot.floatCount, 2 * sharedBufferFloats);
+                    first = 0;
+                    glBindBuffer(GL_ARRAY_BUFFER, vboVertexID);
+                    glBufferData(GL_ARRAY_BUFFER, sharedBufferFloats * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
+                    glBindBuffer(GL_ARRAY_BUFFER, vboNormalID);
+                    glBufferData(GL_ARRAY_BUFFER, sharedBufferFloats * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+                    glEnableVertexAttribArray(1);
+                    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0);
+                }
+                size_t bytes = (snapshot.floatCount - first) * sizeof(float);
+                glBindBuffer(GL_ARRAY_BUFFER, vboVertexID);
+                glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(float), bytes, sharedMesh.vertices() + first);
+                glBindBuffer(GL_ARRAY_BUFFER, vboNormalID);
+                glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(float), bytes, sharedMesh.normals() + first);
+                if (replaced) {
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIndexID);
+                    glBufferData(GL_ELEMENT_ARRAY_BUFFER, snapshot.indexCount * sizeof(uint32_t), sharedMesh.indices(), GL_STATIC_DRAW);
+                }
+                glBindVertexArray(0);
+                TRACE_COUNT("bytes_uploaded", 2 * bytes + (replaced ? snapshot.indexCount * sizeof(uint32_t) : 0));
+
+                // An upload that overlapped a replacement is redone in full on the next frame
+                if (sharedMesh.validate(snapshot)) {
+                    sharedGeneration = snapshot.generation;
+                    sharedFloats = snapshot.floatCount;
+                } else {
+                    sharedGeneration = UINT64_MAX;
+                }
+                drawVertexCount = snapshot.floatCount / 3;
+                drawIndexCount = snapshot.indexCount;
+                redraw = true;
+            }
+            finished = snapshot.state != SHARED_MESH_EXTRACTING;
         }
 
-        // Clear the screen
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (animate) {
+            // Show what the last step re-extracted in the window title, once per step
+            std::lock_guard<std::mutex> lock(meshMutex);
+            if (animationSteps != shownSteps) {
+                shownSteps = animationSteps;
+                char title[160];
+                snprintf(title, sizeof(title), "Ryan Hecht Assignment 5 - %zu/%zu bricks re-extracted, %.1f ms sampling, %.1f ms extracting",
+                         animationStats.extractedBricks, animationStats.bricks,
+                         animationStats.sampleSeconds * 1e3, animationStats.extractSeconds * 1e3);
+                glfwSetWindowTitle(window, title);
+            }
+
+        } else if (sharedMesh.isOpen()) {
+            // Show how much of the published mesh has arrived in the window title
+            char title[256];
+            size_t triangles = drawIndexCount > 0 ? drawIndexCount / 3 : drawVertexCount / 3;
+            snprintf(title, sizeof(title), "Ryan Hecht Assignment 5 - %s, %zu triangles%s", viewPath.c_str(), triangles,
+                     finished ? "" : ", extracting");
+            if (sharedTitle != title) {
+                sharedTitle = title;
+                glfwSetWindowTitle(window, title);
+            }
 
-        // Use the program
-        glUseProgram(ProgramID);
+        // if the async function is finished:
+        } else if (finished) {
 
-		// Recalculate matrix
-		glMatrixMode(GL_PROJECTION);
-		glPushMatrix();
-		Projection = glm::perspective(glm::radians(45.0f), screenW/screenH, 0.001f, 1000.0f);
-		glLoadMatrixf(glm::value_ptr(Projection));
+            // Write the PLY file if it's not already written
+            if (!writtenPLY) {
+                // Write the PLY file as a job of its own, below the extraction in priority
+                writePLYJob = jobs.submit([&](const CancellationToken&) {
+                    if (marchingIndices.empty()) return writePLY(marchingVerts, normals, OUTPUT_DIRECTORY + FILE_NAME, PLY_PRECISION, &meshStats);
+                    IndexedMesh mesh;
+                    mesh.positions = marchingVerts;
+                    mesh.normals = normals;
+                    mesh.indices = marchingIndices;
+                    return writePLY(mesh, OUTPUT_DIRECTORY + FILE_NAME, PLY_PRECISION, &meshStats);
+                });
+                writtenPLY = true;
+                glfwSetWindowTitle(window, "Ryan Hecht Assignment 5");
+            }
 
-		glMatrixMode( GL_MODELVIEW );
-		glPushMatrix();
+        } else {
+            // The async function is still running, show the progress and estimated time left in the window title
+            size_t completed = completedSlabs.load();
+            if (completed != shownSlabs) {
+                shownSlabs = completed;
+                float remaining = estimateRemainingSeconds(static_cast<float>(glfwGetTime()) - extractionStart, completed, totalSlabs.load());
+                char title[128];
+                snprintf(title, sizeof(title), "Ryan Hecht Assignment 5 - extracting %zu/%zu %s, %.1fs left",
+                         completed, totalSlabs.load(), TWO_PASS_EXTRACTION ? "slabs" : "bricks", remaining);
+                glfwSetWindowTitle(window, title);
+            }
+        }
 
-        // Calculate per-frame time logic
+        // Calculate per-frame time logic; motion after an idle wait starts from one short frame
 		float currentFrame = static_cast<float>(glfwGetTime());
-		deltaTime = currentFrame - lastFrame;
+		deltaTime = std::min(currentFrame - lastFrame, MAX_FRAME_SECONDS);
 		lastFrame = currentFrame;
 
 		// Handle input:
-		processInput(window);
-
-        // Recalculate projection matrix
-        V = glm::lookAt(eye, origin, up);
-        M = glm::mat4(1.0f);
-        MV = M * V;
-        glLoadMatrixf(glm::value_ptr(V));
-        MVP = Projection * V;
-        
-        // Update uniform variables
-        glUniformMatrix4fv(MVPID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(VID, 1, GL_FALSE, &V[0][0]);
-		glUniform3f(LightPosID, lightPos.x, lightPos.y, lightPos.z);
-		glUniform4fv(colorID, 1, &color[0]);
-	
-		// Draw from server side array
-		glBindVertexArray(vaoID);
-		glDrawArrays(GL_TRIANGLES, 0, marchingVerts.size()); 	
-		glBindVertexArray(0);
-
-        // Unuse the program
-        glUseProgram(0);
-        wb.draw();
-
-        // GLFW event processing and buffer swapping
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+		bool cameraMoved = processInput(window);
+		redraw = redraw || cameraMoved || windowDamaged;
+
+        if (redraw) {
+            // Clear the screen
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Use the program
+            glUseProgram(ProgramID);
+
+            // Recalculate the projection and view matrices, following the window's aspect ratio
+            int framebufferW, framebufferH;
+            glfwGetFramebufferSize(window, &framebufferW, &framebufferH);
+            if (framebufferW > 0 && framebufferH > 0) {
+                Projection = glm::perspective(glm::radians(45.0f), (float) framebufferW / framebufferH, 0.001f, 1000.0f);
+            }
+            V = glm::lookAt(eye, origin, up);
+            MVP = Projection * V * M;
+
+            // Update uniform variables
+            glUniformMatrix4fv(MVPID, 1, GL_FALSE, &MVP[0][0]);
+            glUniformMatrix4fv(VID, 1, GL_FALSE, &V[0][0]);
+            glUniform3f(LightPosID, lightPos.x, lightPos.y, lightPos.z);
+            glUniform4fv(colorID, 1, &color[0]);
+
+            // Draw from server side array
+            glBindVertexArray(vaoID);
+            if (drawChunks.empty()) {
+                if (drawIndexCount > 0) glDrawElements(GL_TRIANGLES, drawIndexCount, GL_UNSIGNED_INT, (void*) 0);
+                else glDrawArrays(GL_TRIANGLES, 0, drawVertexCount);
+            } else {
+                // Draw only the chunks whose bounds reach into the view frustum
+                CullStats cull;
+                std::vector<DrawRange> ranges = cullChunks(drawChunks, frustumFromMatrix(&MVP[0][0]), &cull);
+                for (const DrawRange& range : ranges) {
+                    if (drawIndexCount > 0) glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_INT, (void*) (range.first * sizeof(uint32_t)));
+                    else glDrawArrays(GL_TRIANGLES, range.first, range.count);
+                }
+                if (writtenPLY && (cull.visibleChunks != shownCull.visibleChunks || cull.chunks != shownCull.chunks)) {
+                    shownCull = cull;
+                    char title[160];
+                    snprintf(title, sizeof(title), "Ryan Hecht Assignment 5 - drawing %zu/%zu chunks, %zu/%zu triangles",
+                             cull.visibleChunks, cull.chunks, cull.visibleTriangles, cull.triangles);
+                    glfwSetWindowTitle(window, title);
+                }
+            }
+            glBindVertexArray(0);
+
+            // The axes and box, in flat colours with the same program
+            wb.draw(colorID, unlitID);
+
+            // Unuse the program
+            glUseProgram(0);
+
+            glfwSwapBuffers(window);
+            redraw = false;
+            windowDamaged = false;
+        }
+
+        // GLFW event processing: keep drawing while the camera moves, check back regularly while
+        // the mesh is still changing, and otherwise sleep until the next event
+        if (cameraMoved) glfwPollEvents();
+        else if (animate || !finished) glfwWaitEventsTimeout(REFRESH_SECONDS);
+        else glfwWaitEvents();
 
     } while (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS &&
              glfwWindowShouldClose(window) == 0);
 
+    // Stop the playback or an unfinished extraction within a slab or brick; a started PLY file is completed
+    extraction.cancel();
+    extraction.wait();
+    if (writePLYJob.valid()) writePLYJob.wait();
+
     // Cleanup and terminate
+    wb.release();
     glDeleteBuffers(1, &vboVertexID);
     glDeleteBuffers(1, &vboNormalID);
+    glDeleteBuffers(1, &vboIndexID);
+    glDeleteVertexArrays(1, &vaoID);
     glfwTerminate();
 
+    // Dump the trace once every stage has finished
+    if (!tracePath.empty()) {
+        if (traceWriteChrome(tracePath)) printf("Wrote trace : %s\n", tracePath.c_str());
+        tracePrintSummary();
+    }
+
     return 0;
 }
 
@@ -347,8 +942,11 @@ int main(int argc, char* argv[]) {
  * and managing cursor controls for modifying theta and phi values affecting the
  * camera's orientation.
  * @param window Pointer to the GLFWwindow object
+ * @return bool True if the camera moved
 */
-void processInput(GLFWwindow *window) {
+bool processInput(GLFWwindow *window) {
+    float lastR = r, lastTheta = theta, lastPhi = phi;
+
     // Camera controls
     if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
         r -= ZOOM_SPEED * deltaTime;
@@ -383,4 +981,5 @@ void processInput(GLFWwindow *window) {
     // Update camera and light position based on the new spherical coordinates
     eye = sphericalToCartesian(r, theta, phi);
     lightPos = sphericalToCartesian(r, theta, phi);
+    return r != lastR || theta != lastTheta || phi != lastPhi;
 }
\ No newline at end of file